@@ -0,0 +1,20 @@
+//Layout of vulkan::BindlessHeap, the heap is expected at set 0
+#ifndef BINDLESS_GLSL
+#define BINDLESS_GLSL
+
+#extension GL_EXT_nonuniform_qualifier : require
+
+#define BINDLESS_SET 0
+
+layout (set = BINDLESS_SET, binding = 0) uniform sampler2D bindless_textures[];
+
+//storage images have to name their format, one alias per format the engine writes
+layout (set = BINDLESS_SET, binding = 1, rgba16f) uniform image2D bindless_images_rgba16f[];
+layout (set = BINDLESS_SET, binding = 1, rgba8) uniform image2D bindless_images_rgba8[];
+
+//Declares the storage buffers as arrays of T, e.g. BINDLESS_BUFFER(readonly, Material, materials);
+//then materials[nonuniformEXT(index)].items[i]
+#define BINDLESS_BUFFER(qualifier, T, name) \
+    layout (std430, set = BINDLESS_SET, binding = 2) qualifier buffer name##_block { T items[]; } name[]
+
+#endif
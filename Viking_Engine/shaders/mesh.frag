@@ -0,0 +1,17 @@
+#version 460
+
+layout (location = 0) in vec3 in_normal;
+layout (location = 1) in vec4 in_color;
+layout (location = 2) in vec2 in_uv;
+
+layout (location = 0) out vec4 out_color;
+
+//fixed directional light until the scene has lights of its own
+const vec3 LIGHT_DIRECTION = normalize(vec3(0.3f, 1.0f, 0.5f));
+const float AMBIENT = 0.15f;
+
+void main()
+{
+    const float diffuse = max(dot(normalize(in_normal), LIGHT_DIRECTION), 0.0f);
+    out_color = vec4(in_color.rgb * (AMBIENT + diffuse * (1.0f - AMBIENT)), in_color.a);
+}
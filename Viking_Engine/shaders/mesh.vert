@@ -0,0 +1,66 @@
+#version 460
+
+#extension GL_EXT_buffer_reference : require
+
+struct Vertex
+{
+    vec3 position;
+    float uv_x;
+    vec3 normal;
+    float uv_y;
+    vec4 color;
+};
+
+struct Lod
+{
+    uint first_index;
+    uint index_count;
+    float error;
+    uint padding;
+};
+
+struct Object
+{
+    mat4 transform;
+    //inverse transpose of the upper 3x3 of transform
+    mat3 normal_matrix;
+    vec4 bounds;
+    int vertex_offset;
+    uint lod_count;
+    uint padding[2];
+    Lod lods[4];
+};
+
+layout (buffer_reference, std430) readonly buffer VertexBuffer
+{
+    Vertex vertices[];
+};
+
+layout (buffer_reference, std430) readonly buffer ObjectBuffer
+{
+    Object objects[];
+};
+
+layout (push_constant) uniform Constants
+{
+    mat4 view_projection;
+    //vertex 0 of the mesh pool, gl_VertexIndex already includes the mesh's vertex offset
+    VertexBuffer vertex_buffer;
+    //objects of the frame, the culling pass passes the object index as firstInstance
+    ObjectBuffer object_buffer;
+} constants;
+
+layout (location = 0) out vec3 out_normal;
+layout (location = 1) out vec4 out_color;
+layout (location = 2) out vec2 out_uv;
+
+void main()
+{
+    const Vertex vertex = constants.vertex_buffer.vertices[gl_VertexIndex];
+    const mat4 transform = constants.object_buffer.objects[gl_InstanceIndex].transform;
+
+    gl_Position = constants.view_projection * transform * vec4(vertex.position, 1.0f);
+    out_normal = constants.object_buffer.objects[gl_InstanceIndex].normal_matrix * vertex.normal;
+    out_color = vertex.color;
+    out_uv = vec2(vertex.uv_x, vertex.uv_y);
+}
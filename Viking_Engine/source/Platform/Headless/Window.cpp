@@ -0,0 +1,43 @@
+#include "Platform/Headless/Window.hpp"
+
+#include "Viking/core/Log.hpp"
+#include "Viking/event/ApplicationEvent.hpp"
+#include "Viking/event/DispatcherEvent.hpp"
+
+namespace headless
+{
+    Window::Window(vi::WindowProps p_props) : m_window_props{ std::move(p_props) }, m_start_time{ std::chrono::steady_clock::now() }
+    {
+        const auto& [width, height] = m_window_props.Size;
+        VI_CORE_INFO("Running headless at {}x{}", width, height);
+    }
+
+    void Window::on_update()
+    {
+        ++m_frame_count;
+        if (m_window_props.FrameLimit != 0 && m_frame_count == m_window_props.FrameLimit)
+        {
+            VI_CORE_TRACE("Headless frame limit of {} reached", m_window_props.FrameLimit);
+            vi::EventDispatcher::send_event(std::make_shared<vi::WindowCloseEvent>());
+        }
+    }
+
+    void Window::on_swap()
+    {
+    }
+
+    [[nodiscard]] std::pair<int32_t, int32_t> Window::get_size() const
+    {
+        return m_window_props.Size;
+    }
+
+    vi::PresentMode Window::get_present_mode() const
+    {
+        return m_window_props.Present;
+    }
+
+    float Window::get_time() const
+    {
+        return std::chrono::duration<float>(std::chrono::steady_clock::now() - m_start_time).count();
+    }
+}
@@ -0,0 +1,30 @@
+#ifndef HEADLESS_WINDOW_HPP
+#define HEADLESS_WINDOW_HPP
+
+#include "Viking/core/Window.hpp"
+
+#include <chrono>
+#include <cstdint>
+
+namespace headless {
+//Window without a surface, the renderer draws offscreen and nothing is presented.
+//With a frame limit it asks the application to close once that many frames went through the loop
+class Window: public vi::Window {
+public:
+    Window(vi::WindowProps p_props);
+    ~Window() override = default;
+
+    void on_update() override;
+    void on_swap() override;
+    [[nodiscard]] std::pair<int32_t, int32_t> get_size() const override;
+    [[nodiscard]] vi::PresentMode get_present_mode() const override;
+    [[nodiscard]] float get_time() const override;
+
+private:
+    vi::WindowProps m_window_props{};
+    std::chrono::steady_clock::time_point m_start_time{};
+    uint32_t m_frame_count{};
+};
+}
+
+#endif //HEADLESS_WINDOW_HPP
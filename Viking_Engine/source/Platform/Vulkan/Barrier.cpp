@@ -0,0 +1,309 @@
+#include "Platform/Vulkan/Barrier.hpp"
+
+#include "Platform/Vulkan/Buffer.hpp"
+#include "Platform/Vulkan/Image.hpp"
+
+#include <algorithm>
+
+namespace
+{
+    //only writes have to be made available, a read never needs to be waited on for visibility
+    constexpr VkAccessFlags2 WRITE_ACCESS_MASK{
+        VK_ACCESS_2_SHADER_WRITE_BIT |
+        VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT |
+        VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT |
+        VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT |
+        VK_ACCESS_2_TRANSFER_WRITE_BIT |
+        VK_ACCESS_2_HOST_WRITE_BIT |
+        VK_ACCESS_2_MEMORY_WRITE_BIT
+    };
+
+    bool has_write(const VkAccessFlags2 p_access)
+    {
+        return (p_access & WRITE_ACCESS_MASK) != 0;
+    }
+
+    VkImageSubresourceRange full_subresource_range(const VkImageAspectFlags p_aspect_mask)
+    {
+        VkImageSubresourceRange sub_image;
+        sub_image.aspectMask = p_aspect_mask;
+        sub_image.baseMipLevel = 0;
+        sub_image.levelCount = VK_REMAINING_MIP_LEVELS;
+        sub_image.baseArrayLayer = 0;
+        sub_image.layerCount = VK_REMAINING_ARRAY_LAYERS;
+
+        return sub_image;
+    }
+}
+
+namespace vulkan
+{
+    ImageState image_state(const ImageUsage p_usage)
+    {
+        switch (p_usage)
+        {
+        case ImageUsage::TransferSrc:
+            return { VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_READ_BIT };
+        case ImageUsage::TransferDst:
+            return { VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT };
+        case ImageUsage::ComputeRead:
+            return { VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT };
+        case ImageUsage::ComputeWrite:
+            return { VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT };
+        case ImageUsage::ComputeReadWrite:
+            return { VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT };
+        case ImageUsage::ShaderRead:
+            return { VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT };
+        case ImageUsage::ColorAttachment:
+            return { VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT };
+        case ImageUsage::DepthAttachment:
+            return { VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT, VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT };
+        case ImageUsage::Present:
+            //the semaphore signal after the submission covers presentation, nothing in the pipeline waits for it
+            return { VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE };
+        case ImageUsage::Undefined:
+        default:
+            return {};
+        }
+    }
+
+    BufferState buffer_state(const BufferUsage p_usage)
+    {
+        switch (p_usage)
+        {
+        case BufferUsage::TransferSrc:
+            return { VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_READ_BIT };
+        case BufferUsage::TransferDst:
+            return { VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT };
+        case BufferUsage::ComputeRead:
+            return { VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT };
+        case BufferUsage::ComputeWrite:
+            return { VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT };
+        case BufferUsage::ComputeReadWrite:
+            return { VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT };
+        case BufferUsage::VertexRead:
+            //vertices are pulled from storage buffers in the vertex shader
+            return { VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT };
+        case BufferUsage::IndexRead:
+            return { VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT, VK_ACCESS_2_INDEX_READ_BIT };
+        case BufferUsage::UniformRead:
+            return { VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_UNIFORM_READ_BIT };
+        case BufferUsage::IndirectRead:
+            return { VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT };
+        case BufferUsage::HostRead:
+        default:
+            return { VK_PIPELINE_STAGE_2_HOST_BIT, VK_ACCESS_2_HOST_READ_BIT };
+        }
+    }
+
+    VkImageAspectFlags aspect_from_format(const VkFormat p_format)
+    {
+        switch (p_format)
+        {
+        case VK_FORMAT_D16_UNORM:
+        case VK_FORMAT_X8_D24_UNORM_PACK32:
+        case VK_FORMAT_D32_SFLOAT:
+            return VK_IMAGE_ASPECT_DEPTH_BIT;
+        case VK_FORMAT_D16_UNORM_S8_UINT:
+        case VK_FORMAT_D24_UNORM_S8_UINT:
+        case VK_FORMAT_D32_SFLOAT_S8_UINT:
+            return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+        default:
+            return VK_IMAGE_ASPECT_COLOR_BIT;
+        }
+    }
+
+    void BarrierBatch::transition(const VkImage p_image, ImageState& p_state, const ImageState& p_target, const VkImageAspectFlags p_aspect, const bool p_discard)
+    {
+        const auto same_layout = p_state.layout == p_target.layout;
+        if (same_layout && !p_discard && !has_write(p_state.access) && !has_write(p_target.access))
+        {
+            //read after read, later writers have to wait for every reader
+            p_state.stage |= p_target.stage;
+            p_state.access |= p_target.access;
+            return;
+        }
+
+        //a second transition of the same image in one batch is folded into the first one,
+        //barriers inside a single vkCmdPipelineBarrier2 are not ordered against each other
+        if (const auto it = std::ranges::find_if(m_image_barriers, [p_image](const VkImageMemoryBarrier2& p_barrier) { return p_barrier.image == p_image; }); it != m_image_barriers.end())
+        {
+            it->dstStageMask |= p_target.stage;
+            it->dstAccessMask |= p_target.access;
+            it->newLayout = p_target.layout;
+            p_state = p_target;
+            return;
+        }
+
+        VkImageMemoryBarrier2 image_barrier{ .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2 };
+        image_barrier.pNext = nullptr;
+
+        //wait only for the stages that used the image, and only flush what they wrote
+        image_barrier.srcStageMask = p_state.stage;
+        image_barrier.srcAccessMask = p_state.access & WRITE_ACCESS_MASK;
+        image_barrier.dstStageMask = p_target.stage;
+        image_barrier.dstAccessMask = p_target.access;
+
+        image_barrier.oldLayout = p_discard ? VK_IMAGE_LAYOUT_UNDEFINED : p_state.layout;
+        image_barrier.newLayout = p_target.layout;
+
+        image_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        image_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+
+        image_barrier.subresourceRange = full_subresource_range(p_aspect);
+        image_barrier.image = p_image;
+
+        m_image_barriers.push_back(image_barrier);
+        p_state = p_target;
+    }
+
+    void BarrierBatch::transition(Image& p_image, const ImageUsage p_usage, const bool p_discard)
+    {
+        transition(p_image.get_image(), p_image.get_state(), image_state(p_usage), aspect_from_format(p_image.get_allocated_image().image_format), p_discard);
+    }
+
+    void BarrierBatch::access(const VkBuffer p_buffer, BufferState& p_state, const BufferState& p_target)
+    {
+        if (!has_write(p_state.access) && !has_write(p_target.access))
+        {
+            p_state.stage |= p_target.stage;
+            p_state.access |= p_target.access;
+            return;
+        }
+
+        if (const auto it = std::ranges::find_if(m_buffer_barriers, [p_buffer](const VkBufferMemoryBarrier2& p_barrier) { return p_barrier.buffer == p_buffer; }); it != m_buffer_barriers.end())
+        {
+            it->dstStageMask |= p_target.stage;
+            it->dstAccessMask |= p_target.access;
+            p_state = p_target;
+            return;
+        }
+
+        VkBufferMemoryBarrier2 buffer_barrier{ .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2 };
+        buffer_barrier.pNext = nullptr;
+
+        buffer_barrier.srcStageMask = p_state.stage;
+        buffer_barrier.srcAccessMask = p_state.access & WRITE_ACCESS_MASK;
+        buffer_barrier.dstStageMask = p_target.stage;
+        buffer_barrier.dstAccessMask = p_target.access;
+
+        buffer_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        buffer_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+
+        buffer_barrier.buffer = p_buffer;
+        buffer_barrier.offset = 0;
+        buffer_barrier.size = VK_WHOLE_SIZE;
+
+        m_buffer_barriers.push_back(buffer_barrier);
+        p_state = p_target;
+    }
+
+    void BarrierBatch::access(Buffer& p_buffer, const BufferUsage p_usage)
+    {
+        access(p_buffer.get_buffer(), p_buffer.get_state(), buffer_state(p_usage));
+    }
+
+    void BarrierBatch::transfer(const VkImage p_image, ImageState& p_state, const ImageState& p_target, const uint32_t p_src_family, const uint32_t p_dst_family, BarrierBatch& p_acquire, const VkImageAspectFlags p_aspect)
+    {
+        VkImageMemoryBarrier2 release{ .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2 };
+        release.pNext = nullptr;
+
+        //both halves carry the same layouts, the transition happens once between them
+        release.oldLayout = p_state.layout;
+        release.newLayout = p_target.layout;
+        release.srcQueueFamilyIndex = p_src_family;
+        release.dstQueueFamilyIndex = p_dst_family;
+        release.subresourceRange = full_subresource_range(p_aspect);
+        release.image = p_image;
+
+        //the destination half is ignored on the releasing queue, the semaphore takes care of it
+        auto acquire = release;
+        release.srcStageMask = p_state.stage;
+        release.srcAccessMask = p_state.access & WRITE_ACCESS_MASK;
+        release.dstStageMask = VK_PIPELINE_STAGE_2_NONE;
+        release.dstAccessMask = VK_ACCESS_2_NONE;
+
+        acquire.srcStageMask = VK_PIPELINE_STAGE_2_NONE;
+        acquire.srcAccessMask = VK_ACCESS_2_NONE;
+        acquire.dstStageMask = p_target.stage;
+        acquire.dstAccessMask = p_target.access;
+
+        m_image_barriers.push_back(release);
+        p_acquire.m_image_barriers.push_back(acquire);
+        p_state = p_target;
+    }
+
+    void BarrierBatch::transfer(const VkBuffer p_buffer, BufferState& p_state, const BufferState& p_target, const uint32_t p_src_family, const uint32_t p_dst_family, BarrierBatch& p_acquire)
+    {
+        VkBufferMemoryBarrier2 release{ .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2 };
+        release.pNext = nullptr;
+
+        release.srcQueueFamilyIndex = p_src_family;
+        release.dstQueueFamilyIndex = p_dst_family;
+        release.buffer = p_buffer;
+        release.offset = 0;
+        release.size = VK_WHOLE_SIZE;
+
+        auto acquire = release;
+        release.srcStageMask = p_state.stage;
+        release.srcAccessMask = p_state.access & WRITE_ACCESS_MASK;
+        release.dstStageMask = VK_PIPELINE_STAGE_2_NONE;
+        release.dstAccessMask = VK_ACCESS_2_NONE;
+
+        acquire.srcStageMask = VK_PIPELINE_STAGE_2_NONE;
+        acquire.srcAccessMask = VK_ACCESS_2_NONE;
+        acquire.dstStageMask = p_target.stage;
+        acquire.dstAccessMask = p_target.access;
+
+        m_buffer_barriers.push_back(release);
+        p_acquire.m_buffer_barriers.push_back(acquire);
+        p_state = p_target;
+    }
+
+    VkPipelineStageFlags2 BarrierBatch::get_dst_stages() const
+    {
+        VkPipelineStageFlags2 stages{ VK_PIPELINE_STAGE_2_NONE };
+        for (const auto& barrier : m_image_barriers)
+        {
+            stages |= barrier.dstStageMask;
+        }
+        for (const auto& barrier : m_buffer_barriers)
+        {
+            stages |= barrier.dstStageMask;
+        }
+
+        return stages;
+    }
+
+    void BarrierBatch::append(BarrierBatch& p_other)
+    {
+        m_image_barriers.insert(m_image_barriers.end(), p_other.m_image_barriers.begin(), p_other.m_image_barriers.end());
+        m_buffer_barriers.insert(m_buffer_barriers.end(), p_other.m_buffer_barriers.begin(), p_other.m_buffer_barriers.end());
+
+        p_other.m_image_barriers.clear();
+        p_other.m_buffer_barriers.clear();
+    }
+
+    void BarrierBatch::flush(const VkCommandBuffer p_cmd)
+    {
+        if (empty())
+        {
+            return;
+        }
+
+        VkDependencyInfo dep_info{};
+        dep_info.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+        dep_info.pNext = nullptr;
+
+        dep_info.imageMemoryBarrierCount = static_cast<uint32_t>(m_image_barriers.size());
+        dep_info.pImageMemoryBarriers = m_image_barriers.data();
+
+        dep_info.bufferMemoryBarrierCount = static_cast<uint32_t>(m_buffer_barriers.size());
+        dep_info.pBufferMemoryBarriers = m_buffer_barriers.data();
+
+        vkCmdPipelineBarrier2(p_cmd, &dep_info);
+
+        m_image_barriers.clear();
+        m_buffer_barriers.clear();
+    }
+}
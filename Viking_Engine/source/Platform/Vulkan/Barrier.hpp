@@ -0,0 +1,99 @@
+#ifndef VULKAN_BARRIER_HPP
+#define VULKAN_BARRIER_HPP
+
+#include <vulkan/vulkan.hpp>
+
+#include <vector>
+
+namespace vulkan
+{
+    class Buffer;
+    class Image;
+
+    //Last known layout of an image together with the stages and accesses that touched it in that layout
+    struct ImageState
+    {
+        VkImageLayout layout{ VK_IMAGE_LAYOUT_UNDEFINED };
+        VkPipelineStageFlags2 stage{ VK_PIPELINE_STAGE_2_NONE };
+        VkAccessFlags2 access{ VK_ACCESS_2_NONE };
+    };
+
+    //Last stages and accesses that touched a buffer
+    struct BufferState
+    {
+        VkPipelineStageFlags2 stage{ VK_PIPELINE_STAGE_2_NONE };
+        VkAccessFlags2 access{ VK_ACCESS_2_NONE };
+    };
+
+    //The ways the engine uses images, each one maps to the narrowest layout/stage/access triple
+    enum class ImageUsage
+    {
+        Undefined,
+        TransferSrc,
+        TransferDst,
+        ComputeRead,
+        ComputeWrite,
+        ComputeReadWrite,
+        ShaderRead,
+        ColorAttachment,
+        DepthAttachment,
+        Present
+    };
+
+    enum class BufferUsage
+    {
+        TransferSrc,
+        TransferDst,
+        ComputeRead,
+        ComputeWrite,
+        ComputeReadWrite,
+        VertexRead,
+        IndexRead,
+        UniformRead,
+        IndirectRead,
+        HostRead
+    };
+
+    [[nodiscard]] ImageState image_state(ImageUsage p_usage);
+    [[nodiscard]] BufferState buffer_state(BufferUsage p_usage);
+    [[nodiscard]] VkImageAspectFlags aspect_from_format(VkFormat p_format);
+
+    //Gathers image transitions and buffer barriers and records them with a single vkCmdPipelineBarrier2.
+    //The tracked state is updated when the transition is queued, so the batch has to be flushed
+    //before any command that relies on the new layouts is recorded
+    class BarrierBatch
+    {
+    public:
+        //Queues a transition of p_state into p_target. With p_discard the old contents are not preserved,
+        //which lets the driver skip the layout conversion. Read-after-read in the same layout needs no barrier
+        //and only widens the tracked state
+        void transition(VkImage p_image, ImageState& p_state, const ImageState& p_target, VkImageAspectFlags p_aspect = VK_IMAGE_ASPECT_COLOR_BIT, bool p_discard = false);
+        void transition(Image& p_image, ImageUsage p_usage, bool p_discard = false);
+
+        //Same rules as for images, a buffer has no layout so read after read never needs a barrier
+        void access(VkBuffer p_buffer, BufferState& p_state, const BufferState& p_target);
+        void access(Buffer& p_buffer, BufferUsage p_usage);
+
+        //Hands an exclusive resource over to another queue family. The release is queued in this batch and has to be
+        //recorded on the source queue, the matching acquire is queued in p_acquire for the destination queue,
+        //which must wait on a semaphore signalled after the release
+        void transfer(VkImage p_image, ImageState& p_state, const ImageState& p_target, uint32_t p_src_family, uint32_t p_dst_family, BarrierBatch& p_acquire, VkImageAspectFlags p_aspect = VK_IMAGE_ASPECT_COLOR_BIT);
+        void transfer(VkBuffer p_buffer, BufferState& p_state, const BufferState& p_target, uint32_t p_src_family, uint32_t p_dst_family, BarrierBatch& p_acquire);
+
+        //Stages the queued barriers wait on, used to pick the wait stage of the semaphore guarding an acquire
+        [[nodiscard]] VkPipelineStageFlags2 get_dst_stages() const;
+
+        void flush(VkCommandBuffer p_cmd);
+
+        //Moves every barrier queued in p_other to the end of this batch
+        void append(BarrierBatch& p_other);
+
+        [[nodiscard]] bool empty() const { return m_image_barriers.empty() && m_buffer_barriers.empty(); }
+
+    private:
+        std::vector<VkImageMemoryBarrier2> m_image_barriers;
+        std::vector<VkBufferMemoryBarrier2> m_buffer_barriers;
+    };
+}
+
+#endif // VULKAN_BARRIER_HPP
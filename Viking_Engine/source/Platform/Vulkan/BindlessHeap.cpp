@@ -0,0 +1,286 @@
+#include "Platform/Vulkan/BindlessHeap.hpp"
+
+#include "Platform/Vulkan/Descriptors.hpp"
+#include "Platform/Vulkan/Timeline.hpp"
+#include "Viking/core/Log.hpp"
+
+#include <vulkan/vk_enum_string_helper.h>
+
+#include <algorithm>
+#include <format>
+#include <stdexcept>
+#include <string_view>
+
+namespace
+{
+    //what the engine asks for, lowered to what the device allows
+    constexpr uint32_t MAX_SAMPLED_IMAGES{ 16384 };
+    constexpr uint32_t MAX_STORAGE_IMAGES{ 4096 };
+    constexpr uint32_t MAX_STORAGE_BUFFERS{ 16384 };
+    //the other sets and the color attachments of a pipeline count against the same per stage budget
+    constexpr uint32_t RESERVED_STAGE_RESOURCES{ 64 };
+
+    constexpr std::array BINDLESS_TYPES{
+        VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+        VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER
+    };
+
+    constexpr std::string_view type_name(const vulkan::BindlessType p_type)
+    {
+        switch (p_type)
+        {
+        case vulkan::BindlessType::SampledImage:
+            return "sampled image";
+        case vulkan::BindlessType::StorageImage:
+            return "storage image";
+        case vulkan::BindlessType::StorageBuffer:
+            return "storage buffer";
+        }
+
+        return "unknown";
+    }
+}
+
+namespace vulkan
+{
+    void BindlessHeap::init(const VkPhysicalDevice p_physical_device, const VkDevice p_device, Timeline& p_graphics_timeline)
+    {
+        m_device = p_device;
+        m_graphics_timeline = &p_graphics_timeline;
+
+        VkPhysicalDeviceVulkan12Properties properties12{};
+        properties12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES;
+
+        VkPhysicalDeviceProperties2 properties{};
+        properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+        properties.pNext = &properties12;
+        vkGetPhysicalDeviceProperties2(p_physical_device, &properties);
+
+        m_bindings[static_cast<size_t>(BindlessType::SampledImage)].m_capacity = std::min({ MAX_SAMPLED_IMAGES,
+            properties12.maxDescriptorSetUpdateAfterBindSampledImages, properties12.maxDescriptorSetUpdateAfterBindSamplers,
+            properties12.maxPerStageDescriptorUpdateAfterBindSampledImages, properties12.maxPerStageDescriptorUpdateAfterBindSamplers });
+        m_bindings[static_cast<size_t>(BindlessType::StorageImage)].m_capacity = std::min({ MAX_STORAGE_IMAGES,
+            properties12.maxDescriptorSetUpdateAfterBindStorageImages, properties12.maxPerStageDescriptorUpdateAfterBindStorageImages });
+        m_bindings[static_cast<size_t>(BindlessType::StorageBuffer)].m_capacity = std::min({ MAX_STORAGE_BUFFERS,
+            properties12.maxDescriptorSetUpdateAfterBindStorageBuffers, properties12.maxPerStageDescriptorUpdateAfterBindStorageBuffers });
+
+        //every binding is visible to all stages, so together they have to fit the per stage and per device totals
+        const auto resource_limit = std::min(properties12.maxPerStageUpdateAfterBindResources, properties12.maxUpdateAfterBindDescriptorsInAllPools);
+        const uint64_t budget = resource_limit > RESERVED_STAGE_RESOURCES ? resource_limit - RESERVED_STAGE_RESOURCES : 0;
+        uint64_t total{ 0 };
+        for (const auto& binding : m_bindings)
+        {
+            total += binding.m_capacity;
+        }
+        if (total > budget)
+        {
+            //each binding gives up the same share of its capacity
+            for (auto& binding : m_bindings)
+            {
+                binding.m_capacity = static_cast<uint32_t>(binding.m_capacity * budget / total);
+            }
+            VI_CORE_WARN("Bindless heap lowered from {} to {} descriptors, the device allows {} update-after-bind resources per stage", total, budget, resource_limit);
+        }
+        if (std::ranges::any_of(m_bindings, [](const Binding& p_binding) { return p_binding.m_capacity == 0; }))
+        {
+            throw std::runtime_error(std::format("The device allows only {} update-after-bind resources per stage, too few for the bindless heap", resource_limit));
+        }
+
+        DescriptorLayoutBuilder builder{};
+        std::array<VkDescriptorBindingFlags, BINDLESS_TYPES.size()> binding_flags{};
+        std::array<VkDescriptorPoolSize, BINDLESS_TYPES.size()> pool_sizes{};
+        for (uint32_t i = 0; i < BINDLESS_TYPES.size(); ++i)
+        {
+            builder.add_binding(i, BINDLESS_TYPES[i], m_bindings[i].m_capacity);
+            binding_flags[i] = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+            pool_sizes[i] = VkDescriptorPoolSize{ .type = BINDLESS_TYPES[i], .descriptorCount = m_bindings[i].m_capacity };
+        }
+
+        VkDescriptorSetLayoutBindingFlagsCreateInfo binding_flags_info{};
+        binding_flags_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+        binding_flags_info.pNext = nullptr;
+        binding_flags_info.bindingCount = static_cast<uint32_t>(binding_flags.size());
+        binding_flags_info.pBindingFlags = binding_flags.data();
+
+        m_layout = builder.build(m_device, VK_SHADER_STAGE_ALL, VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT, &binding_flags_info);
+
+        VkDescriptorPoolCreateInfo pool_info{};
+        pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        pool_info.pNext = nullptr;
+        pool_info.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+        pool_info.maxSets = 1;
+        pool_info.poolSizeCount = static_cast<uint32_t>(pool_sizes.size());
+        pool_info.pPoolSizes = pool_sizes.data();
+
+        if (const auto result = vkCreateDescriptorPool(m_device, &pool_info, nullptr, &m_pool); result != VK_SUCCESS)
+        {
+            throw std::runtime_error(std::format("Cannot create bindless descriptor pool: {}", string_VkResult(result)));
+        }
+
+        VkDescriptorSetAllocateInfo alloc_info{};
+        alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        alloc_info.pNext = nullptr;
+        alloc_info.descriptorPool = m_pool;
+        alloc_info.descriptorSetCount = 1;
+        alloc_info.pSetLayouts = &m_layout;
+
+        if (const auto result = vkAllocateDescriptorSets(m_device, &alloc_info, &m_set); result != VK_SUCCESS)
+        {
+            throw std::runtime_error(std::format("Cannot allocate bindless descriptor set: {}", string_VkResult(result)));
+        }
+
+        VI_CORE_INFO("Bindless heap holds {} sampled images, {} storage images and {} storage buffers", get_capacity(BindlessType::SampledImage),
+            get_capacity(BindlessType::StorageImage), get_capacity(BindlessType::StorageBuffer));
+    }
+
+    void BindlessHeap::cleanup()
+    {
+        vkDestroyDescriptorPool(m_device, m_pool, nullptr);
+        vkDestroyDescriptorSetLayout(m_device, m_layout, nullptr);
+        m_pool = VK_NULL_HANDLE;
+        m_layout = VK_NULL_HANDLE;
+        m_set = VK_NULL_HANDLE;
+
+        m_bindings = {};
+        m_retired.clear();
+    }
+
+    uint32_t BindlessHeap::register_sampled_image(const VkImageView p_image_view, const VkSampler p_sampler, const VkImageLayout p_layout)
+    {
+        std::scoped_lock lock{ m_mutex };
+        const auto index = allocate_index(BindlessType::SampledImage);
+        write_image(BindlessType::SampledImage, index, p_image_view, p_sampler, p_layout);
+        return index;
+    }
+
+    uint32_t BindlessHeap::register_storage_image(const VkImageView p_image_view)
+    {
+        std::scoped_lock lock{ m_mutex };
+        const auto index = allocate_index(BindlessType::StorageImage);
+        write_image(BindlessType::StorageImage, index, p_image_view, VK_NULL_HANDLE, VK_IMAGE_LAYOUT_GENERAL);
+        return index;
+    }
+
+    uint32_t BindlessHeap::register_storage_buffer(const VkBuffer p_buffer, const VkDeviceSize p_offset, const VkDeviceSize p_range)
+    {
+        std::scoped_lock lock{ m_mutex };
+        const auto index = allocate_index(BindlessType::StorageBuffer);
+        write_buffer(index, p_buffer, p_offset, p_range);
+        return index;
+    }
+
+    void BindlessHeap::update_sampled_image(const uint32_t p_index, const VkImageView p_image_view, const VkSampler p_sampler, const VkImageLayout p_layout)
+    {
+        std::scoped_lock lock{ m_mutex };
+        write_image(BindlessType::SampledImage, p_index, p_image_view, p_sampler, p_layout);
+    }
+
+    void BindlessHeap::update_storage_image(const uint32_t p_index, const VkImageView p_image_view)
+    {
+        std::scoped_lock lock{ m_mutex };
+        write_image(BindlessType::StorageImage, p_index, p_image_view, VK_NULL_HANDLE, VK_IMAGE_LAYOUT_GENERAL);
+    }
+
+    void BindlessHeap::update_storage_buffer(const uint32_t p_index, const VkBuffer p_buffer, const VkDeviceSize p_offset, const VkDeviceSize p_range)
+    {
+        std::scoped_lock lock{ m_mutex };
+        write_buffer(p_index, p_buffer, p_offset, p_range);
+    }
+
+    void BindlessHeap::release(const BindlessType p_type, const uint32_t p_index)
+    {
+        if (p_index == INVALID_BINDLESS_INDEX)
+        {
+            return;
+        }
+
+        std::scoped_lock lock{ m_mutex };
+        //the submission of the frame being recorded signals the next value
+        m_retired.push_back(Retired{ .m_type = p_type, .m_index = p_index, .m_timeline_value = m_graphics_timeline->get_last_value() + 1 });
+    }
+
+    void BindlessHeap::collect()
+    {
+        std::scoped_lock lock{ m_mutex };
+        if (m_retired.empty())
+        {
+            return;
+        }
+
+        const auto completed_value = m_graphics_timeline->get_completed_value();
+        std::erase_if(m_retired, [this, completed_value](const Retired& p_retired)
+        {
+            if (p_retired.m_timeline_value > completed_value)
+            {
+                return false;
+            }
+
+            m_bindings[static_cast<size_t>(p_retired.m_type)].m_free_indices.push_back(p_retired.m_index);
+            return true;
+        });
+    }
+
+    void BindlessHeap::bind(const VkCommandBuffer p_cmd, const VkPipelineBindPoint p_bind_point, const VkPipelineLayout p_layout, const uint32_t p_set) const
+    {
+        vkCmdBindDescriptorSets(p_cmd, p_bind_point, p_layout, p_set, 1, &m_set, 0, nullptr);
+    }
+
+    uint32_t BindlessHeap::allocate_index(const BindlessType p_type)
+    {
+        auto& binding = m_bindings[static_cast<size_t>(p_type)];
+        if (!binding.m_free_indices.empty())
+        {
+            const auto index = binding.m_free_indices.back();
+            binding.m_free_indices.pop_back();
+            return index;
+        }
+
+        if (binding.m_next_index == binding.m_capacity)
+        {
+            throw std::runtime_error(std::format("Bindless heap is out of {} slots ({} in use)", type_name(p_type), binding.m_capacity));
+        }
+
+        return binding.m_next_index++;
+    }
+
+    void BindlessHeap::write_image(const BindlessType p_type, const uint32_t p_index, const VkImageView p_image_view, const VkSampler p_sampler, const VkImageLayout p_layout)
+    {
+        VkDescriptorImageInfo image_info{};
+        image_info.sampler = p_sampler;
+        image_info.imageView = p_image_view;
+        image_info.imageLayout = p_layout;
+
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.pNext = nullptr;
+        write.dstSet = m_set;
+        write.dstBinding = static_cast<uint32_t>(p_type);
+        write.dstArrayElement = p_index;
+        write.descriptorCount = 1;
+        write.descriptorType = BINDLESS_TYPES[static_cast<size_t>(p_type)];
+        write.pImageInfo = &image_info;
+
+        vkUpdateDescriptorSets(m_device, 1, &write, 0, nullptr);
+    }
+
+    void BindlessHeap::write_buffer(const uint32_t p_index, const VkBuffer p_buffer, const VkDeviceSize p_offset, const VkDeviceSize p_range)
+    {
+        VkDescriptorBufferInfo buffer_info{};
+        buffer_info.buffer = p_buffer;
+        buffer_info.offset = p_offset;
+        buffer_info.range = p_range;
+
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.pNext = nullptr;
+        write.dstSet = m_set;
+        write.dstBinding = static_cast<uint32_t>(BindlessType::StorageBuffer);
+        write.dstArrayElement = p_index;
+        write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        write.pBufferInfo = &buffer_info;
+
+        vkUpdateDescriptorSets(m_device, 1, &write, 0, nullptr);
+    }
+}
@@ -0,0 +1,90 @@
+#ifndef VULKAN_BINDLESS_HEAP_HPP
+#define VULKAN_BINDLESS_HEAP_HPP
+
+#include <vulkan/vulkan.hpp>
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+namespace vulkan
+{
+    class Timeline;
+
+    constexpr uint32_t INVALID_BINDLESS_INDEX{ std::numeric_limits<uint32_t>::max() };
+
+    //Bindings of the heap, mirrored by shaders/bindless.glsl
+    enum class BindlessType : uint32_t
+    {
+        SampledImage,
+        StorageImage,
+        StorageBuffer
+    };
+
+    //One descriptor set holding every resource shaders can reach, bound once per command buffer.
+    //Each binding is a large partially bound array; a registered resource keeps its index until it is
+    //released, and the index is handed out again once the graphics timeline shows no frame can still read it.
+    //The set is update-after-bind, registering is allowed while it is bound by recorded or pending work
+    class BindlessHeap
+    {
+    public:
+        void init(VkPhysicalDevice p_physical_device, VkDevice p_device, Timeline& p_graphics_timeline);
+        void cleanup();
+
+        [[nodiscard]] uint32_t register_sampled_image(VkImageView p_image_view, VkSampler p_sampler, VkImageLayout p_layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        [[nodiscard]] uint32_t register_storage_image(VkImageView p_image_view);
+        [[nodiscard]] uint32_t register_storage_buffer(VkBuffer p_buffer, VkDeviceSize p_offset = 0, VkDeviceSize p_range = VK_WHOLE_SIZE);
+
+        //Replaces what an index points at, e.g. after a resize, without changing the index
+        void update_sampled_image(uint32_t p_index, VkImageView p_image_view, VkSampler p_sampler, VkImageLayout p_layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        void update_storage_image(uint32_t p_index, VkImageView p_image_view);
+        void update_storage_buffer(uint32_t p_index, VkBuffer p_buffer, VkDeviceSize p_offset = 0, VkDeviceSize p_range = VK_WHOLE_SIZE);
+
+        //The frame being recorded may still use the index
+        void release(BindlessType p_type, uint32_t p_index);
+        //Recycles the indices of released resources no submission can read anymore
+        void collect();
+
+        void bind(VkCommandBuffer p_cmd, VkPipelineBindPoint p_bind_point, VkPipelineLayout p_layout, uint32_t p_set = 0) const;
+
+        [[nodiscard]] VkDescriptorSetLayout get_layout() const { return m_layout; }
+        [[nodiscard]] VkDescriptorSet get_set() const { return m_set; }
+        [[nodiscard]] uint32_t get_capacity(BindlessType p_type) const { return m_bindings[static_cast<size_t>(p_type)].m_capacity; }
+
+    private:
+        struct Binding
+        {
+            uint32_t m_capacity{};
+            //indices never handed out yet start here
+            uint32_t m_next_index{};
+            std::vector<uint32_t> m_free_indices{};
+        };
+
+        struct Retired
+        {
+            BindlessType m_type{};
+            uint32_t m_index{};
+            uint64_t m_timeline_value{};
+        };
+
+        [[nodiscard]] uint32_t allocate_index(BindlessType p_type);
+        void write_image(BindlessType p_type, uint32_t p_index, VkImageView p_image_view, VkSampler p_sampler, VkImageLayout p_layout);
+        void write_buffer(uint32_t p_index, VkBuffer p_buffer, VkDeviceSize p_offset, VkDeviceSize p_range);
+
+        VkDevice m_device{};
+        Timeline* m_graphics_timeline{};
+
+        VkDescriptorPool m_pool{};
+        VkDescriptorSetLayout m_layout{};
+        VkDescriptorSet m_set{};
+
+        std::array<Binding, 3> m_bindings{};
+        std::vector<Retired> m_retired{};
+
+        mutable std::mutex m_mutex{};
+    };
+}
+
+#endif // VULKAN_BINDLESS_HEAP_HPP
@@ -0,0 +1,59 @@
+#include "Platform/Vulkan/Buffer.hpp"
+
+#include <vulkan/vk_enum_string_helper.h>
+
+#include <algorithm>
+#include <format>
+#include <stdexcept>
+#include <vector>
+
+namespace vulkan
+{
+    Buffer::Buffer(const VkDeviceSize p_size, const VkBufferUsageFlags p_usage_flags, const VmaMemoryUsage p_memory_usage, const VmaAllocator p_allocator, const VkDevice p_device, const VmaAllocationCreateFlags p_allocation_flags,
+        const std::span<const uint32_t> p_queue_families): m_device{ p_device }, m_allocator{ p_allocator }, m_size{ p_size }
+    {
+        //the same family listed twice is still exclusive use
+        std::vector<uint32_t> queue_families{ p_queue_families.begin(), p_queue_families.end() };
+        std::ranges::sort(queue_families);
+        queue_families.erase(std::ranges::unique(queue_families).begin(), queue_families.end());
+        m_concurrent = queue_families.size() > 1;
+
+        VkBufferCreateInfo buffer_info{};
+        buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        buffer_info.pNext = nullptr;
+        buffer_info.size = p_size;
+        buffer_info.usage = p_usage_flags;
+        if (m_concurrent)
+        {
+            buffer_info.sharingMode = VK_SHARING_MODE_CONCURRENT;
+            buffer_info.queueFamilyIndexCount = static_cast<uint32_t>(queue_families.size());
+            buffer_info.pQueueFamilyIndices = queue_families.data();
+        }
+
+        VmaAllocationCreateInfo alloc_info{};
+        alloc_info.usage = p_memory_usage;
+        alloc_info.flags = p_allocation_flags;
+
+        if (const auto result = vmaCreateBuffer(p_allocator, &buffer_info, &alloc_info, &m_buffer.buffer, &m_buffer.allocation, &m_buffer.info); result != VK_SUCCESS)
+        {
+            throw std::runtime_error(std::format("Cannot create buffer of {} bytes: {}", p_size, string_VkResult(result)));
+        }
+
+        if (p_usage_flags & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT)
+        {
+            VkBufferDeviceAddressInfo address_info{};
+            address_info.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO;
+            address_info.pNext = nullptr;
+            address_info.buffer = m_buffer.buffer;
+            m_device_address = vkGetBufferDeviceAddress(m_device, &address_info);
+        }
+    }
+
+    void Buffer::cleanup()
+    {
+        vmaDestroyBuffer(m_allocator, m_buffer.buffer, m_buffer.allocation);
+        m_buffer = {};
+        m_device_address = 0;
+        m_state = {};
+    }
+}
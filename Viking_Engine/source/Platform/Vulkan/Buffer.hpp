@@ -0,0 +1,55 @@
+#ifndef VULKAN_BUFFER_HPP
+#define VULKAN_BUFFER_HPP
+
+#include "Platform/Vulkan/Barrier.hpp"
+
+#include <vulkan/vulkan.hpp>
+
+#include <vk_mem_alloc.h>
+
+#include <cstdint>
+#include <span>
+
+namespace vulkan
+{
+    struct AllocatedBuffer
+    {
+        VkBuffer buffer;
+        VmaAllocation allocation;
+        VmaAllocationInfo info;
+    };
+
+    class Buffer
+    {
+    public:
+        //p_allocation_flags can request a persistent mapping (VMA_ALLOCATION_CREATE_MAPPED_BIT) together with host access.
+        //With more than one distinct queue family the buffer is shared concurrently and never changes ownership
+        Buffer(VkDeviceSize p_size, VkBufferUsageFlags p_usage_flags, VmaMemoryUsage p_memory_usage, VmaAllocator p_allocator, VkDevice p_device, VmaAllocationCreateFlags p_allocation_flags = 0,
+            std::span<const uint32_t> p_queue_families = {});
+
+        void cleanup();
+
+        [[nodiscard]] VkBuffer get_buffer() const { return m_buffer.buffer; }
+        [[nodiscard]] AllocatedBuffer get_allocated_buffer() const { return m_buffer; }
+        [[nodiscard]] VkDeviceSize get_size() const { return m_size; }
+        //nullptr unless the buffer was created persistently mapped
+        [[nodiscard]] void* get_mapped_data() const { return m_buffer.info.pMappedData; }
+        //0 unless the buffer was created with VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT
+        [[nodiscard]] VkDeviceAddress get_device_address() const { return m_device_address; }
+        [[nodiscard]] bool is_concurrent() const { return m_concurrent; }
+
+        //Last access of the buffer as recorded so far, kept up to date by BarrierBatch
+        BufferState& get_state() { return m_state; }
+
+    private:
+        VkDevice m_device{};
+        VmaAllocator m_allocator{};
+        AllocatedBuffer m_buffer{};
+        VkDeviceSize m_size{};
+        VkDeviceAddress m_device_address{};
+        bool m_concurrent{ false };
+        BufferState m_state{};
+    };
+}
+
+#endif // VULKAN_BUFFER_HPP
@@ -2,9 +2,13 @@
 
 #include "Platform/Windows/Window.hpp"
 #include "Viking/core/Log.hpp"
+#include "Viking/core/Paths.hpp"
 
 #include <VkBootstrap.h>
 
+#include <format>
+#include <stdexcept>
+
 #define VMA_IMPLEMENTATION
 #include <vk_mem_alloc.h>
 
@@ -16,12 +20,18 @@ namespace
 #else
     constexpr bool USE_VALIDATION_LAYERS{ false };
 #endif
+
+    constexpr auto PIPELINE_CACHE_FILE{ "pipeline_cache.bin" };
 }
 
 namespace vulkan
 {
     void Context::init(const std::string_view p_app_name, const std::shared_ptr<vi::Window>& p_window)
     {
+        //any window that cannot give us a surface runs headless, rendering only into the draw image
+        const auto* windows_window = dynamic_cast<windows::Window*>(p_window.get());
+        const auto headless = windows_window == nullptr;
+
         vkb::InstanceBuilder builder;
 
         // Make the vulkan instance, with basic debug features
@@ -51,6 +61,7 @@ namespace vulkan
                 return VK_FALSE;
             })
             .require_api_version(1, 3, 0)
+            .set_headless(headless)
             .build();
 
         const auto vkb_instance = instance_return.value();
@@ -58,29 +69,68 @@ namespace vulkan
         m_instance = vkb_instance.instance;
         m_debug_messenger = vkb_instance.debug_messenger;
 
-        const auto* windows_window = dynamic_cast<windows::Window*>(p_window.get());
-        m_surface = windows_window->create_surface(m_instance);
+        if (!headless)
+        {
+            m_surface = windows_window->create_surface(m_instance);
+        }
 
         //vulkan 1.3 features
         VkPhysicalDeviceVulkan13Features features{};
         features.dynamicRendering = true;
         features.synchronization2 = true;
 
+        //vulkan 1.0 features, the culling pass writes one indirect draw per object and picks its instance data
+        VkPhysicalDeviceFeatures features10{};
+        features10.multiDrawIndirect = true;
+        features10.drawIndirectFirstInstance = true;
+
         //vulkan 1.2 features
         VkPhysicalDeviceVulkan12Features features12{};
         features12.bufferDeviceAddress = true;
+        features12.drawIndirectCount = true;
         features12.descriptorIndexing = true;
+        //what the bindless heap needs: partially bound runtime arrays indexed non-uniformly and updated while bound
+        features12.runtimeDescriptorArray = true;
+        features12.descriptorBindingPartiallyBound = true;
+        features12.descriptorBindingUpdateUnusedWhilePending = true;
+        features12.descriptorBindingSampledImageUpdateAfterBind = true;
+        features12.descriptorBindingStorageImageUpdateAfterBind = true;
+        features12.descriptorBindingStorageBufferUpdateAfterBind = true;
+        features12.shaderSampledImageArrayNonUniformIndexing = true;
+        features12.shaderStorageImageArrayNonUniformIndexing = true;
+        features12.shaderStorageBufferArrayNonUniformIndexing = true;
+        features12.timelineSemaphore = true;
+        features12.hostQueryReset = true;
 
         //use vk-bootstrap to select a gpu. 
-        //We want a gpu that can write to the GLFW surface and supports vulkan 1.3 with the correct features
+        //We want a gpu that can write to the GLFW surface and supports vulkan 1.3 with the correct features.
+        //A discrete gpu wins, any other type is only taken when nothing better is suitable,
+        //which lets a headless run fall back to a software rasterizer such as lavapipe on machines without a gpu
         vkb::PhysicalDeviceSelector selector{ vkb_instance };
-        auto physical_device = selector
+        selector
             .set_minimum_version(1, 3)
+            .prefer_gpu_device_type(vkb::PreferredDeviceType::discrete)
+            .allow_any_gpu_device_type(true)
+            .set_required_features(features10)
             .set_required_features_13(features)
-            .set_required_features_12(features12)
-            .set_surface(m_surface)
-            .select()
-            .value();
+            .set_required_features_12(features12);
+        if (!headless)
+        {
+            selector.set_surface(m_surface);
+        }
+
+        auto selector_return = selector.select();
+        if (!selector_return)
+        {
+            throw std::runtime_error(std::format("Cannot find a suitable gpu: {}", selector_return.error().message()));
+        }
+        auto physical_device = selector_return.value();
+
+        VI_CORE_INFO("Rendering on {}{}", physical_device.name, headless ? " without a surface" : "");
+        if (physical_device.properties.deviceType == VK_PHYSICAL_DEVICE_TYPE_CPU)
+        {
+            VI_CORE_WARN("{} is a software rasterizer, expect low performance", physical_device.name);
+        }
 
         //create the final vulkan device
         vkb::DeviceBuilder device_builder{ physical_device };
@@ -100,20 +150,100 @@ namespace vulkan
             vmaDestroyAllocator(m_allocator);
         });
 
-        m_swapchain.init(m_chosen_gpu, m_device, m_surface, p_window->get_size(), m_allocator, m_deletion_queue);
+        m_swapchain.init(m_chosen_gpu, m_device, m_surface, p_window->get_size(), p_window->get_present_mode(), m_allocator);
 
         m_graphics_queue = vkb_device.get_queue(vkb::QueueType::graphics).value();
         m_graphics_queue_family = vkb_device.get_queue_index(vkb::QueueType::graphics).value();
+
+        //prefer a compute-only family, then any other family with compute, so compute work can overlap with graphics
+        if (auto dedicated = vkb_device.get_dedicated_queue(vkb::QueueType::compute); dedicated.has_value())
+        {
+            m_compute_queue = dedicated.value();
+            m_compute_queue_family = vkb_device.get_dedicated_queue_index(vkb::QueueType::compute).value();
+        }
+        else if (auto separate = vkb_device.get_queue(vkb::QueueType::compute); separate.has_value())
+        {
+            m_compute_queue = separate.value();
+            m_compute_queue_family = vkb_device.get_queue_index(vkb::QueueType::compute).value();
+        }
+        else
+        {
+            m_compute_queue = m_graphics_queue;
+            m_compute_queue_family = m_graphics_queue_family;
+        }
+
+        if (has_async_compute())
+        {
+            VI_CORE_INFO("Async compute on queue family {}", m_compute_queue_family);
+        }
+        else
+        {
+            VI_CORE_INFO("No separate compute queue, compute work runs on the graphics queue");
+        }
+
+        //copy engines usually sit behind a transfer-only family, uploads then run next to rendering
+        if (auto dedicated = vkb_device.get_dedicated_queue(vkb::QueueType::transfer); dedicated.has_value())
+        {
+            m_transfer_queue = dedicated.value();
+            m_transfer_queue_family = vkb_device.get_dedicated_queue_index(vkb::QueueType::transfer).value();
+        }
+        else if (auto separate = vkb_device.get_queue(vkb::QueueType::transfer); separate.has_value())
+        {
+            m_transfer_queue = separate.value();
+            m_transfer_queue_family = vkb_device.get_queue_index(vkb::QueueType::transfer).value();
+        }
+        else
+        {
+            m_transfer_queue = m_graphics_queue;
+            m_transfer_queue_family = m_graphics_queue_family;
+        }
+
+        VI_CORE_INFO("Uploads run on queue family {}", m_transfer_queue_family);
+
+        //one timeline semaphore per queue, every submission signals the next value
+        m_graphics_timeline.init(m_device);
+        m_deletion_queue.push_function([&]() {
+            m_graphics_timeline.cleanup();
+        });
+
+        if (has_async_compute())
+        {
+            m_compute_timeline.init(m_device);
+            m_deletion_queue.push_function([&]() {
+                m_compute_timeline.cleanup();
+            });
+        }
+
+        m_transfer_timeline.init(m_device);
+        m_deletion_queue.push_function([&]() {
+            m_transfer_timeline.cleanup();
+        });
+
+        m_shader_cache.init(m_device);
+        m_deletion_queue.push_function([&]() {
+            m_shader_cache.cleanup();
+        });
+
+        //compiled pipelines from the previous run, written back on cleanup. Kept next to the executable,
+        //the working directory changes with how the application is started
+        m_pipeline_cache.init(m_chosen_gpu, m_device, vi::get_executable_directory() / PIPELINE_CACHE_FILE);
+        m_deletion_queue.push_function([&]() {
+            m_pipeline_cache.cleanup();
+        });
     }
 
     void Context::cleanup()
     {
         vkDeviceWaitIdle(m_device);
-        m_deletion_queue.flush();
 
+        //the draw image lives in the allocator, so the swapchain goes before the deletion queue
         m_swapchain.cleanup();
+        m_deletion_queue.flush();
 
-        vkDestroySurfaceKHR(m_instance, m_surface, nullptr);
+        if (m_surface != VK_NULL_HANDLE)
+        {
+            vkDestroySurfaceKHR(m_instance, m_surface, nullptr);
+        }
         vkDestroyDevice(m_device, nullptr);
         vkb::destroy_debug_utils_messenger(m_instance, m_debug_messenger);
         vkDestroyInstance(m_instance, nullptr);
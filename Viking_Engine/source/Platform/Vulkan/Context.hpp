@@ -1,6 +1,9 @@
 #ifndef VULKAN_CONTEXT_HPP
 #define VULKAN_CONTEXT_HPP
+#include "Platform/Vulkan/PipelineCache.hpp"
+#include "Platform/Vulkan/Shader.hpp"
 #include "Platform/Vulkan/Swapchain.hpp"
+#include "Platform/Vulkan/Timeline.hpp"
 
 #include "Viking/core/DeletionQueue.hpp"
 #include "Viking/core/Window.hpp"
@@ -18,10 +21,26 @@ namespace vulkan
         void init(std::string_view p_app_name, const std::shared_ptr<vi::Window>& p_window) override;
         void cleanup() override;
 
+        [[nodiscard]] VkPhysicalDevice get_physical_device() const { return m_chosen_gpu; }
         [[nodiscard]] VkDevice get_device() const { return m_device; }
+        [[nodiscard]] VmaAllocator get_allocator() const { return m_allocator; }
         [[nodiscard]] uint32_t get_graphics_queue_family() const { return m_graphics_queue_family; }
         [[nodiscard]] VkQueue get_graphics_queue() const { return m_graphics_queue; }
+        [[nodiscard]] Timeline& get_graphics_timeline() { return m_graphics_timeline; }
+
+        //Without a separate compute queue these return the graphics queue and its timeline
+        [[nodiscard]] uint32_t get_compute_queue_family() const { return m_compute_queue_family; }
+        [[nodiscard]] VkQueue get_compute_queue() const { return m_compute_queue; }
+        [[nodiscard]] Timeline& get_compute_timeline() { return has_async_compute() ? m_compute_timeline : m_graphics_timeline; }
+        [[nodiscard]] bool has_async_compute() const { return m_compute_queue != m_graphics_queue; }
+
+        //Falls back to the graphics queue too, the transfer timeline always exists and is only signalled by uploads
+        [[nodiscard]] uint32_t get_transfer_queue_family() const { return m_transfer_queue_family; }
+        [[nodiscard]] VkQueue get_transfer_queue() const { return m_transfer_queue; }
+        [[nodiscard]] Timeline& get_transfer_timeline() { return m_transfer_timeline; }
         [[nodiscard]] Swapchain& get_swapchain() { return m_swapchain; }
+        [[nodiscard]] ShaderCache& get_shader_cache() { return m_shader_cache; }
+        [[nodiscard]] VkPipelineCache get_pipeline_cache() const { return m_pipeline_cache.get_cache(); }
 
     private:
         VkPhysicalDevice            m_chosen_gpu{};
@@ -32,8 +51,19 @@ namespace vulkan
 
         VkQueue m_graphics_queue{};
         uint32_t m_graphics_queue_family{};
+        Timeline m_graphics_timeline{};
+
+        VkQueue m_compute_queue{};
+        uint32_t m_compute_queue_family{};
+        Timeline m_compute_timeline{};
+
+        VkQueue m_transfer_queue{};
+        uint32_t m_transfer_queue_family{};
+        Timeline m_transfer_timeline{};
 
         Swapchain m_swapchain{};
+        ShaderCache m_shader_cache{};
+        PipelineCache m_pipeline_cache{};
 
         vi::DeletionQueue m_deletion_queue{};
 
@@ -0,0 +1,218 @@
+#include "Platform/Vulkan/Descriptors.hpp"
+
+#include <vulkan/vk_enum_string_helper.h>
+
+#include <algorithm>
+#include <format>
+#include <stdexcept>
+
+namespace vulkan
+{
+    DescriptorLayoutBuilder& DescriptorLayoutBuilder::add_binding(const uint32_t p_binding, const VkDescriptorType p_type, const uint32_t p_count)
+    {
+        VkDescriptorSetLayoutBinding binding{};
+        binding.binding = p_binding;
+        binding.descriptorCount = p_count;
+        binding.descriptorType = p_type;
+
+        m_bindings.push_back(binding);
+        return *this;
+    }
+
+    void DescriptorLayoutBuilder::clear()
+    {
+        m_bindings.clear();
+    }
+
+    VkDescriptorSetLayout DescriptorLayoutBuilder::build(const VkDevice p_device, const VkShaderStageFlags p_shader_stages, const VkDescriptorSetLayoutCreateFlags p_flags, const void* p_next)
+    {
+        for (auto& binding : m_bindings)
+        {
+            binding.stageFlags |= p_shader_stages;
+        }
+
+        VkDescriptorSetLayoutCreateInfo info{};
+        info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        info.pNext = p_next;
+
+        info.pBindings = m_bindings.data();
+        info.bindingCount = static_cast<uint32_t>(m_bindings.size());
+        info.flags = p_flags;
+
+        VkDescriptorSetLayout set_layout{};
+        if (const auto result = vkCreateDescriptorSetLayout(p_device, &info, nullptr, &set_layout); result != VK_SUCCESS)
+        {
+            throw std::runtime_error(std::format("Cannot create descriptor set layout: {}", string_VkResult(result)));
+        }
+
+        return set_layout;
+    }
+
+    void DescriptorAllocatorGrowable::init(const VkDevice p_device, const uint32_t p_initial_sets, const std::span<const PoolSizeRatio> p_pool_ratios)
+    {
+        m_device = p_device;
+        m_ratios.assign(p_pool_ratios.begin(), p_pool_ratios.end());
+
+        m_ready_pools.push_back(create_pool(p_initial_sets));
+        m_sets_per_pool = std::min(p_initial_sets + p_initial_sets / 2, MAX_SETS_PER_POOL);
+    }
+
+    void DescriptorAllocatorGrowable::clear()
+    {
+        for (const auto pool : m_ready_pools)
+        {
+            vkResetDescriptorPool(m_device, pool, 0);
+        }
+
+        for (const auto pool : m_full_pools)
+        {
+            vkResetDescriptorPool(m_device, pool, 0);
+            m_ready_pools.push_back(pool);
+        }
+        m_full_pools.clear();
+    }
+
+    void DescriptorAllocatorGrowable::cleanup()
+    {
+        for (const auto pool : m_ready_pools)
+        {
+            vkDestroyDescriptorPool(m_device, pool, nullptr);
+        }
+        m_ready_pools.clear();
+
+        for (const auto pool : m_full_pools)
+        {
+            vkDestroyDescriptorPool(m_device, pool, nullptr);
+        }
+        m_full_pools.clear();
+    }
+
+    VkDescriptorSet DescriptorAllocatorGrowable::allocate(const VkDescriptorSetLayout p_layout, const void* p_next)
+    {
+        auto pool = get_pool();
+
+        VkDescriptorSetAllocateInfo alloc_info{};
+        alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        alloc_info.pNext = p_next;
+        alloc_info.descriptorPool = pool;
+        alloc_info.descriptorSetCount = 1;
+        alloc_info.pSetLayouts = &p_layout;
+
+        VkDescriptorSet descriptor_set{};
+        auto result = vkAllocateDescriptorSets(m_device, &alloc_info, &descriptor_set);
+
+        //the pool is exhausted, park it until the next clear and retry once with a fresh one
+        if (result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL)
+        {
+            m_full_pools.push_back(pool);
+
+            pool = get_pool();
+            alloc_info.descriptorPool = pool;
+            result = vkAllocateDescriptorSets(m_device, &alloc_info, &descriptor_set);
+        }
+
+        if (result != VK_SUCCESS)
+        {
+            //the pool is still ours, parked like a full one so clear and cleanup see it
+            m_full_pools.push_back(pool);
+            throw std::runtime_error(std::format("Cannot allocate descriptor set: {}", string_VkResult(result)));
+        }
+
+        m_ready_pools.push_back(pool);
+        return descriptor_set;
+    }
+
+    VkDescriptorPool DescriptorAllocatorGrowable::get_pool()
+    {
+        if (!m_ready_pools.empty())
+        {
+            const auto pool = m_ready_pools.back();
+            m_ready_pools.pop_back();
+            return pool;
+        }
+
+        const auto pool = create_pool(m_sets_per_pool);
+        m_sets_per_pool = std::min(m_sets_per_pool + m_sets_per_pool / 2, MAX_SETS_PER_POOL);
+        return pool;
+    }
+
+    VkDescriptorPool DescriptorAllocatorGrowable::create_pool(const uint32_t p_set_count) const
+    {
+        std::vector<VkDescriptorPoolSize> pool_sizes{};
+        for (const auto& [type, ratio] : m_ratios)
+        {
+            pool_sizes.push_back(VkDescriptorPoolSize{
+                .type = type,
+                .descriptorCount = std::max(static_cast<uint32_t>(ratio * static_cast<float>(p_set_count)), 1u)
+            });
+        }
+
+        VkDescriptorPoolCreateInfo pool_info{};
+        pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        pool_info.flags = 0;
+        pool_info.maxSets = p_set_count;
+        pool_info.poolSizeCount = static_cast<uint32_t>(pool_sizes.size());
+        pool_info.pPoolSizes = pool_sizes.data();
+
+        VkDescriptorPool pool{};
+        if (const auto result = vkCreateDescriptorPool(m_device, &pool_info, nullptr, &pool); result != VK_SUCCESS)
+        {
+            throw std::runtime_error(std::format("Cannot create descriptor pool: {}", string_VkResult(result)));
+        }
+
+        return pool;
+    }
+
+    void DescriptorWriter::write_image(const uint32_t p_binding, const VkImageView p_image_view, const VkSampler p_sampler, const VkImageLayout p_layout, const VkDescriptorType p_type)
+    {
+        const auto& info = m_image_infos.emplace_back(VkDescriptorImageInfo{
+            .sampler = p_sampler,
+            .imageView = p_image_view,
+            .imageLayout = p_layout
+        });
+
+        VkWriteDescriptorSet write{ .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+        write.dstBinding = p_binding;
+        write.dstSet = VK_NULL_HANDLE; //left empty for now until we need to write it
+        write.descriptorCount = 1;
+        write.descriptorType = p_type;
+        write.pImageInfo = &info;
+
+        m_writes.push_back(write);
+    }
+
+    void DescriptorWriter::write_buffer(const uint32_t p_binding, const VkBuffer p_buffer, const VkDeviceSize p_size, const VkDeviceSize p_offset, const VkDescriptorType p_type)
+    {
+        const auto& info = m_buffer_infos.emplace_back(VkDescriptorBufferInfo{
+            .buffer = p_buffer,
+            .offset = p_offset,
+            .range = p_size
+        });
+
+        VkWriteDescriptorSet write{ .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+        write.dstBinding = p_binding;
+        write.dstSet = VK_NULL_HANDLE; //left empty for now until we need to write it
+        write.descriptorCount = 1;
+        write.descriptorType = p_type;
+        write.pBufferInfo = &info;
+
+        m_writes.push_back(write);
+    }
+
+    void DescriptorWriter::clear()
+    {
+        m_image_infos.clear();
+        m_buffer_infos.clear();
+        m_writes.clear();
+    }
+
+    void DescriptorWriter::update_set(const VkDevice p_device, const VkDescriptorSet p_set)
+    {
+        for (auto& write : m_writes)
+        {
+            write.dstSet = p_set;
+        }
+
+        vkUpdateDescriptorSets(p_device, static_cast<uint32_t>(m_writes.size()), m_writes.data(), 0, nullptr);
+    }
+}
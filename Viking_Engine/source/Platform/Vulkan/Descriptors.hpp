@@ -0,0 +1,75 @@
+#ifndef VULKAN_DESCRIPTORS_HPP
+#define VULKAN_DESCRIPTORS_HPP
+
+#include <vulkan/vulkan.hpp>
+
+#include <deque>
+#include <span>
+#include <vector>
+
+namespace vulkan
+{
+    class DescriptorLayoutBuilder
+    {
+    public:
+        DescriptorLayoutBuilder& add_binding(uint32_t p_binding, VkDescriptorType p_type, uint32_t p_count = 1);
+        void clear();
+
+        [[nodiscard]] VkDescriptorSetLayout build(VkDevice p_device, VkShaderStageFlags p_shader_stages, VkDescriptorSetLayoutCreateFlags p_flags = 0, const void* p_next = nullptr);
+
+    private:
+        std::vector<VkDescriptorSetLayoutBinding> m_bindings{};
+    };
+
+    //Chain of pools that grows when the current one runs out. clear resets every pool at once and keeps them,
+    //so a steady workload stops creating pools after the first frames. Meant to be owned per frame in flight
+    //and cleared when that frame's previous submission has completed
+    class DescriptorAllocatorGrowable
+    {
+    public:
+        struct PoolSizeRatio
+        {
+            VkDescriptorType type;
+            float ratio;
+        };
+
+        void init(VkDevice p_device, uint32_t p_initial_sets, std::span<const PoolSizeRatio> p_pool_ratios);
+        void clear();
+        void cleanup();
+
+        [[nodiscard]] VkDescriptorSet allocate(VkDescriptorSetLayout p_layout, const void* p_next = nullptr);
+
+    private:
+        static constexpr uint32_t MAX_SETS_PER_POOL{ 4092 };
+
+        [[nodiscard]] VkDescriptorPool get_pool();
+        [[nodiscard]] VkDescriptorPool create_pool(uint32_t p_set_count) const;
+
+        VkDevice m_device{};
+        std::vector<PoolSizeRatio> m_ratios{};
+        //pools that failed an allocation since the last clear
+        std::vector<VkDescriptorPool> m_full_pools{};
+        std::vector<VkDescriptorPool> m_ready_pools{};
+        //size of the next pool to create
+        uint32_t m_sets_per_pool{};
+    };
+
+    //Gathers descriptor writes and applies them with one vkUpdateDescriptorSets
+    class DescriptorWriter
+    {
+    public:
+        void write_image(uint32_t p_binding, VkImageView p_image_view, VkSampler p_sampler, VkImageLayout p_layout, VkDescriptorType p_type);
+        void write_buffer(uint32_t p_binding, VkBuffer p_buffer, VkDeviceSize p_size, VkDeviceSize p_offset, VkDescriptorType p_type);
+
+        void clear();
+        void update_set(VkDevice p_device, VkDescriptorSet p_set);
+
+    private:
+        //deques keep the infos at stable addresses while the writes point at them
+        std::deque<VkDescriptorImageInfo> m_image_infos{};
+        std::deque<VkDescriptorBufferInfo> m_buffer_infos{};
+        std::vector<VkWriteDescriptorSet> m_writes{};
+    };
+}
+
+#endif // VULKAN_DESCRIPTORS_HPP
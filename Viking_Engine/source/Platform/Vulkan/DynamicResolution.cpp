@@ -0,0 +1,97 @@
+#include "Platform/Vulkan/DynamicResolution.hpp"
+
+#include "Viking/core/Log.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    //weight of the newest measurement in the smoothed frame time
+    constexpr double SMOOTHING{ 0.25 };
+    //the scale only grows while the frame takes less than this part of the budget
+    constexpr double HEADROOM{ 0.85 };
+    constexpr float MAX_STEP_UP{ 0.05f };
+    constexpr float MAX_STEP_DOWN{ 0.25f };
+    //changes smaller than this are not worth a different render extent
+    constexpr float MIN_STEP{ 0.01f };
+    constexpr uint32_t BLOCK_SIZE{ 8 };
+}
+
+namespace vulkan
+{
+    void DynamicResolution::init(const float p_target_ms, const float p_min_scale, const uint32_t p_latency_frames)
+    {
+        m_target_ms = std::max(p_target_ms, 0.0f);
+        m_min_scale = std::clamp(p_min_scale, 0.1f, 1.0f);
+        m_latency_frames = p_latency_frames;
+        m_scale = 1.0f;
+        m_smoothed_ms = 0.0;
+        m_settle_frames = 0;
+
+        if (is_enabled())
+        {
+            VI_CORE_INFO("Dynamic resolution targets {} ms of GPU time, scaling down to {}", m_target_ms, m_min_scale);
+        }
+    }
+
+    void DynamicResolution::update(const double p_gpu_ms)
+    {
+        if (!is_enabled() || p_gpu_ms <= 0.0)
+        {
+            return;
+        }
+
+        m_smoothed_ms = m_smoothed_ms == 0.0 ? p_gpu_ms : m_smoothed_ms + (p_gpu_ms - m_smoothed_ms) * SMOOTHING;
+
+        //frames still in flight were rendered at the old scale, reacting to them again would overshoot
+        if (m_settle_frames > 0)
+        {
+            --m_settle_frames;
+            return;
+        }
+
+        //the rendered area follows the square of the scale
+        const auto ideal = m_scale * static_cast<float>(std::sqrt(m_target_ms / m_smoothed_ms));
+
+        auto scale = m_scale;
+        if (m_smoothed_ms > m_target_ms)
+        {
+            scale = std::max(ideal, m_scale - MAX_STEP_DOWN);
+        }
+        else if (m_smoothed_ms < m_target_ms * HEADROOM)
+        {
+            scale = std::min(ideal, m_scale + MAX_STEP_UP);
+        }
+
+        //tiny changes are not worth a different render extent, unless they reach a limit
+        scale = std::clamp(scale, m_min_scale, 1.0f);
+        if (scale == m_scale || (std::abs(scale - m_scale) < MIN_STEP && scale != 1.0f && scale != m_min_scale))
+        {
+            return;
+        }
+
+        //the average holds times of the old scale, it is moved to what the new area is expected to cost
+        //so the samples still coming in at the old scale are not corrected for a second time
+        const auto ratio = static_cast<double>(scale) / static_cast<double>(m_scale);
+        m_smoothed_ms *= ratio * ratio;
+        m_scale = scale;
+        m_settle_frames = m_latency_frames;
+    }
+
+    VkExtent2D DynamicResolution::get_render_extent(const VkExtent2D p_full_extent) const
+    {
+        const auto scale_dimension = [this](const uint32_t p_dimension)
+        {
+            if (m_scale >= 1.0f)
+            {
+                return p_dimension;
+            }
+
+            const auto scaled = static_cast<uint32_t>(static_cast<float>(p_dimension) * m_scale);
+            return std::clamp(scaled / BLOCK_SIZE * BLOCK_SIZE, std::min(BLOCK_SIZE, p_dimension), p_dimension);
+        };
+
+        return { scale_dimension(p_full_extent.width), scale_dimension(p_full_extent.height) };
+    }
+}
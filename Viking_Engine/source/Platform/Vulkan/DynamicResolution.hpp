@@ -0,0 +1,40 @@
+#ifndef VULKAN_DYNAMIC_RESOLUTION_HPP
+#define VULKAN_DYNAMIC_RESOLUTION_HPP
+
+#include <vulkan/vulkan.hpp>
+
+#include <cstdint>
+
+namespace vulkan
+{
+    //Feedback loop picking the fraction of the draw image that is rendered, so the GPU frame time stays under a budget.
+    //Cost is assumed to follow the pixel count, the measured time is smoothed and the scale moves in small steps,
+    //it drops quickly when over budget and only climbs back once there is clear headroom
+    class DynamicResolution
+    {
+    public:
+        //A target of 0 disables the loop and renders at full resolution.
+        //p_latency_frames is how many frames pass before a measured frame is the one a change applied to
+        void init(float p_target_ms, float p_min_scale, uint32_t p_latency_frames);
+
+        //Feeds the GPU time of a frame the profiler has just read back, each frame must be fed only once
+        void update(double p_gpu_ms);
+
+        //Part of p_full_extent to render, rounded to whole 8 pixel blocks and never empty
+        [[nodiscard]] VkExtent2D get_render_extent(VkExtent2D p_full_extent) const;
+
+        [[nodiscard]] bool is_enabled() const { return m_target_ms > 0.0f; }
+        [[nodiscard]] float get_scale() const { return m_scale; }
+
+    private:
+        float m_target_ms{};
+        float m_min_scale{ 1.0f };
+        float m_scale{ 1.0f };
+        double m_smoothed_ms{};
+        uint32_t m_latency_frames{};
+        //frames left before the effect of the last change can show up in the measurements
+        uint32_t m_settle_frames{};
+    };
+}
+
+#endif // VULKAN_DYNAMIC_RESOLUTION_HPP
@@ -0,0 +1,134 @@
+#include "Platform/Vulkan/FrameAllocator.hpp"
+
+#include "Platform/Vulkan/Buffer.hpp"
+#include "Viking/core/Log.hpp"
+
+#include <vulkan/vk_enum_string_helper.h>
+
+#include <algorithm>
+#include <format>
+#include <stdexcept>
+
+namespace
+{
+    constexpr VkBufferUsageFlags FRAME_BUFFER_USAGE{ VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT |
+        VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT };
+
+    constexpr VkDeviceSize align_up(const VkDeviceSize p_value, const VkDeviceSize p_alignment)
+    {
+        return (p_value + p_alignment - 1) & ~(p_alignment - 1);
+    }
+}
+
+namespace vulkan
+{
+    void FrameAllocator::init(const VkPhysicalDevice p_physical_device, const VkDevice p_device, const VmaAllocator p_allocator, const VkDeviceSize p_block_size)
+    {
+        m_device = p_device;
+        m_allocator = p_allocator;
+
+        VkPhysicalDeviceProperties properties{};
+        vkGetPhysicalDeviceProperties(p_physical_device, &properties);
+        m_uniform_alignment = std::max(properties.limits.minUniformBufferOffsetAlignment, DEFAULT_ALIGNMENT);
+        m_storage_alignment = std::max(properties.limits.minStorageBufferOffsetAlignment, DEFAULT_ALIGNMENT);
+
+        add_block(p_block_size);
+    }
+
+    void FrameAllocator::cleanup()
+    {
+        std::ranges::for_each(m_blocks, [](const std::unique_ptr<Buffer>& p_block)
+        {
+            p_block->cleanup();
+        });
+        m_blocks.clear();
+        m_offset = 0;
+        m_used_in_full_blocks = 0;
+    }
+
+    void FrameAllocator::reset()
+    {
+        if (m_blocks.size() > 1)
+        {
+            //the whole previous frame fits in one block from now on
+            VkDeviceSize total_size{ 0 };
+            std::ranges::for_each(m_blocks, [&total_size](const std::unique_ptr<Buffer>& p_block)
+            {
+                total_size += p_block->get_size();
+            });
+
+            cleanup();
+            add_block(total_size);
+            VI_CORE_INFO("Frame allocator grown to {} KiB", total_size / 1024);
+        }
+
+        m_offset = 0;
+        m_used_in_full_blocks = 0;
+    }
+
+    void FrameAllocator::flush()
+    {
+        for (size_t i = 0; i < m_blocks.size(); ++i)
+        {
+            const auto is_last = i + 1 == m_blocks.size();
+            const auto size = is_last ? m_offset : VK_WHOLE_SIZE;
+            if (size == 0)
+            {
+                continue;
+            }
+
+            //a no-op on host coherent memory
+            if (const auto result = vmaFlushAllocation(m_allocator, m_blocks[i]->get_allocated_buffer().allocation, 0, size); result != VK_SUCCESS)
+            {
+                throw std::runtime_error(std::format("Cannot flush frame allocator: {}", string_VkResult(result)));
+            }
+        }
+    }
+
+    FrameAllocation FrameAllocator::allocate(const VkDeviceSize p_size, const VkDeviceSize p_alignment)
+    {
+        auto offset = align_up(m_offset, p_alignment);
+        if (offset + p_size > m_blocks.back()->get_size())
+        {
+            m_used_in_full_blocks += m_offset;
+            //keeps chained blocks rare even when the frame keeps growing
+            add_block(std::max(m_blocks.back()->get_size() * 2, align_up(p_size, DEFAULT_BLOCK_SIZE)));
+            offset = 0;
+            VI_CORE_WARN("Frame allocator ran out of space, chaining a block of {} KiB", m_blocks.back()->get_size() / 1024);
+        }
+
+        m_offset = offset + p_size;
+
+        const auto& block = *m_blocks.back();
+        FrameAllocation allocation{};
+        allocation.buffer = block.get_buffer();
+        allocation.offset = offset;
+        allocation.size = p_size;
+        allocation.data = static_cast<std::byte*>(block.get_mapped_data()) + offset;
+        allocation.address = block.get_device_address() + offset;
+        return allocation;
+    }
+
+    FrameAllocation FrameAllocator::allocate_uniform(const VkDeviceSize p_size)
+    {
+        return allocate(p_size, m_uniform_alignment);
+    }
+
+    FrameAllocation FrameAllocator::allocate_storage(const VkDeviceSize p_size)
+    {
+        return allocate(p_size, m_storage_alignment);
+    }
+
+    VkDeviceSize FrameAllocator::get_used() const
+    {
+        return m_used_in_full_blocks + m_offset;
+    }
+
+    void FrameAllocator::add_block(const VkDeviceSize p_size)
+    {
+        //written sequentially by the CPU, VMA picks device local host visible memory when there is some
+        m_blocks.push_back(std::make_unique<Buffer>(p_size, FRAME_BUFFER_USAGE, VMA_MEMORY_USAGE_AUTO, m_allocator, m_device,
+            VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT));
+        m_offset = 0;
+    }
+}
@@ -0,0 +1,80 @@
+#ifndef VULKAN_FRAME_ALLOCATOR_HPP
+#define VULKAN_FRAME_ALLOCATOR_HPP
+
+#include <vulkan/vulkan.hpp>
+
+#include <vk_mem_alloc.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace vulkan
+{
+    class Buffer;
+
+    //Sub-allocation living until the frame that made it comes around again
+    struct FrameAllocation
+    {
+        VkBuffer buffer{};
+        //offset into buffer, passed as the dynamic offset of a *_DYNAMIC descriptor
+        VkDeviceSize offset{};
+        VkDeviceSize size{};
+        std::byte* data{};
+        //address of the first byte, for shaders reading through buffer references
+        VkDeviceAddress address{};
+    };
+
+    //Linear allocator over persistently mapped buffers for data written once per frame: uniforms,
+    //push constants that do not fit, dynamic vertices... Allocating is a bump of an offset, everything is
+    //released at once by reset when the frame's previous submission has completed.
+    //When a frame needs more than the buffer holds another one is chained, and the next reset
+    //replaces them with a single buffer large enough for the whole frame
+    class FrameAllocator
+    {
+    public:
+        static constexpr VkDeviceSize DEFAULT_BLOCK_SIZE{ 4ull * 1024 * 1024 };
+        static constexpr VkDeviceSize DEFAULT_ALIGNMENT{ 16 };
+
+        void init(VkPhysicalDevice p_physical_device, VkDevice p_device, VmaAllocator p_allocator, VkDeviceSize p_block_size = DEFAULT_BLOCK_SIZE);
+        void cleanup();
+
+        //Nothing the GPU still reads may have been allocated since the previous reset
+        void reset();
+        //Makes the writes visible to the device when the memory is not host coherent, call before submitting
+        void flush();
+
+        //p_alignment has to be a power of two
+        [[nodiscard]] FrameAllocation allocate(VkDeviceSize p_size, VkDeviceSize p_alignment = DEFAULT_ALIGNMENT);
+        [[nodiscard]] FrameAllocation allocate_uniform(VkDeviceSize p_size);
+        [[nodiscard]] FrameAllocation allocate_storage(VkDeviceSize p_size);
+
+        template<typename T>
+        [[nodiscard]] FrameAllocation push_uniform(const T& p_data)
+        {
+            const auto allocation = allocate_uniform(sizeof(T));
+            std::memcpy(allocation.data, &p_data, sizeof(T));
+            return allocation;
+        }
+
+        //Bytes handed out since the last reset, alignment padding included
+        [[nodiscard]] VkDeviceSize get_used() const;
+
+    private:
+        void add_block(VkDeviceSize p_size);
+
+        VkDevice m_device{};
+        VmaAllocator m_allocator{};
+        VkDeviceSize m_uniform_alignment{};
+        VkDeviceSize m_storage_alignment{};
+
+        std::vector<std::unique_ptr<Buffer>> m_blocks{};
+        //offset in the last block, the earlier ones are full
+        VkDeviceSize m_offset{};
+        VkDeviceSize m_used_in_full_blocks{};
+    };
+}
+
+#endif // VULKAN_FRAME_ALLOCATOR_HPP
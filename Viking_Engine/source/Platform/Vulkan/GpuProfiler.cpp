@@ -0,0 +1,168 @@
+#include "Platform/Vulkan/GpuProfiler.hpp"
+
+#include "Viking/core/Log.hpp"
+
+#include <vulkan/vk_enum_string_helper.h>
+
+#include <format>
+#include <stdexcept>
+
+namespace
+{
+    //two timestamps per scope
+    constexpr uint32_t MAX_SCOPES_PER_FRAME{ 64 };
+    constexpr uint32_t QUERIES_PER_FRAME{ MAX_SCOPES_PER_FRAME * 2 };
+
+    //an invalid scope index, returned when profiling is unsupported or the frame ran out of queries
+    constexpr uint32_t NO_SCOPE{ MAX_SCOPES_PER_FRAME };
+}
+
+namespace vulkan
+{
+    void GpuProfiler::init(const VkPhysicalDevice p_physical_device, const VkDevice p_device, const uint32_t p_queue_family, const uint32_t p_frame_count)
+    {
+        m_device = p_device;
+
+        VkPhysicalDeviceProperties properties{};
+        vkGetPhysicalDeviceProperties(p_physical_device, &properties);
+
+        uint32_t family_count{};
+        vkGetPhysicalDeviceQueueFamilyProperties(p_physical_device, &family_count, nullptr);
+        std::vector<VkQueueFamilyProperties> families(family_count);
+        vkGetPhysicalDeviceQueueFamilyProperties(p_physical_device, &family_count, families.data());
+
+        const auto valid_bits = families.at(p_queue_family).timestampValidBits;
+        m_supported = valid_bits > 0 && properties.limits.timestampPeriod > 0.f;
+        if (!m_supported)
+        {
+            VI_CORE_WARN("Timestamp queries are not supported on this queue, GPU profiling is disabled");
+            return;
+        }
+
+        m_valid_mask = valid_bits >= 64 ? ~0ull : (1ull << valid_bits) - 1;
+        //timestampPeriod is the number of nanoseconds per tick
+        m_period_ms = static_cast<double>(properties.limits.timestampPeriod) / 1000000.0;
+
+        VkQueryPoolCreateInfo pool_info{};
+        pool_info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        pool_info.pNext = nullptr;
+        pool_info.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        pool_info.queryCount = QUERIES_PER_FRAME;
+
+        m_frames.resize(p_frame_count);
+        for (auto& frame : m_frames)
+        {
+            if (const auto result = vkCreateQueryPool(m_device, &pool_info, nullptr, &frame.m_pool); result != VK_SUCCESS)
+            {
+                throw std::runtime_error(std::format("Cannot create timestamp query pool: {}", string_VkResult(result)));
+            }
+
+            //queries have to be reset before their first use
+            vkResetQueryPool(m_device, frame.m_pool, 0, QUERIES_PER_FRAME);
+        }
+    }
+
+    void GpuProfiler::cleanup()
+    {
+        for (const auto& frame : m_frames)
+        {
+            vkDestroyQueryPool(m_device, frame.m_pool, nullptr);
+        }
+        m_frames.clear();
+        m_current = nullptr;
+    }
+
+    bool GpuProfiler::begin_frame(const uint32_t p_frame_index)
+    {
+        if (!m_supported)
+        {
+            return false;
+        }
+
+        auto& frame = m_frames.at(p_frame_index);
+        m_current = &frame;
+        m_depth = 0;
+
+        if (frame.m_scopes.empty())
+        {
+            return false;
+        }
+
+        //value and availability for each query, nothing waits: a query that is not ready drops the frame's timings
+        const auto query_count = static_cast<uint32_t>(frame.m_scopes.size() * 2);
+        std::vector<uint64_t> results(query_count * 2);
+        const auto result = vkGetQueryPoolResults(m_device, frame.m_pool, 0, query_count, results.size() * sizeof(uint64_t), results.data(),
+            sizeof(uint64_t) * 2, VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+
+        bool collected{ false };
+        if (result == VK_SUCCESS || result == VK_NOT_READY)
+        {
+            std::vector<vi::GpuTiming> timings;
+            timings.reserve(frame.m_scopes.size());
+
+            bool available{ true };
+            for (uint32_t scope = 0; scope < frame.m_scopes.size() && available; ++scope)
+            {
+                const auto begin_index = scope * 4;
+                const auto end_index = begin_index + 2;
+                available = frame.m_scopes[scope].m_closed && results[begin_index + 1] != 0 && results[end_index + 1] != 0;
+
+                const auto begin = results[begin_index] & m_valid_mask;
+                const auto end = results[end_index] & m_valid_mask;
+                const auto ticks = (end - begin) & m_valid_mask;
+
+                timings.push_back({ frame.m_scopes[scope].m_name, static_cast<double>(ticks) * m_period_ms, frame.m_scopes[scope].m_depth });
+            }
+
+            if (available)
+            {
+                m_timings = std::move(timings);
+                collected = true;
+            }
+        }
+        else
+        {
+            VI_CORE_WARN("Cannot read timestamp queries: {}", string_VkResult(result));
+        }
+
+        //the submission is complete, so the queries can be reset from the host
+        vkResetQueryPool(m_device, frame.m_pool, 0, query_count);
+        frame.m_scopes.clear();
+        return collected;
+    }
+
+    uint32_t GpuProfiler::begin_scope(const VkCommandBuffer p_cmd, const std::string_view p_name)
+    {
+        if (!m_supported || m_current == nullptr || m_current->m_scopes.size() >= MAX_SCOPES_PER_FRAME)
+        {
+            return NO_SCOPE;
+        }
+
+        const auto scope = static_cast<uint32_t>(m_current->m_scopes.size());
+        m_current->m_scopes.push_back({ .m_name = std::string{ p_name }, .m_depth = m_depth++ });
+
+        //written once all previous commands are done, so consecutive scopes do not overlap
+        vkCmdWriteTimestamp2(p_cmd, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, m_current->m_pool, scope * 2);
+        return scope;
+    }
+
+    void GpuProfiler::end_scope(const VkCommandBuffer p_cmd, const uint32_t p_scope)
+    {
+        if (p_scope == NO_SCOPE || m_current == nullptr)
+        {
+            return;
+        }
+
+        vkCmdWriteTimestamp2(p_cmd, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, m_current->m_pool, p_scope * 2 + 1);
+        m_current->m_scopes.at(p_scope).m_closed = true;
+        --m_depth;
+    }
+
+    void GpuProfiler::log_timings() const
+    {
+        for (const auto& [name, milliseconds, depth] : m_timings)
+        {
+            VI_CORE_TRACE("[GPU] {:>{}}{}: {:.3f} ms", "", depth * 2, name, milliseconds);
+        }
+    }
+}
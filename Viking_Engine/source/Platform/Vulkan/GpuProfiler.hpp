@@ -0,0 +1,81 @@
+#ifndef VULKAN_GPU_PROFILER_HPP
+#define VULKAN_GPU_PROFILER_HPP
+
+#include "Viking/renderer/Renderer.hpp"
+
+#include <vulkan/vulkan.hpp>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace vulkan
+{
+    //Timestamp queries around GPU work, with one query pool per frame in flight.
+    //A frame slot is read back when it comes around again, after the CPU waited for its submission,
+    //so collecting the results never stalls
+    class GpuProfiler
+    {
+    public:
+        void init(VkPhysicalDevice p_physical_device, VkDevice p_device, uint32_t p_queue_family, uint32_t p_frame_count);
+        void cleanup();
+
+        //Collects the timings last recorded in this slot and resets its queries.
+        //The submission that used the slot has to be complete. Returns false when get_timings still holds an older frame
+        bool begin_frame(uint32_t p_frame_index);
+
+        [[nodiscard]] uint32_t begin_scope(VkCommandBuffer p_cmd, std::string_view p_name);
+        void end_scope(VkCommandBuffer p_cmd, uint32_t p_scope);
+
+        //Timings of the most recent frame whose results were available, in the order the scopes began
+        [[nodiscard]] const std::vector<vi::GpuTiming>& get_timings() const { return m_timings; }
+        void log_timings() const;
+
+        [[nodiscard]] bool is_supported() const { return m_supported; }
+
+    private:
+        struct Scope
+        {
+            std::string m_name{};
+            uint32_t m_depth{};
+            bool m_closed{ false };
+        };
+
+        struct FrameQueries
+        {
+            VkQueryPool m_pool{};
+            std::vector<Scope> m_scopes{};
+        };
+
+        VkDevice m_device{};
+        bool m_supported{ false };
+        double m_period_ms{};
+        uint64_t m_valid_mask{};
+
+        std::vector<FrameQueries> m_frames{};
+        FrameQueries* m_current{};
+        uint32_t m_depth{};
+
+        std::vector<vi::GpuTiming> m_timings{};
+    };
+
+    //Measures the commands recorded during its lifetime
+    class GpuScope
+    {
+    public:
+        GpuScope(GpuProfiler& p_profiler, const VkCommandBuffer p_cmd, const std::string_view p_name):
+            m_profiler{ p_profiler }, m_cmd{ p_cmd }, m_scope{ p_profiler.begin_scope(p_cmd, p_name) } {}
+        ~GpuScope() { m_profiler.end_scope(m_cmd, m_scope); }
+
+        GpuScope(const GpuScope&) = delete;
+        GpuScope& operator=(const GpuScope&) = delete;
+
+    private:
+        GpuProfiler& m_profiler;
+        VkCommandBuffer m_cmd{};
+        uint32_t m_scope{};
+    };
+}
+
+#endif // VULKAN_GPU_PROFILER_HPP
@@ -1,8 +1,13 @@
 #include "Platform/Vulkan/Image.hpp"
 
-namespace 
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+#include <vector>
+
+namespace vulkan
 {
-    VkImageCreateInfo image_create_info(const VkFormat p_format, const VkImageUsageFlags p_usage_flags, const VkExtent3D p_extent)
+    VkImageCreateInfo image_create_info(const VkFormat p_format, const VkImageUsageFlags p_usage_flags, const VkExtent3D p_extent, const uint32_t p_mip_levels)
     {
         VkImageCreateInfo info{};
         info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
@@ -13,7 +18,7 @@ namespace
         info.format = p_format;
         info.extent = p_extent;
 
-        info.mipLevels = 1;
+        info.mipLevels = p_mip_levels;
         info.arrayLayers = 1;
 
         //for MSAA. we will not be using it by default, so default it to 1 sample per pixel.
@@ -26,7 +31,7 @@ namespace
         return info;
     }
 
-    VkImageViewCreateInfo imageview_create_info(const VkFormat p_format, const VkImage p_image, const VkImageAspectFlags p_aspect_flags)
+    VkImageViewCreateInfo imageview_create_info(const VkFormat p_format, const VkImage p_image, const VkImageAspectFlags p_aspect_flags, const uint32_t p_mip_levels)
     {
         // build an image-view for the depth image to use for rendering
         VkImageViewCreateInfo info{};
@@ -37,23 +42,26 @@ namespace
         info.image = p_image;
         info.format = p_format;
         info.subresourceRange.baseMipLevel = 0;
-        info.subresourceRange.levelCount = 1;
+        info.subresourceRange.levelCount = p_mip_levels;
         info.subresourceRange.baseArrayLayer = 0;
         info.subresourceRange.layerCount = 1;
         info.subresourceRange.aspectMask = p_aspect_flags;
 
         return info;
     }
-}
 
-namespace vulkan
-{
-    Image::Image(const VkExtent3D p_extent, const VkFormat p_format, const VkImageUsageFlags p_usage_flags, const VmaAllocator p_allocator, const VkDevice p_device, vi::DeletionQueue& p_deletion_queue): m_device{p_device}, m_allocator{p_allocator}
+    uint32_t mip_level_count(const VkExtent3D p_extent)
+    {
+        return static_cast<uint32_t>(std::bit_width(std::max(p_extent.width, p_extent.height)));
+    }
+
+    Image::Image(const VkExtent3D p_extent, const VkFormat p_format, const VkImageUsageFlags p_usage_flags, const VmaAllocator p_allocator, const VkDevice p_device, const uint32_t p_mip_levels): m_device{p_device}, m_allocator{p_allocator}
     {
         m_image.image_format = p_format;
         m_image.image_extent = p_extent;
+        m_image.mip_levels = p_mip_levels;
 
-        const auto image_info = image_create_info(p_format, p_usage_flags, p_extent);
+        const auto image_info = image_create_info(p_format, p_usage_flags, p_extent, p_mip_levels);
 
         //for the draw image, we want to allocate it from gpu local memory
         VmaAllocationCreateInfo image_alloc_info{};
@@ -63,18 +71,20 @@ namespace vulkan
         //allocate and create the image
         vmaCreateImage(p_allocator, &image_info, &image_alloc_info, &m_image.image, &m_image.allocation, nullptr);
 
-        const auto view_info = imageview_create_info(p_format, m_image.image, VK_IMAGE_ASPECT_COLOR_BIT);
+        const auto view_info = imageview_create_info(p_format, m_image.image, aspect_from_format(p_format), p_mip_levels);
 
         if (const auto result = vkCreateImageView(p_device, &view_info, nullptr, &m_image.image_view); result != VK_SUCCESS)
         {
             throw std::runtime_error("Cannot create image view");
         }
+    }
 
-        p_deletion_queue.push_function([this]()
-        {
-            vkDestroyImageView(m_device, m_image.image_view, nullptr);
-            vmaDestroyImage(m_allocator, m_image.image, m_image.allocation);
-        });
+    void Image::cleanup()
+    {
+        vkDestroyImageView(m_device, m_image.image_view, nullptr);
+        vmaDestroyImage(m_allocator, m_image.image, m_image.allocation);
+        m_image = {};
+        m_state = {};
     }
 
     void copy_image_to_image(const VkCommandBuffer p_command, const VkImage p_source, const VkImage p_destination, const VkExtent2D p_source_size, const VkExtent2D
@@ -111,4 +121,85 @@ namespace vulkan
 
         vkCmdBlitImage2(p_command, &blit_info);
     }
+
+    void generate_mipmaps(const VkCommandBuffer p_command, Image& p_image, const ImageUsage p_final_usage)
+    {
+        const auto image = p_image.get_allocated_image();
+        const auto final_state = image_state(p_final_usage);
+
+        VkImageMemoryBarrier2 barrier{ .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2, .pNext = nullptr };
+        barrier.image = image.image;
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.levelCount = 1;
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount = 1;
+
+        VkDependencyInfo dependency{ .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO, .pNext = nullptr };
+        dependency.imageMemoryBarrierCount = 1;
+        dependency.pImageMemoryBarriers = &barrier;
+
+        auto width = static_cast<int32_t>(image.image_extent.width);
+        auto height = static_cast<int32_t>(image.image_extent.height);
+        for (uint32_t level = 1; level < image.mip_levels; ++level)
+        {
+            //the previous level is complete, it becomes the source of this one
+            barrier.subresourceRange.baseMipLevel = level - 1;
+            barrier.srcStageMask = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT;
+            barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+            barrier.dstStageMask = VK_PIPELINE_STAGE_2_BLIT_BIT;
+            barrier.dstAccessMask = VK_ACCESS_2_TRANSFER_READ_BIT;
+            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            vkCmdPipelineBarrier2(p_command, &dependency);
+
+            const auto next_width = std::max(width / 2, 1);
+            const auto next_height = std::max(height / 2, 1);
+
+            VkImageBlit2 blit_region{ .sType = VK_STRUCTURE_TYPE_IMAGE_BLIT_2, .pNext = nullptr };
+            blit_region.srcOffsets[1] = { width, height, 1 };
+            blit_region.dstOffsets[1] = { next_width, next_height, 1 };
+            blit_region.srcSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, level - 1, 0, 1 };
+            blit_region.dstSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, level, 0, 1 };
+
+            VkBlitImageInfo2 blit_info{ .sType = VK_STRUCTURE_TYPE_BLIT_IMAGE_INFO_2, .pNext = nullptr };
+            blit_info.srcImage = image.image;
+            blit_info.srcImageLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            blit_info.dstImage = image.image;
+            blit_info.dstImageLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            blit_info.filter = VK_FILTER_LINEAR;
+            blit_info.regionCount = 1;
+            blit_info.pRegions = &blit_region;
+            vkCmdBlitImage2(p_command, &blit_info);
+
+            width = next_width;
+            height = next_height;
+        }
+
+        //every level but the last was read as a blit source, the last one was only written
+        std::vector<VkImageMemoryBarrier2> final_barriers;
+        barrier.dstStageMask = final_state.stage;
+        barrier.dstAccessMask = final_state.access;
+        barrier.newLayout = final_state.layout;
+        if (image.mip_levels > 1)
+        {
+            barrier.subresourceRange.baseMipLevel = 0;
+            barrier.subresourceRange.levelCount = image.mip_levels - 1;
+            barrier.srcStageMask = VK_PIPELINE_STAGE_2_BLIT_BIT;
+            barrier.srcAccessMask = VK_ACCESS_2_NONE;
+            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            final_barriers.push_back(barrier);
+        }
+        barrier.subresourceRange.baseMipLevel = image.mip_levels - 1;
+        barrier.subresourceRange.levelCount = 1;
+        barrier.srcStageMask = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT;
+        barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        final_barriers.push_back(barrier);
+
+        dependency.imageMemoryBarrierCount = static_cast<uint32_t>(final_barriers.size());
+        dependency.pImageMemoryBarriers = final_barriers.data();
+        vkCmdPipelineBarrier2(p_command, &dependency);
+
+        p_image.get_state() = final_state;
+    }
 }
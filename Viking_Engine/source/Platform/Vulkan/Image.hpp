@@ -1,11 +1,11 @@
 #pragma once
 
+#include "Platform/Vulkan/Barrier.hpp"
+
 #include <vulkan/vulkan.hpp>
 
 #include <vk_mem_alloc.h>
 
-#include "Viking/core/DeletionQueue.hpp"
-
 namespace vulkan
 {
     struct AllocatedImage
@@ -15,22 +15,38 @@ namespace vulkan
         VmaAllocation allocation;
         VkExtent3D image_extent;
         VkFormat image_format;
+        uint32_t mip_levels;
     };
 
+    [[nodiscard]] VkImageCreateInfo image_create_info(VkFormat p_format, VkImageUsageFlags p_usage_flags, VkExtent3D p_extent, uint32_t p_mip_levels = 1);
+    [[nodiscard]] VkImageViewCreateInfo imageview_create_info(VkFormat p_format, VkImage p_image, VkImageAspectFlags p_aspect_flags, uint32_t p_mip_levels = 1);
+    //Levels of a full mip chain down to 1x1
+    [[nodiscard]] uint32_t mip_level_count(VkExtent3D p_extent);
+
     class Image
     {
     public:
-        Image(VkExtent3D p_extent, VkFormat p_format, VkImageUsageFlags p_usage_flags, VmaAllocator p_allocator, VkDevice p_device, vi::DeletionQueue& p_deletion_queue);
+        Image(VkExtent3D p_extent, VkFormat p_format, VkImageUsageFlags p_usage_flags, VmaAllocator p_allocator, VkDevice p_device, uint32_t p_mip_levels = 1);
+
+        void cleanup();
 
         VkImage get_image() { return m_image.image; }
         AllocatedImage get_allocated_image() { return m_image; }
 
+        //Layout and last access of the image as recorded so far, kept up to date by BarrierBatch
+        ImageState& get_state() { return m_state; }
+
     private:
         VkDevice m_device{};
         VmaAllocator m_allocator{};
         AllocatedImage m_image{};
+        ImageState m_state{};
     };
 
     void copy_image_to_image(VkCommandBuffer p_command, VkImage p_source, VkImage p_destination, VkExtent2D p_source_size, VkExtent2D
                              p_destination_size);
+
+    //Fills every level below mip 0 by blitting each one from the previous, on a queue that supports blits.
+    //The whole image has to be in TRANSFER_DST_OPTIMAL with mip 0 written, it is left in p_final_usage
+    void generate_mipmaps(VkCommandBuffer p_command, Image& p_image, ImageUsage p_final_usage);
 }
@@ -0,0 +1,148 @@
+#include "Platform/Vulkan/MeshPool.hpp"
+
+#include "Platform/Vulkan/Buffer.hpp"
+#include "Platform/Vulkan/UploadEngine.hpp"
+#include "Viking/core/Log.hpp"
+
+#include <algorithm>
+#include <format>
+#include <stdexcept>
+
+namespace
+{
+    constexpr VkDeviceSize align_up(const VkDeviceSize p_value, const VkDeviceSize p_alignment)
+    {
+        return (p_value + p_alignment - 1) / p_alignment * p_alignment;
+    }
+
+    //Centered on the bounding box, not minimal but good enough for culling
+    glm::vec4 bounding_sphere(const std::span<const vi::Vertex> p_vertices)
+    {
+        if (p_vertices.empty())
+        {
+            return {};
+        }
+
+        glm::vec3 min{ p_vertices.front().Position };
+        glm::vec3 max{ p_vertices.front().Position };
+        for (const auto& vertex : p_vertices)
+        {
+            min = glm::min(min, vertex.Position);
+            max = glm::max(max, vertex.Position);
+        }
+
+        const auto center = (min + max) * 0.5f;
+        float radius{ 0.0f };
+        for (const auto& vertex : p_vertices)
+        {
+            radius = std::max(radius, glm::distance(center, vertex.Position));
+        }
+
+        return { center, radius };
+    }
+}
+
+namespace vulkan
+{
+    void MeshPool::init(const VkDevice p_device, const VmaAllocator p_allocator, UploadEngine& p_upload_engine, const std::span<const uint32_t> p_queue_families, const VkDeviceSize p_capacity)
+    {
+        m_upload_engine = &p_upload_engine;
+
+        m_buffer = std::make_unique<Buffer>(p_capacity, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT |
+            VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT, VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE, p_allocator, p_device, 0, p_queue_families);
+        m_used = 0;
+        m_meshes = std::make_shared<const std::vector<GpuMesh>>();
+
+        VI_CORE_INFO("Mesh pool of {} MiB", p_capacity / (1024 * 1024));
+    }
+
+    void MeshPool::cleanup()
+    {
+        m_buffer->cleanup();
+        m_buffer.reset();
+        m_meshes.reset();
+    }
+
+    vi::MeshHandle MeshPool::add_mesh(const std::span<const vi::Vertex> p_vertices, const std::span<const uint32_t> p_indices, const std::span<const vi::MeshLod> p_lods)
+    {
+        if (p_lods.size() > vi::MAX_MESH_LODS)
+        {
+            throw std::runtime_error(std::format("A mesh can have at most {} LODs, got {}", vi::MAX_MESH_LODS, p_lods.size()));
+        }
+        for (const auto& lod : p_lods)
+        {
+            if (lod.FirstIndex > p_indices.size() || lod.IndexCount > p_indices.size() - lod.FirstIndex)
+            {
+                throw std::runtime_error(std::format("LOD indices {}..{} are past the {} indices of the mesh", lod.FirstIndex, lod.FirstIndex + lod.IndexCount, p_indices.size()));
+            }
+        }
+
+        std::scoped_lock lock{ m_mutex };
+
+        //vertex_offset counts whole vertices from the start of the buffer, and firstIndex whole indices
+        const auto vertex_start = align_up(m_used, sizeof(vi::Vertex));
+        const auto index_start = align_up(vertex_start + p_vertices.size_bytes(), sizeof(uint32_t));
+        const auto end = index_start + p_indices.size_bytes();
+        if (end > m_buffer->get_size())
+        {
+            throw std::runtime_error(std::format("Mesh pool is full: {} bytes needed, {} of {} used", end - m_used, m_used, m_buffer->get_size()));
+        }
+
+        m_upload_engine->upload(*m_buffer, std::as_bytes(p_vertices), BufferUsage::VertexRead, vertex_start);
+        m_upload_engine->upload(*m_buffer, std::as_bytes(p_indices), BufferUsage::IndexRead, index_start);
+        m_used = end;
+
+        GpuMesh mesh{
+            .vertex_offset = static_cast<int32_t>(vertex_start / sizeof(vi::Vertex)),
+            .vertex_count = static_cast<uint32_t>(p_vertices.size()),
+            .bounds = bounding_sphere(p_vertices)
+        };
+
+        const auto first_index = static_cast<uint32_t>(index_start / sizeof(uint32_t));
+        if (p_lods.empty())
+        {
+            mesh.lods[0] = { first_index, static_cast<uint32_t>(p_indices.size()), 0.0f };
+            mesh.lod_count = 1;
+        }
+        else
+        {
+            for (const auto& lod : p_lods)
+            {
+                mesh.lods[mesh.lod_count++] = { first_index + lod.FirstIndex, lod.IndexCount, lod.Error };
+            }
+        }
+
+        auto meshes = std::make_shared<std::vector<GpuMesh>>(*m_meshes);
+        meshes->push_back(mesh);
+        m_meshes = std::move(meshes);
+
+        return { static_cast<uint32_t>(m_meshes->size() - 1) };
+    }
+
+    GpuMesh MeshPool::get_mesh(const vi::MeshHandle p_mesh) const
+    {
+        std::scoped_lock lock{ m_mutex };
+        return m_meshes->at(p_mesh.Id);
+    }
+
+    std::shared_ptr<const std::vector<GpuMesh>> MeshPool::get_meshes() const
+    {
+        std::scoped_lock lock{ m_mutex };
+        return m_meshes;
+    }
+
+    void MeshPool::bind_index_buffer(const VkCommandBuffer p_cmd) const
+    {
+        vkCmdBindIndexBuffer(p_cmd, m_buffer->get_buffer(), 0, VK_INDEX_TYPE_UINT32);
+    }
+
+    VkDeviceAddress MeshPool::get_vertex_address() const
+    {
+        return m_buffer->get_device_address();
+    }
+
+    VkBuffer MeshPool::get_buffer() const
+    {
+        return m_buffer->get_buffer();
+    }
+}
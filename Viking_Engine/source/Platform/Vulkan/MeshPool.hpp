@@ -0,0 +1,80 @@
+#ifndef VULKAN_MESH_POOL_HPP
+#define VULKAN_MESH_POOL_HPP
+
+#include "Viking/renderer/Mesh.hpp"
+
+#include <vulkan/vulkan.hpp>
+
+#include <vk_mem_alloc.h>
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+
+namespace vulkan
+{
+    class Buffer;
+    class UploadEngine;
+
+    //Index range of one level of detail, first_index counts from the start of the pool
+    struct GpuLod
+    {
+        uint32_t first_index{};
+        uint32_t index_count{};
+        float error{};
+    };
+
+    //Where a mesh lives in the pool, ready for vkCmdDrawIndexed
+    struct GpuMesh
+    {
+        //LOD 0 is the full mesh
+        std::array<GpuLod, vi::MAX_MESH_LODS> lods{};
+        uint32_t lod_count{};
+        //added to every index, so the indices of a mesh stay relative to its own vertices
+        int32_t vertex_offset{};
+        uint32_t vertex_count{};
+        //bounding sphere in mesh space, center in xyz and radius in w
+        glm::vec4 bounds{};
+    };
+
+    //One device-local buffer holding the vertices and indices of every mesh. Shaders read the vertices
+    //through the buffer's device address, so drawing needs no vertex input state and a single index buffer bind.
+    //The buffer is shared concurrently with the transfer queue, meshes are added while others are drawn.
+    //Space is never given back, meshes live as long as the pool
+    class MeshPool
+    {
+    public:
+        static constexpr VkDeviceSize DEFAULT_CAPACITY{ 256ull * 1024 * 1024 };
+
+        void init(VkDevice p_device, VmaAllocator p_allocator, UploadEngine& p_upload_engine, std::span<const uint32_t> p_queue_families, VkDeviceSize p_capacity = DEFAULT_CAPACITY);
+        void cleanup();
+
+        //The data is uploaded through the upload engine, frames beginning after the call can draw the mesh.
+        //Without p_lods every index belongs to LOD 0
+        [[nodiscard]] vi::MeshHandle add_mesh(std::span<const vi::Vertex> p_vertices, std::span<const uint32_t> p_indices, std::span<const vi::MeshLod> p_lods = {});
+        [[nodiscard]] GpuMesh get_mesh(vi::MeshHandle p_mesh) const;
+        //Every mesh added so far, indexed by handle. The snapshot stays valid while meshes are added
+        [[nodiscard]] std::shared_ptr<const std::vector<GpuMesh>> get_meshes() const;
+
+        void bind_index_buffer(VkCommandBuffer p_cmd) const;
+        //Address of vertex 0, every vertex_offset is relative to it
+        [[nodiscard]] VkDeviceAddress get_vertex_address() const;
+        [[nodiscard]] VkBuffer get_buffer() const;
+
+    private:
+        UploadEngine* m_upload_engine{};
+        std::unique_ptr<Buffer> m_buffer{};
+        VkDeviceSize m_used{};
+        //copied on write, readers take a snapshot once instead of locking for every mesh
+        std::shared_ptr<const std::vector<GpuMesh>> m_meshes{};
+
+        mutable std::mutex m_mutex{};
+    };
+}
+
+#endif // VULKAN_MESH_POOL_HPP
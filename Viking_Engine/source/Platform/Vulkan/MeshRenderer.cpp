@@ -0,0 +1,300 @@
+#include "Platform/Vulkan/MeshRenderer.hpp"
+
+#include "Platform/Vulkan/Buffer.hpp"
+#include "Platform/Vulkan/FrameAllocator.hpp"
+#include "Platform/Vulkan/Shader.hpp"
+#include "Viking/core/Log.hpp"
+#include "Viking/core/Profiler.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+
+namespace
+{
+    constexpr uint32_t CULL_GROUP_SIZE{ 64 };
+
+    //std430 layout of Lod and Object in mesh.vert and cull.comp
+    struct LodData
+    {
+        uint32_t m_first_index{};
+        uint32_t m_index_count{};
+        float m_error{};
+        uint32_t m_padding{};
+    };
+
+    struct ObjectData
+    {
+        glm::mat4 m_transform{};
+        //std430 mat3, every column padded to a vec4
+        std::array<glm::vec4, 3> m_normal_matrix{};
+        glm::vec4 m_bounds{};
+        int32_t m_vertex_offset{};
+        uint32_t m_lod_count{};
+        std::array<uint32_t, 2> m_padding{};
+        std::array<LodData, vi::MAX_MESH_LODS> m_lods{};
+    };
+
+    static_assert(sizeof(ObjectData) == 208, "ObjectData has to match the std430 layout of the shaders");
+
+    struct MeshConstants
+    {
+        glm::mat4 m_view_projection{};
+        VkDeviceAddress m_vertex_buffer{};
+        VkDeviceAddress m_object_buffer{};
+    };
+
+    struct CullConstants
+    {
+        std::array<glm::vec4, 6> m_frustum_planes{};
+        VkDeviceAddress m_object_buffer{};
+        VkDeviceAddress m_draw_buffer{};
+        VkDeviceAddress m_count_buffer{};
+        uint32_t m_object_count{};
+        //pixels a mesh unit covers at distance 1, divided by the LOD threshold
+        float m_lod_scale{};
+    };
+
+    static_assert(sizeof(MeshConstants) <= 128 && sizeof(CullConstants) <= 128, "Push constants have to fit the guaranteed 128 bytes");
+
+    //Planes of the clip volume -w <= x, y <= w and 0 <= z <= w, pointing inwards and normalized. A degenerate plane culls nothing
+    std::array<glm::vec4, 6> frustum_planes(const glm::mat4& p_view_projection)
+    {
+        const auto matrix = glm::transpose(p_view_projection);
+        std::array planes{
+            matrix[3] + matrix[0],
+            matrix[3] - matrix[0],
+            matrix[3] + matrix[1],
+            matrix[3] - matrix[1],
+            matrix[2],
+            matrix[3] - matrix[2]
+        };
+
+        for (auto& plane : planes)
+        {
+            //the far plane of an infinite reversed-depth projection is (0, 0, 0, near),
+            //it is replaced by a plane every point is inside of instead of being divided by zero
+            const auto length = glm::length(glm::vec3{ plane });
+            plane = length > 0.0f ? plane / length : glm::vec4{ 0.0f, 0.0f, 0.0f, 1.0f };
+        }
+
+        return planes;
+    }
+}
+
+namespace vulkan
+{
+    void MeshRenderer::init(const VkDevice p_device, const VmaAllocator p_allocator, UploadEngine& p_upload_engine, ShaderCache& p_shader_cache, const VkPipelineCache p_pipeline_cache,
+        const std::span<const uint32_t> p_queue_families, const VkFormat p_color_format)
+    {
+        m_device = p_device;
+        m_allocator = p_allocator;
+
+        m_mesh_pool.init(p_device, p_allocator, p_upload_engine, p_queue_families);
+
+        const auto shader_directory = get_shader_directory();
+        m_pipeline.init(p_device, {
+            .vertex_shader = p_shader_cache.get_module(shader_directory / "mesh.vert.spv"),
+            .fragment_shader = p_shader_cache.get_module(shader_directory / "mesh.frag.spv"),
+            .push_constant_size = sizeof(MeshConstants),
+            .color_formats = { p_color_format },
+            .depth_format = DEPTH_FORMAT
+        }, p_pipeline_cache);
+
+        m_cull_pipeline.init(p_device, {
+            .shader = p_shader_cache.get_module(shader_directory / "cull.comp.spv"),
+            .push_constant_size = sizeof(CullConstants),
+            .local_size = { CULL_GROUP_SIZE, 1, 1 }
+        }, p_pipeline_cache);
+
+        create_draw_buffers(INITIAL_DRAW_CAPACITY);
+    }
+
+    void MeshRenderer::cleanup()
+    {
+        m_draw_buffer->cleanup();
+        m_count_buffer->cleanup();
+        m_draw_buffer.reset();
+        m_count_buffer.reset();
+
+        m_cull_pipeline.cleanup();
+        m_pipeline.cleanup();
+        m_mesh_pool.cleanup();
+        m_pending_draws.clear();
+        m_frame_draws.clear();
+    }
+
+    vi::MeshHandle MeshRenderer::add_mesh(const std::span<const vi::Vertex> p_vertices, const std::span<const uint32_t> p_indices, const std::span<const vi::MeshLod> p_lods)
+    {
+        return m_mesh_pool.add_mesh(p_vertices, p_indices, p_lods);
+    }
+
+    void MeshRenderer::draw(const vi::MeshHandle p_mesh, const glm::mat4& p_transform)
+    {
+        std::scoped_lock lock{ m_mutex };
+        m_pending_draws.push_back({ p_mesh, p_transform });
+    }
+
+    void MeshRenderer::set_view_projection(const glm::mat4& p_view_projection)
+    {
+        std::scoped_lock lock{ m_mutex };
+        m_view_projection = p_view_projection;
+    }
+
+    void MeshRenderer::set_lod_threshold(const float p_pixels)
+    {
+        std::scoped_lock lock{ m_mutex };
+        m_lod_threshold = p_pixels;
+    }
+
+    void MeshRenderer::begin_frame(FrameAllocator& p_frame_allocator, vi::DeletionQueue& p_retire_queue)
+    {
+        VI_PROFILE_FUNCTION();
+
+        {
+            std::scoped_lock lock{ m_mutex };
+            //swapping keeps the capacity of both lists, so steady scenes stop allocating
+            m_frame_draws.clear();
+            std::swap(m_frame_draws, m_pending_draws);
+            m_frame_view_projection = m_view_projection;
+            m_frame_lod_threshold = m_lod_threshold;
+        }
+
+        m_object_count = static_cast<uint32_t>(m_frame_draws.size());
+        if (m_object_count == 0)
+        {
+            return;
+        }
+
+        if (m_object_count > m_draw_capacity)
+        {
+            //frames in flight may still read the old buffers
+            p_retire_queue.push_function([draw_buffer = std::shared_ptr<Buffer>{ std::move(m_draw_buffer) }, count_buffer = std::shared_ptr<Buffer>{ std::move(m_count_buffer) }]()
+            {
+                draw_buffer->cleanup();
+                count_buffer->cleanup();
+            });
+            create_draw_buffers(std::bit_ceil(m_object_count));
+        }
+
+        const auto meshes = m_mesh_pool.get_meshes();
+        const auto allocation = p_frame_allocator.allocate_storage(m_object_count * sizeof(ObjectData));
+        auto* objects = reinterpret_cast<ObjectData*>(allocation.data);
+        for (uint32_t i = 0; i < m_object_count; ++i)
+        {
+            const auto& [mesh_handle, transform] = m_frame_draws[i];
+            const auto& mesh = meshes->at(mesh_handle.Id);
+
+            ObjectData object{
+                .m_transform = transform,
+                .m_bounds = mesh.bounds,
+                .m_vertex_offset = mesh.vertex_offset,
+                .m_lod_count = mesh.lod_count
+            };
+            //once per object instead of once per vertex
+            const auto normal_matrix = glm::transpose(glm::inverse(glm::mat3{ transform }));
+            for (glm::length_t column = 0; column < 3; ++column)
+            {
+                object.m_normal_matrix[column] = glm::vec4{ normal_matrix[column], 0.0f };
+            }
+            for (uint32_t lod = 0; lod < mesh.lod_count; ++lod)
+            {
+                object.m_lods[lod] = { mesh.lods[lod].first_index, mesh.lods[lod].index_count, mesh.lods[lod].error };
+            }
+            //the frame allocator may be write-combined memory, so the object is written in one go
+            std::memcpy(objects + i, &object, sizeof(ObjectData));
+        }
+
+        m_objects_address = allocation.address;
+        m_frustum_planes = frustum_planes(m_frame_view_projection);
+    }
+
+    MeshDrawBuffers MeshRenderer::add_cull_passes(RenderGraph& p_graph, const VkExtent2D p_extent)
+    {
+        const MeshDrawBuffers buffers{
+            .draws = p_graph.import_buffer("mesh draws", *m_draw_buffer),
+            .count = p_graph.import_buffer("mesh draw count", *m_count_buffer)
+        };
+
+        p_graph.add_pass("reset draw count", [buffers](RenderGraphBuilder& p_builder)
+        {
+            p_builder.write(buffers.count, BufferUsage::TransferDst);
+        }, [buffers](const VkCommandBuffer p_cmd, const RenderGraphResources& p_resources)
+        {
+            vkCmdFillBuffer(p_cmd, p_resources.get_buffer(buffers.count), 0, sizeof(uint32_t), 0);
+        });
+
+        p_graph.add_pass("cull", [buffers](RenderGraphBuilder& p_builder)
+        {
+            p_builder.write(buffers.draws, BufferUsage::ComputeWrite);
+            p_builder.write(buffers.count, BufferUsage::ComputeReadWrite);
+        }, [this, p_extent](const VkCommandBuffer p_cmd, const RenderGraphResources&)
+        {
+            //for a perspective projection the y row of the matrix is the vertical focal length times the camera's up axis
+            const auto focal_length = glm::length(glm::vec3{ glm::transpose(m_frame_view_projection)[1] });
+            const auto pixels_per_unit = focal_length * static_cast<float>(p_extent.height) * 0.5f;
+            //no threshold keeps every object at LOD 0
+            const auto lod_scale = m_frame_lod_threshold > 0.0f ? pixels_per_unit / m_frame_lod_threshold : std::numeric_limits<float>::max();
+
+            const CullConstants constants{
+                .m_frustum_planes = m_frustum_planes,
+                .m_object_buffer = m_objects_address,
+                .m_draw_buffer = m_draw_buffer->get_device_address(),
+                .m_count_buffer = m_count_buffer->get_device_address(),
+                .m_object_count = m_object_count,
+                .m_lod_scale = lod_scale
+            };
+
+            m_cull_pipeline.bind(p_cmd);
+            m_cull_pipeline.push_constants(p_cmd, constants);
+            m_cull_pipeline.dispatch(p_cmd, m_object_count, 1);
+        });
+
+        return buffers;
+    }
+
+    void MeshRenderer::record(const VkCommandBuffer p_cmd, const VkExtent2D p_extent, const RenderGraphResources& p_resources, const MeshDrawBuffers& p_buffers) const
+    {
+        m_pipeline.bind(p_cmd);
+        m_mesh_pool.bind_index_buffer(p_cmd);
+
+        //negative height flips y, so the projection keeps y up like on other APIs
+        VkViewport viewport{};
+        viewport.x = 0.0f;
+        viewport.y = static_cast<float>(p_extent.height);
+        viewport.width = static_cast<float>(p_extent.width);
+        viewport.height = -static_cast<float>(p_extent.height);
+        viewport.minDepth = 0.0f;
+        viewport.maxDepth = 1.0f;
+        vkCmdSetViewport(p_cmd, 0, 1, &viewport);
+
+        VkRect2D scissor{};
+        scissor.offset = { 0, 0 };
+        scissor.extent = p_extent;
+        vkCmdSetScissor(p_cmd, 0, 1, &scissor);
+
+        const MeshConstants constants{
+            .m_view_projection = m_frame_view_projection,
+            .m_vertex_buffer = m_mesh_pool.get_vertex_address(),
+            .m_object_buffer = m_objects_address
+        };
+        m_pipeline.push_constants(p_cmd, constants);
+
+        //one draw per visible object, each one finds its object through firstInstance
+        vkCmdDrawIndexedIndirectCount(p_cmd, p_resources.get_buffer(p_buffers.draws), 0, p_resources.get_buffer(p_buffers.count), 0, m_object_count,
+            sizeof(VkDrawIndexedIndirectCommand));
+    }
+
+    void MeshRenderer::create_draw_buffers(const uint32_t p_capacity)
+    {
+        m_draw_capacity = p_capacity;
+        m_draw_buffer = std::make_unique<Buffer>(p_capacity * sizeof(VkDrawIndexedIndirectCommand), VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+            VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT, VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE, m_allocator, m_device);
+        m_count_buffer = std::make_unique<Buffer>(sizeof(uint32_t), VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT |
+            VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT, VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE, m_allocator, m_device);
+
+        VI_CORE_INFO("Mesh renderer holds {} indirect draws", p_capacity);
+    }
+}
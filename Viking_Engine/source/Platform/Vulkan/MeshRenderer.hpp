@@ -0,0 +1,110 @@
+#ifndef VULKAN_MESH_RENDERER_HPP
+#define VULKAN_MESH_RENDERER_HPP
+
+#include "Platform/Vulkan/MeshPool.hpp"
+#include "Platform/Vulkan/Pipeline.hpp"
+#include "Platform/Vulkan/RenderGraph.hpp"
+#include "Viking/core/DeletionQueue.hpp"
+#include "Viking/renderer/Mesh.hpp"
+
+#include <vulkan/vulkan.hpp>
+
+#include <vk_mem_alloc.h>
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+
+namespace vulkan
+{
+    class Buffer;
+    class FrameAllocator;
+    class ShaderCache;
+    class UploadEngine;
+
+    //Graph handles of the indirect draws written by the culling pass
+    struct MeshDrawBuffers
+    {
+        RenderGraphBuffer draws{};
+        RenderGraphBuffer count{};
+    };
+
+    //GPU driven drawing of the meshes of the pool. The CPU only writes one object record per draw into the frame
+    //allocator; a compute pass culls the objects against the frustum, picks the coarsest LOD whose error stays under
+    //the threshold at the projected size of the bounding sphere and writes an indirect command per visible object.
+    //The whole frame is drawn with a single vkCmdDrawIndexedIndirectCount.
+    //Vertices and objects are pulled by the vertex shader through buffer device addresses
+    class MeshRenderer
+    {
+    public:
+        static constexpr VkFormat DEPTH_FORMAT{ VK_FORMAT_D32_SFLOAT };
+
+        void init(VkDevice p_device, VmaAllocator p_allocator, UploadEngine& p_upload_engine, ShaderCache& p_shader_cache, VkPipelineCache p_pipeline_cache,
+            std::span<const uint32_t> p_queue_families, VkFormat p_color_format);
+        void cleanup();
+
+        [[nodiscard]] vi::MeshHandle add_mesh(std::span<const vi::Vertex> p_vertices, std::span<const uint32_t> p_indices, std::span<const vi::MeshLod> p_lods = {});
+
+        //Queues a draw for the next frame that begins
+        void draw(vi::MeshHandle p_mesh, const glm::mat4& p_transform);
+        //Projection with reversed depth, near maps to 1 and far to 0
+        void set_view_projection(const glm::mat4& p_view_projection);
+        //Screen space error in pixels a LOD may show, 0 always draws LOD 0
+        void set_lod_threshold(float p_pixels);
+
+        //Takes the queued draws for the frame being built and writes their objects into p_frame_allocator,
+        //later draws go to the next frame. Indirect buffers outgrown by the frame are pushed into p_retire_queue
+        void begin_frame(FrameAllocator& p_frame_allocator, vi::DeletionQueue& p_retire_queue);
+        [[nodiscard]] bool has_draws() const { return m_object_count > 0; }
+
+        //Adds the passes that reset the draw count and cull the objects, the geometry pass reads what they return.
+        //p_extent is the size the geometry is rendered at, LODs are picked for it
+        [[nodiscard]] MeshDrawBuffers add_cull_passes(RenderGraph& p_graph, VkExtent2D p_extent);
+        //Records the draws of the frame, rendering has to be begun with a color and a DEPTH_FORMAT attachment
+        void record(VkCommandBuffer p_cmd, VkExtent2D p_extent, const RenderGraphResources& p_resources, const MeshDrawBuffers& p_buffers) const;
+
+    private:
+        static constexpr uint32_t INITIAL_DRAW_CAPACITY{ 1024 };
+
+        struct Draw
+        {
+            vi::MeshHandle m_mesh{};
+            glm::mat4 m_transform{};
+        };
+
+        void create_draw_buffers(uint32_t p_capacity);
+
+        VkDevice m_device{};
+        VmaAllocator m_allocator{};
+
+        MeshPool m_mesh_pool{};
+        GraphicsPipeline m_pipeline{};
+        ComputePipeline m_cull_pipeline{};
+
+        //written by the culling pass, large enough for every object of the frame
+        std::unique_ptr<Buffer> m_draw_buffer{};
+        std::unique_ptr<Buffer> m_count_buffer{};
+        uint32_t m_draw_capacity{};
+
+        std::vector<Draw> m_pending_draws{};
+        std::vector<Draw> m_frame_draws{};
+        glm::mat4 m_view_projection{ 1.0f };
+        float m_lod_threshold{ 1.0f };
+
+        //what begin_frame prepared for the frame's passes
+        glm::mat4 m_frame_view_projection{ 1.0f };
+        float m_frame_lod_threshold{ 1.0f };
+        std::array<glm::vec4, 6> m_frustum_planes{};
+        VkDeviceAddress m_objects_address{};
+        uint32_t m_object_count{};
+
+        mutable std::mutex m_mutex{};
+    };
+}
+
+#endif // VULKAN_MESH_RENDERER_HPP
@@ -0,0 +1,180 @@
+#include "Platform/Vulkan/ParallelRecorder.hpp"
+
+#include "Viking/core/Profiler.hpp"
+
+#include <vulkan/vk_enum_string_helper.h>
+
+#include <exception>
+#include <format>
+#include <future>
+#include <stdexcept>
+
+namespace vulkan
+{
+    void ParallelRecorder::init(const VkDevice p_device, const uint32_t p_queue_family, const uint32_t p_frame_count, const uint32_t p_thread_count)
+    {
+        m_device = p_device;
+        m_thread_pool.init("Recording worker", p_thread_count);
+
+        VkCommandPoolCreateInfo pool_info{};
+        pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        pool_info.pNext = nullptr;
+        pool_info.queueFamilyIndex = p_queue_family;
+        //buffers are only ever reset together with their pool
+        pool_info.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+        m_frames.resize(p_frame_count);
+        for (auto& workers : m_frames)
+        {
+            workers.resize(m_thread_pool.get_thread_count() + 1);
+            for (auto& worker : workers)
+            {
+                if (const auto result = vkCreateCommandPool(m_device, &pool_info, nullptr, &worker.m_pool); result != VK_SUCCESS)
+                {
+                    throw std::runtime_error(std::format("Cannot create worker command pool: {}", string_VkResult(result)));
+                }
+            }
+        }
+    }
+
+    void ParallelRecorder::cleanup()
+    {
+        m_thread_pool.shutdown();
+
+        for (const auto& workers : m_frames)
+        {
+            for (const auto& worker : workers)
+            {
+                vkDestroyCommandPool(m_device, worker.m_pool, nullptr);
+            }
+        }
+        m_frames.clear();
+        m_current = nullptr;
+    }
+
+    void ParallelRecorder::begin_frame(const uint32_t p_frame_index)
+    {
+        m_current = &m_frames.at(p_frame_index);
+        for (auto& worker : *m_current)
+        {
+            if (worker.m_used == 0)
+            {
+                continue;
+            }
+
+            if (const auto result = vkResetCommandPool(m_device, worker.m_pool, 0); result != VK_SUCCESS)
+            {
+                throw std::runtime_error(std::format("Cannot reset worker command pool: {}", string_VkResult(result)));
+            }
+            worker.m_used = 0;
+        }
+    }
+
+    void ParallelRecorder::record(const VkCommandBuffer p_cmd, const std::span<const RecordFunction> p_tasks, const VkCommandBufferInheritanceInfo* p_inheritance)
+    {
+        VI_PROFILE_FUNCTION();
+
+        if (p_tasks.empty())
+        {
+            return;
+        }
+
+        VkCommandBufferInheritanceInfo default_inheritance{};
+        default_inheritance.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+
+        VkCommandBufferBeginInfo begin_info{};
+        begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        begin_info.pNext = nullptr;
+        begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        begin_info.pInheritanceInfo = p_inheritance != nullptr ? p_inheritance : &default_inheritance;
+        if (p_inheritance != nullptr && p_inheritance->pNext != nullptr)
+        {
+            //dynamic rendering is described by VkCommandBufferInheritanceRenderingInfo in the chain
+            begin_info.flags |= VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+        }
+
+        std::vector<VkCommandBuffer> buffers(p_tasks.size());
+        const auto record_task = [this, &begin_info, &buffers, p_tasks](const size_t p_task)
+        {
+            //the pool of the calling thread, the recording thread takes the slot after the workers
+            const auto worker_index = m_thread_pool.get_worker_index();
+            auto& worker = m_current->at(worker_index == vi::ThreadPool::INVALID_WORKER ? m_current->size() - 1 : worker_index);
+
+            const auto cmd = acquire_buffer(worker);
+            if (const auto result = vkBeginCommandBuffer(cmd, &begin_info); result != VK_SUCCESS)
+            {
+                throw std::runtime_error(std::format("Cannot begin secondary command buffer: {}", string_VkResult(result)));
+            }
+
+            p_tasks[p_task](cmd);
+
+            if (const auto result = vkEndCommandBuffer(cmd); result != VK_SUCCESS)
+            {
+                throw std::runtime_error(std::format("Cannot end secondary command buffer: {}", string_VkResult(result)));
+            }
+            buffers[p_task] = cmd;
+        };
+
+        //the recording thread takes the last task instead of idling
+        std::vector<std::future<void>> pending;
+        pending.reserve(p_tasks.size() - 1);
+        for (size_t task = 0; task + 1 < p_tasks.size(); ++task)
+        {
+            pending.push_back(m_thread_pool.submit([&record_task, task]() { record_task(task); }));
+        }
+        //every job references this frame, so all of them have to finish before an error leaves it
+        std::exception_ptr error;
+        try
+        {
+            record_task(p_tasks.size() - 1);
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+
+        for (auto& future : pending)
+        {
+            try
+            {
+                future.get();
+            }
+            catch (...)
+            {
+                if (!error)
+                {
+                    error = std::current_exception();
+                }
+            }
+        }
+
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+
+        vkCmdExecuteCommands(p_cmd, static_cast<uint32_t>(buffers.size()), buffers.data());
+    }
+
+    VkCommandBuffer ParallelRecorder::acquire_buffer(WorkerCommands& p_worker) const
+    {
+        if (p_worker.m_used == p_worker.m_buffers.size())
+        {
+            VkCommandBufferAllocateInfo alloc_info{};
+            alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            alloc_info.pNext = nullptr;
+            alloc_info.commandPool = p_worker.m_pool;
+            alloc_info.commandBufferCount = 1;
+            alloc_info.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+
+            VkCommandBuffer cmd{};
+            if (const auto result = vkAllocateCommandBuffers(m_device, &alloc_info, &cmd); result != VK_SUCCESS)
+            {
+                throw std::runtime_error(std::format("Cannot allocate secondary command buffer: {}", string_VkResult(result)));
+            }
+            p_worker.m_buffers.push_back(cmd);
+        }
+
+        return p_worker.m_buffers[p_worker.m_used++];
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef VULKAN_PARALLEL_RECORDER_HPP
+#define VULKAN_PARALLEL_RECORDER_HPP
+
+#include "Viking/core/ThreadPool.hpp"
+
+#include <vulkan/vulkan.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+namespace vulkan
+{
+    //Records work into secondary command buffers on a thread pool. Every frame in flight has one command pool
+    //per worker, so workers never share a pool and no pool is reset while the GPU may still read from it
+    class ParallelRecorder
+    {
+    public:
+        using RecordFunction = std::function<void(VkCommandBuffer)>;
+
+        void init(VkDevice p_device, uint32_t p_queue_family, uint32_t p_frame_count, uint32_t p_thread_count);
+        void cleanup();
+
+        //Resets the pools of the frame slot, the submission that last used it has to be complete
+        void begin_frame(uint32_t p_frame_index);
+
+        //Records every task into its own secondary buffer in parallel, then executes them into p_cmd in task order.
+        //Secondary buffers inherit no state, each task binds its own pipeline and descriptors.
+        //p_inheritance describes the rendering the tasks run in, if any
+        void record(VkCommandBuffer p_cmd, std::span<const RecordFunction> p_tasks, const VkCommandBufferInheritanceInfo* p_inheritance = nullptr);
+
+        [[nodiscard]] uint32_t get_thread_count() const { return m_thread_pool.get_thread_count(); }
+
+    private:
+        struct WorkerCommands
+        {
+            VkCommandPool m_pool{};
+            std::vector<VkCommandBuffer> m_buffers{};
+            //buffers handed out since the pool was last reset
+            size_t m_used{};
+        };
+
+        [[nodiscard]] VkCommandBuffer acquire_buffer(WorkerCommands& p_worker) const;
+
+        VkDevice m_device{};
+        vi::ThreadPool m_thread_pool{};
+
+        //[frame][worker], the last worker slot belongs to the recording thread
+        std::vector<std::vector<WorkerCommands>> m_frames{};
+        std::vector<WorkerCommands>* m_current{};
+    };
+}
+
+#endif // VULKAN_PARALLEL_RECORDER_HPP
@@ -0,0 +1,239 @@
+#include "Platform/Vulkan/Pipeline.hpp"
+
+#include <vulkan/vk_enum_string_helper.h>
+
+#include <array>
+#include <format>
+#include <stdexcept>
+
+namespace
+{
+    uint32_t group_count(const uint32_t p_invocations, const uint32_t p_local_size)
+    {
+        return (p_invocations + p_local_size - 1) / p_local_size;
+    }
+}
+
+namespace vulkan
+{
+    void ComputePipeline::init(const VkDevice p_device, const ComputePipelineDesc& p_desc, const VkPipelineCache p_cache)
+    {
+        m_device = p_device;
+        m_push_constant_size = p_desc.push_constant_size;
+        m_local_size = p_desc.local_size;
+
+        VkPushConstantRange push_constant{};
+        push_constant.offset = 0;
+        push_constant.size = m_push_constant_size;
+        push_constant.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+        VkPipelineLayoutCreateInfo layout_info{};
+        layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        layout_info.pNext = nullptr;
+        layout_info.setLayoutCount = static_cast<uint32_t>(p_desc.set_layouts.size());
+        layout_info.pSetLayouts = p_desc.set_layouts.data();
+        layout_info.pushConstantRangeCount = m_push_constant_size > 0 ? 1 : 0;
+        layout_info.pPushConstantRanges = &push_constant;
+
+        if (const auto result = vkCreatePipelineLayout(m_device, &layout_info, nullptr, &m_layout); result != VK_SUCCESS)
+        {
+            throw std::runtime_error(std::format("Cannot create compute pipeline layout: {}", string_VkResult(result)));
+        }
+
+        VkPipelineShaderStageCreateInfo stage_info{};
+        stage_info.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        stage_info.pNext = nullptr;
+        stage_info.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        stage_info.module = p_desc.shader;
+        stage_info.pName = p_desc.entry_point;
+
+        VkComputePipelineCreateInfo pipeline_info{};
+        pipeline_info.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        pipeline_info.pNext = nullptr;
+        pipeline_info.layout = m_layout;
+        pipeline_info.stage = stage_info;
+
+        if (const auto result = vkCreateComputePipelines(m_device, p_cache, 1, &pipeline_info, nullptr, &m_pipeline); result != VK_SUCCESS)
+        {
+            vkDestroyPipelineLayout(m_device, m_layout, nullptr);
+            throw std::runtime_error(std::format("Cannot create compute pipeline: {}", string_VkResult(result)));
+        }
+    }
+
+    void ComputePipeline::cleanup()
+    {
+        vkDestroyPipeline(m_device, m_pipeline, nullptr);
+        vkDestroyPipelineLayout(m_device, m_layout, nullptr);
+        m_pipeline = VK_NULL_HANDLE;
+        m_layout = VK_NULL_HANDLE;
+    }
+
+    void ComputePipeline::bind(const VkCommandBuffer p_cmd) const
+    {
+        vkCmdBindPipeline(p_cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipeline);
+    }
+
+    void ComputePipeline::bind_descriptor_set(const VkCommandBuffer p_cmd, const uint32_t p_set, const VkDescriptorSet p_descriptor_set) const
+    {
+        vkCmdBindDescriptorSets(p_cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_layout, p_set, 1, &p_descriptor_set, 0, nullptr);
+    }
+
+    void ComputePipeline::push_constants(const VkCommandBuffer p_cmd, const void* p_data, const uint32_t p_size) const
+    {
+        if (p_size > m_push_constant_size)
+        {
+            throw std::runtime_error(std::format("Push constants of {} bytes do not fit the {} bytes of the pipeline layout", p_size, m_push_constant_size));
+        }
+
+        vkCmdPushConstants(p_cmd, m_layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, p_size, p_data);
+    }
+
+    void ComputePipeline::dispatch(const VkCommandBuffer p_cmd, const uint32_t p_width, const uint32_t p_height, const uint32_t p_depth) const
+    {
+        vkCmdDispatch(p_cmd, group_count(p_width, m_local_size.width), group_count(p_height, m_local_size.height), group_count(p_depth, m_local_size.depth));
+    }
+
+    void GraphicsPipeline::init(const VkDevice p_device, const GraphicsPipelineDesc& p_desc, const VkPipelineCache p_cache)
+    {
+        m_device = p_device;
+        m_push_constant_size = p_desc.push_constant_size;
+
+        VkPushConstantRange push_constant{};
+        push_constant.offset = 0;
+        push_constant.size = m_push_constant_size;
+        push_constant.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+
+        VkPipelineLayoutCreateInfo layout_info{};
+        layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        layout_info.pNext = nullptr;
+        layout_info.setLayoutCount = static_cast<uint32_t>(p_desc.set_layouts.size());
+        layout_info.pSetLayouts = p_desc.set_layouts.data();
+        layout_info.pushConstantRangeCount = m_push_constant_size > 0 ? 1 : 0;
+        layout_info.pPushConstantRanges = &push_constant;
+
+        if (const auto result = vkCreatePipelineLayout(m_device, &layout_info, nullptr, &m_layout); result != VK_SUCCESS)
+        {
+            throw std::runtime_error(std::format("Cannot create graphics pipeline layout: {}", string_VkResult(result)));
+        }
+
+        std::array<VkPipelineShaderStageCreateInfo, 2> stages{};
+        stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+        stages[0].module = p_desc.vertex_shader;
+        stages[0].pName = p_desc.entry_point;
+        stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+        stages[1].module = p_desc.fragment_shader;
+        stages[1].pName = p_desc.entry_point;
+
+        //no vertex bindings, the vertex shader reads the vertices itself
+        VkPipelineVertexInputStateCreateInfo vertex_input{};
+        vertex_input.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+
+        VkPipelineInputAssemblyStateCreateInfo input_assembly{};
+        input_assembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+        input_assembly.topology = p_desc.topology;
+        input_assembly.primitiveRestartEnable = VK_FALSE;
+
+        VkPipelineViewportStateCreateInfo viewport{};
+        viewport.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+        viewport.viewportCount = 1;
+        viewport.scissorCount = 1;
+
+        VkPipelineRasterizationStateCreateInfo rasterization{};
+        rasterization.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+        rasterization.polygonMode = VK_POLYGON_MODE_FILL;
+        rasterization.cullMode = p_desc.cull_mode;
+        rasterization.frontFace = p_desc.front_face;
+        rasterization.lineWidth = 1.0f;
+
+        VkPipelineMultisampleStateCreateInfo multisample{};
+        multisample.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+        multisample.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+        multisample.minSampleShading = 1.0f;
+
+        const auto has_depth = p_desc.depth_format != VK_FORMAT_UNDEFINED;
+        VkPipelineDepthStencilStateCreateInfo depth_stencil{};
+        depth_stencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+        depth_stencil.depthTestEnable = has_depth;
+        depth_stencil.depthWriteEnable = has_depth && p_desc.depth_write;
+        depth_stencil.depthCompareOp = has_depth ? p_desc.depth_compare : VK_COMPARE_OP_ALWAYS;
+        depth_stencil.minDepthBounds = 0.0f;
+        depth_stencil.maxDepthBounds = 1.0f;
+
+        //blending is off, every attachment is written as is
+        std::vector<VkPipelineColorBlendAttachmentState> blend_attachments(p_desc.color_formats.size());
+        for (auto& attachment : blend_attachments)
+        {
+            attachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+            attachment.blendEnable = VK_FALSE;
+        }
+
+        VkPipelineColorBlendStateCreateInfo color_blend{};
+        color_blend.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+        color_blend.logicOpEnable = VK_FALSE;
+        color_blend.attachmentCount = static_cast<uint32_t>(blend_attachments.size());
+        color_blend.pAttachments = blend_attachments.data();
+
+        constexpr std::array dynamic_states{ VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+        VkPipelineDynamicStateCreateInfo dynamic_state{};
+        dynamic_state.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+        dynamic_state.dynamicStateCount = static_cast<uint32_t>(dynamic_states.size());
+        dynamic_state.pDynamicStates = dynamic_states.data();
+
+        VkPipelineRenderingCreateInfo rendering_info{};
+        rendering_info.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
+        rendering_info.colorAttachmentCount = static_cast<uint32_t>(p_desc.color_formats.size());
+        rendering_info.pColorAttachmentFormats = p_desc.color_formats.data();
+        rendering_info.depthAttachmentFormat = p_desc.depth_format;
+
+        VkGraphicsPipelineCreateInfo pipeline_info{};
+        pipeline_info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        pipeline_info.pNext = &rendering_info;
+        pipeline_info.stageCount = static_cast<uint32_t>(stages.size());
+        pipeline_info.pStages = stages.data();
+        pipeline_info.pVertexInputState = &vertex_input;
+        pipeline_info.pInputAssemblyState = &input_assembly;
+        pipeline_info.pViewportState = &viewport;
+        pipeline_info.pRasterizationState = &rasterization;
+        pipeline_info.pMultisampleState = &multisample;
+        pipeline_info.pDepthStencilState = &depth_stencil;
+        pipeline_info.pColorBlendState = &color_blend;
+        pipeline_info.pDynamicState = &dynamic_state;
+        pipeline_info.layout = m_layout;
+
+        if (const auto result = vkCreateGraphicsPipelines(m_device, p_cache, 1, &pipeline_info, nullptr, &m_pipeline); result != VK_SUCCESS)
+        {
+            vkDestroyPipelineLayout(m_device, m_layout, nullptr);
+            throw std::runtime_error(std::format("Cannot create graphics pipeline: {}", string_VkResult(result)));
+        }
+    }
+
+    void GraphicsPipeline::cleanup()
+    {
+        vkDestroyPipeline(m_device, m_pipeline, nullptr);
+        vkDestroyPipelineLayout(m_device, m_layout, nullptr);
+        m_pipeline = VK_NULL_HANDLE;
+        m_layout = VK_NULL_HANDLE;
+    }
+
+    void GraphicsPipeline::bind(const VkCommandBuffer p_cmd) const
+    {
+        vkCmdBindPipeline(p_cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline);
+    }
+
+    void GraphicsPipeline::bind_descriptor_set(const VkCommandBuffer p_cmd, const uint32_t p_set, const VkDescriptorSet p_descriptor_set) const
+    {
+        vkCmdBindDescriptorSets(p_cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_layout, p_set, 1, &p_descriptor_set, 0, nullptr);
+    }
+
+    void GraphicsPipeline::push_constants(const VkCommandBuffer p_cmd, const void* p_data, const uint32_t p_size) const
+    {
+        if (p_size > m_push_constant_size)
+        {
+            throw std::runtime_error(std::format("Push constants of {} bytes do not fit the {} bytes of the pipeline layout", p_size, m_push_constant_size));
+        }
+
+        vkCmdPushConstants(p_cmd, m_layout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, p_size, p_data);
+    }
+}
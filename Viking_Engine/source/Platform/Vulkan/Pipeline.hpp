@@ -0,0 +1,99 @@
+#ifndef VULKAN_PIPELINE_HPP
+#define VULKAN_PIPELINE_HPP
+
+#include <vulkan/vulkan.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace vulkan
+{
+    struct ComputePipelineDesc
+    {
+        VkShaderModule shader{};
+        const char* entry_point{ "main" };
+        std::vector<VkDescriptorSetLayout> set_layouts{};
+        //a single range visible to the compute stage, 0 when the shader has no push constants
+        uint32_t push_constant_size{};
+        //has to match the local_size declared by the shader, dispatch rounds up to it
+        VkExtent3D local_size{ 1, 1, 1 };
+    };
+
+    class ComputePipeline
+    {
+    public:
+        void init(VkDevice p_device, const ComputePipelineDesc& p_desc, VkPipelineCache p_cache = VK_NULL_HANDLE);
+        void cleanup();
+
+        void bind(VkCommandBuffer p_cmd) const;
+        void bind_descriptor_set(VkCommandBuffer p_cmd, uint32_t p_set, VkDescriptorSet p_descriptor_set) const;
+        void push_constants(VkCommandBuffer p_cmd, const void* p_data, uint32_t p_size) const;
+
+        template<typename T>
+        void push_constants(const VkCommandBuffer p_cmd, const T& p_constants) const
+        {
+            push_constants(p_cmd, &p_constants, sizeof(T));
+        }
+
+        //Dispatches enough groups to cover p_width x p_height x p_depth invocations
+        void dispatch(VkCommandBuffer p_cmd, uint32_t p_width, uint32_t p_height, uint32_t p_depth = 1) const;
+
+        [[nodiscard]] VkPipeline get_pipeline() const { return m_pipeline; }
+        [[nodiscard]] VkPipelineLayout get_layout() const { return m_layout; }
+
+    private:
+        VkDevice m_device{};
+        VkPipeline m_pipeline{};
+        VkPipelineLayout m_layout{};
+        uint32_t m_push_constant_size{};
+        VkExtent3D m_local_size{};
+    };
+
+    //Pipelines for dynamic rendering without vertex input, vertices are pulled by the shaders.
+    //Viewport and scissor are dynamic
+    struct GraphicsPipelineDesc
+    {
+        VkShaderModule vertex_shader{};
+        VkShaderModule fragment_shader{};
+        const char* entry_point{ "main" };
+        std::vector<VkDescriptorSetLayout> set_layouts{};
+        //a single range visible to the vertex and fragment stages, 0 when the shaders have no push constants
+        uint32_t push_constant_size{};
+        VkPrimitiveTopology topology{ VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST };
+        VkCullModeFlags cull_mode{ VK_CULL_MODE_BACK_BIT };
+        VkFrontFace front_face{ VK_FRONT_FACE_COUNTER_CLOCKWISE };
+        std::vector<VkFormat> color_formats{};
+        VkFormat depth_format{ VK_FORMAT_UNDEFINED };
+        bool depth_write{ true };
+        //reversed depth, near is 1 and far is 0
+        VkCompareOp depth_compare{ VK_COMPARE_OP_GREATER_OR_EQUAL };
+    };
+
+    class GraphicsPipeline
+    {
+    public:
+        void init(VkDevice p_device, const GraphicsPipelineDesc& p_desc, VkPipelineCache p_cache = VK_NULL_HANDLE);
+        void cleanup();
+
+        void bind(VkCommandBuffer p_cmd) const;
+        void bind_descriptor_set(VkCommandBuffer p_cmd, uint32_t p_set, VkDescriptorSet p_descriptor_set) const;
+        void push_constants(VkCommandBuffer p_cmd, const void* p_data, uint32_t p_size) const;
+
+        template<typename T>
+        void push_constants(const VkCommandBuffer p_cmd, const T& p_constants) const
+        {
+            push_constants(p_cmd, &p_constants, sizeof(T));
+        }
+
+        [[nodiscard]] VkPipeline get_pipeline() const { return m_pipeline; }
+        [[nodiscard]] VkPipelineLayout get_layout() const { return m_layout; }
+
+    private:
+        VkDevice m_device{};
+        VkPipeline m_pipeline{};
+        VkPipelineLayout m_layout{};
+        uint32_t m_push_constant_size{};
+    };
+}
+
+#endif // VULKAN_PIPELINE_HPP
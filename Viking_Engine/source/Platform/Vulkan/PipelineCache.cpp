@@ -0,0 +1,190 @@
+#include "Platform/Vulkan/PipelineCache.hpp"
+
+#include "Viking/core/Log.hpp"
+
+#include <vulkan/vk_enum_string_helper.h>
+
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+
+namespace
+{
+    constexpr uint32_t PIPELINE_CACHE_MAGIC{ 0x43504956 }; // "VIPC"
+    constexpr uint32_t PIPELINE_CACHE_VERSION{ 1 };
+}
+
+namespace vulkan
+{
+    void PipelineCache::init(const VkPhysicalDevice p_physical_device, const VkDevice p_device, std::filesystem::path p_path)
+    {
+        m_device = p_device;
+        m_path = std::move(p_path);
+
+        VkPhysicalDeviceIDProperties id_properties{};
+        id_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES;
+
+        VkPhysicalDeviceProperties2 properties{};
+        properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+        properties.pNext = &id_properties;
+        vkGetPhysicalDeviceProperties2(p_physical_device, &properties);
+
+        //the header is written as raw bytes, so its padding is zeroed instead of leaking whatever was in memory
+        std::memset(&m_header, 0, sizeof(m_header));
+        m_header.m_magic = PIPELINE_CACHE_MAGIC;
+        m_header.m_version = PIPELINE_CACHE_VERSION;
+        m_header.m_vendor_id = properties.properties.vendorID;
+        m_header.m_device_id = properties.properties.deviceID;
+        m_header.m_driver_version = properties.properties.driverVersion;
+        std::memcpy(m_header.m_driver_uuid.data(), id_properties.driverUUID, VK_UUID_SIZE);
+        std::memcpy(m_header.m_pipeline_cache_uuid.data(), properties.properties.pipelineCacheUUID, VK_UUID_SIZE);
+
+        const auto initial_data = load();
+
+        VkPipelineCacheCreateInfo info{};
+        info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        info.pNext = nullptr;
+        info.flags = 0;
+        info.initialDataSize = initial_data.size();
+        info.pInitialData = initial_data.data();
+
+        if (const auto result = vkCreatePipelineCache(m_device, &info, nullptr, &m_cache); result != VK_SUCCESS)
+        {
+            throw std::runtime_error(std::format("Cannot create pipeline cache: {}", string_VkResult(result)));
+        }
+
+        if (initial_data.empty())
+        {
+            VI_CORE_INFO("Starting with an empty pipeline cache");
+        }
+        else
+        {
+            VI_CORE_INFO("Loaded {} bytes of pipeline cache from {}", initial_data.size(), m_path.string());
+        }
+    }
+
+    void PipelineCache::cleanup()
+    {
+        //a cache that cannot be written only costs the next startup, it must not stop the shutdown
+        try
+        {
+            save();
+        }
+        catch (const std::exception& p_exception)
+        {
+            VI_CORE_WARN("Cannot save pipeline cache: {}", p_exception.what());
+        }
+
+        vkDestroyPipelineCache(m_device, m_cache, nullptr);
+        m_cache = VK_NULL_HANDLE;
+    }
+
+    void PipelineCache::save() const
+    {
+        size_t data_size{};
+        if (const auto result = vkGetPipelineCacheData(m_device, m_cache, &data_size, nullptr); result != VK_SUCCESS)
+        {
+            throw std::runtime_error(std::format("Cannot query pipeline cache size: {}", string_VkResult(result)));
+        }
+
+        std::vector<uint8_t> data(data_size);
+        if (const auto result = vkGetPipelineCacheData(m_device, m_cache, &data_size, data.data()); result != VK_SUCCESS)
+        {
+            throw std::runtime_error(std::format("Cannot read pipeline cache: {}", string_VkResult(result)));
+        }
+        data.resize(data_size);
+
+        //copied bytewise, a member-wise copy may leave the padding undefined
+        FileHeader header;
+        std::memcpy(&header, &m_header, sizeof(header));
+        header.m_data_size = data.size();
+
+        //write next to the destination and rename over it, so readers never see a partial file
+        auto temporary_path = m_path;
+        temporary_path += ".tmp";
+
+        {
+            std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+            if (!file.is_open())
+            {
+                throw std::runtime_error(std::format("Cannot open {}", temporary_path.string()));
+            }
+
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+            file.flush();
+            if (!file)
+            {
+                throw std::runtime_error(std::format("Cannot write {}", temporary_path.string()));
+            }
+        }
+
+        std::filesystem::rename(temporary_path, m_path);
+        VI_CORE_INFO("Saved {} bytes of pipeline cache to {}", data.size(), m_path.string());
+    }
+
+    std::vector<uint8_t> PipelineCache::load() const
+    {
+        std::ifstream file(m_path, std::ios::binary);
+        if (!file.is_open())
+        {
+            return {};
+        }
+
+        FileHeader header{};
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+        {
+            VI_CORE_WARN("Pipeline cache {} is truncated, ignoring it", m_path.string());
+            return {};
+        }
+
+        //the size is checked against the file before trusting it for the allocation
+        std::error_code error;
+        const auto file_size = std::filesystem::file_size(m_path, error);
+        if (error || header.m_magic != PIPELINE_CACHE_MAGIC || header.m_version != PIPELINE_CACHE_VERSION
+            || header.m_data_size != file_size - sizeof(header))
+        {
+            VI_CORE_WARN("Pipeline cache {} is corrupted, ignoring it", m_path.string());
+            return {};
+        }
+
+        std::vector<uint8_t> data(header.m_data_size);
+        if (!file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size())))
+        {
+            VI_CORE_WARN("Pipeline cache {} is truncated, ignoring it", m_path.string());
+            return {};
+        }
+
+        if (!is_compatible(header, data))
+        {
+            VI_CORE_INFO("Pipeline cache {} was written by another device or driver, ignoring it", m_path.string());
+            return {};
+        }
+
+        return data;
+    }
+
+    bool PipelineCache::is_compatible(const FileHeader& p_header, const std::vector<uint8_t>& p_data) const
+    {
+        if (p_header.m_vendor_id != m_header.m_vendor_id || p_header.m_device_id != m_header.m_device_id
+            || p_header.m_driver_version != m_header.m_driver_version || p_header.m_driver_uuid != m_header.m_driver_uuid
+            || p_header.m_pipeline_cache_uuid != m_header.m_pipeline_cache_uuid)
+        {
+            return false;
+        }
+
+        //the blob carries its own header, some drivers do not validate it and crash on foreign data
+        VkPipelineCacheHeaderVersionOne blob_header{};
+        if (p_data.size() < sizeof(blob_header))
+        {
+            return false;
+        }
+        std::memcpy(&blob_header, p_data.data(), sizeof(blob_header));
+
+        return blob_header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+            && blob_header.vendorID == m_header.m_vendor_id
+            && blob_header.deviceID == m_header.m_device_id
+            && std::memcmp(blob_header.pipelineCacheUUID, m_header.m_pipeline_cache_uuid.data(), VK_UUID_SIZE) == 0;
+    }
+}
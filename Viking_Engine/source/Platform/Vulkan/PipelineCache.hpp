@@ -0,0 +1,51 @@
+#ifndef VULKAN_PIPELINE_CACHE_HPP
+#define VULKAN_PIPELINE_CACHE_HPP
+
+#include <vulkan/vulkan.hpp>
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace vulkan
+{
+    //VkPipelineCache persisted between runs. The file is only used when it was written by the same
+    //vendor, device and driver, anything else starts from an empty cache
+    class PipelineCache
+    {
+    public:
+        void init(VkPhysicalDevice p_physical_device, VkDevice p_device, std::filesystem::path p_path);
+        //Writes the cache back to disk before destroying it
+        void cleanup();
+
+        //The file is replaced atomically, a crash while saving leaves the previous cache intact
+        void save() const;
+
+        [[nodiscard]] VkPipelineCache get_cache() const { return m_cache; }
+
+    private:
+        //Prefix written before the driver blob, the blob header alone has no driver version nor driver UUID
+        struct FileHeader
+        {
+            uint32_t m_magic{};
+            uint32_t m_version{};
+            uint32_t m_vendor_id{};
+            uint32_t m_device_id{};
+            uint32_t m_driver_version{};
+            std::array<uint8_t, VK_UUID_SIZE> m_driver_uuid{};
+            std::array<uint8_t, VK_UUID_SIZE> m_pipeline_cache_uuid{};
+            uint64_t m_data_size{};
+        };
+
+        [[nodiscard]] std::vector<uint8_t> load() const;
+        [[nodiscard]] bool is_compatible(const FileHeader& p_header, const std::vector<uint8_t>& p_data) const;
+
+        VkDevice m_device{};
+        VkPipelineCache m_cache{};
+        std::filesystem::path m_path{};
+        FileHeader m_header{};
+    };
+}
+
+#endif // VULKAN_PIPELINE_CACHE_HPP
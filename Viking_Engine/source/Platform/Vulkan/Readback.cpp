@@ -0,0 +1,235 @@
+#include "Platform/Vulkan/Readback.hpp"
+
+#include "Platform/Vulkan/Barrier.hpp"
+#include "Platform/Vulkan/Buffer.hpp"
+#include "Platform/Vulkan/Image.hpp"
+#include "Platform/Vulkan/Timeline.hpp"
+#include "Viking/core/Log.hpp"
+#include "Viking/core/Profiler.hpp"
+
+#include <glm/gtc/packing.hpp>
+#include <vulkan/vk_enum_string_helper.h>
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <format>
+#include <stdexcept>
+
+namespace
+{
+    uint32_t texel_size(const VkFormat p_format)
+    {
+        return p_format == VK_FORMAT_R16G16B16A16_SFLOAT ? 8 : 4;
+    }
+
+    //Converts tightly packed texels of p_format into 8 bit RGBA
+    void convert_texels(const std::byte* p_source, const VkFormat p_format, std::vector<uint8_t>& p_pixels)
+    {
+        const auto texel_count = p_pixels.size() / 4;
+        switch (p_format)
+        {
+        case VK_FORMAT_B8G8R8A8_UNORM:
+        case VK_FORMAT_B8G8R8A8_SRGB:
+            for (size_t i = 0; i < texel_count; ++i)
+            {
+                p_pixels[i * 4 + 0] = static_cast<uint8_t>(p_source[i * 4 + 2]);
+                p_pixels[i * 4 + 1] = static_cast<uint8_t>(p_source[i * 4 + 1]);
+                p_pixels[i * 4 + 2] = static_cast<uint8_t>(p_source[i * 4 + 0]);
+                p_pixels[i * 4 + 3] = static_cast<uint8_t>(p_source[i * 4 + 3]);
+            }
+            break;
+        case VK_FORMAT_R16G16B16A16_SFLOAT:
+        {
+            //values are written out as they would be presented, clamped to the displayable range
+            for (size_t i = 0; i < texel_count * 4; ++i)
+            {
+                uint16_t half{};
+                std::memcpy(&half, p_source + i * 2, sizeof(half));
+                const auto value = std::clamp(glm::unpackHalf1x16(half), 0.0f, 1.0f);
+                p_pixels[i] = static_cast<uint8_t>(value * 255.0f + 0.5f);
+            }
+            break;
+        }
+        case VK_FORMAT_R8G8B8A8_UNORM:
+        case VK_FORMAT_R8G8B8A8_SRGB:
+        default:
+            std::memcpy(p_pixels.data(), p_source, p_pixels.size());
+            break;
+        }
+    }
+}
+
+namespace vulkan
+{
+    void Readback::init(const VkDevice p_device, const VmaAllocator p_allocator, Timeline& p_timeline)
+    {
+        m_device = p_device;
+        m_allocator = p_allocator;
+        m_timeline = &p_timeline;
+
+        m_thread_pool.init("Readback", 1);
+    }
+
+    void Readback::cleanup()
+    {
+        if (!m_pending.empty())
+        {
+            m_timeline->wait(m_pending.back().m_timeline_value, UINT64_MAX);
+            collect();
+        }
+
+        //finishes the queued conversions, after that every buffer is back in the free list
+        m_thread_pool.shutdown();
+
+        std::ranges::for_each(m_free_buffers, [](const std::shared_ptr<Buffer>& p_buffer)
+        {
+            p_buffer->cleanup();
+        });
+        m_free_buffers.clear();
+    }
+
+    bool Readback::is_supported(const VkFormat p_format)
+    {
+        switch (p_format)
+        {
+        case VK_FORMAT_R8G8B8A8_UNORM:
+        case VK_FORMAT_R8G8B8A8_SRGB:
+        case VK_FORMAT_B8G8R8A8_UNORM:
+        case VK_FORMAT_B8G8R8A8_SRGB:
+        case VK_FORMAT_R16G16B16A16_SFLOAT:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    void Readback::record(const VkCommandBuffer p_cmd, const VkImage p_image, const VkFormat p_format, const VkExtent3D p_extent, const uint64_t p_timeline_value, Callback p_callback)
+    {
+        if (!is_supported(p_format))
+        {
+            throw std::runtime_error(std::format("Cannot read back images of format {}", string_VkFormat(p_format)));
+        }
+
+        const auto buffer = acquire_buffer(static_cast<VkDeviceSize>(p_extent.width) * p_extent.height * texel_size(p_format));
+
+        VkBufferImageCopy region{};
+        region.bufferOffset = 0;
+        //0 means tightly packed
+        region.bufferRowLength = 0;
+        region.bufferImageHeight = 0;
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel = 0;
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount = 1;
+        region.imageExtent = { p_extent.width, p_extent.height, 1 };
+
+        vkCmdCopyImageToBuffer(p_cmd, p_image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, buffer->get_buffer(), 1, &region);
+
+        //makes the copy visible to the host once the submission completes
+        buffer->get_state() = buffer_state(BufferUsage::TransferDst);
+        BarrierBatch barriers{};
+        barriers.access(*buffer, BufferUsage::HostRead);
+        barriers.flush(p_cmd);
+
+        m_pending.push_back({
+            .m_timeline_value = p_timeline_value,
+            .m_buffer = buffer,
+            .m_format = p_format,
+            .m_extent = p_extent,
+            .m_callback = std::move(p_callback)
+        });
+    }
+
+    void Readback::record(const VkCommandBuffer p_cmd, Image& p_image, const uint64_t p_timeline_value, Callback p_callback)
+    {
+        BarrierBatch barriers{};
+        barriers.transition(p_image, ImageUsage::TransferSrc);
+        barriers.flush(p_cmd);
+
+        const auto image = p_image.get_allocated_image();
+        record(p_cmd, image.image, image.image_format, image.image_extent, p_timeline_value, std::move(p_callback));
+    }
+
+    void Readback::collect()
+    {
+        if (m_pending.empty())
+        {
+            return;
+        }
+
+        //readbacks are recorded in submission order, so they complete in order too
+        const auto completed = m_timeline->get_completed_value();
+        while (!m_pending.empty() && m_pending.front().m_timeline_value <= completed)
+        {
+            auto readback = std::move(m_pending.front());
+            m_pending.pop_front();
+
+            //the future is not kept, process reports its own failures
+            static_cast<void>(m_thread_pool.submit([this, readback = std::move(readback)]() mutable
+            {
+                process(std::move(readback));
+            }));
+        }
+    }
+
+    std::shared_ptr<Buffer> Readback::acquire_buffer(const VkDeviceSize p_size)
+    {
+        {
+            std::scoped_lock lock{ m_free_mutex };
+            if (const auto it = std::ranges::find_if(m_free_buffers, [p_size](const std::shared_ptr<Buffer>& p_buffer)
+            {
+                return p_buffer->get_size() >= p_size;
+            }); it != m_free_buffers.end())
+            {
+                auto buffer = *it;
+                m_free_buffers.erase(it);
+                return buffer;
+            }
+        }
+
+        return std::make_shared<Buffer>(p_size, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_AUTO, m_allocator, m_device,
+            VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT);
+    }
+
+    void Readback::process(PendingReadback p_readback)
+    {
+        VI_PROFILE_FUNCTION();
+
+        try
+        {
+            const auto width = p_readback.m_extent.width;
+            const auto height = p_readback.m_extent.height;
+            const auto size = static_cast<VkDeviceSize>(width) * height * texel_size(p_readback.m_format);
+
+            //host visible memory is not necessarily coherent
+            const auto allocation = p_readback.m_buffer->get_allocated_buffer().allocation;
+            if (const auto result = vmaInvalidateAllocation(m_allocator, allocation, 0, size); result != VK_SUCCESS)
+            {
+                throw std::runtime_error(std::format("Cannot invalidate readback buffer: {}", string_VkResult(result)));
+            }
+
+            vi::ImageData image{ .Width = width, .Height = height };
+            image.Pixels.resize(static_cast<size_t>(width) * height * 4);
+            convert_texels(static_cast<const std::byte*>(p_readback.m_buffer->get_mapped_data()), p_readback.m_format, image.Pixels);
+
+            //the pixels are copied out, the buffer can take the next capture
+            {
+                std::scoped_lock lock{ m_free_mutex };
+                m_free_buffers.push_back(std::move(p_readback.m_buffer));
+            }
+
+            p_readback.m_callback(image);
+        }
+        catch (const std::exception& p_exception)
+        {
+            VI_CORE_ERROR("Readback failed: {}", p_exception.what());
+        }
+
+        if (p_readback.m_buffer)
+        {
+            std::scoped_lock lock{ m_free_mutex };
+            m_free_buffers.push_back(std::move(p_readback.m_buffer));
+        }
+    }
+}
@@ -0,0 +1,73 @@
+#ifndef VULKAN_READBACK_HPP
+#define VULKAN_READBACK_HPP
+
+#include "Viking/core/ThreadPool.hpp"
+#include "Viking/renderer/ImageFile.hpp"
+
+#include <vulkan/vulkan.hpp>
+
+#include <vk_mem_alloc.h>
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace vulkan
+{
+    class Buffer;
+    class Image;
+    class Timeline;
+
+    //Copies images into host visible buffers on the frame's command buffer and reads them back once the GPU is done.
+    //Nothing waits for the GPU: completed copies are found by polling the graphics timeline, converted to 8 bit RGBA
+    //and handed to the callback on a worker thread, so dumping frames never stalls the render loop
+    class Readback
+    {
+    public:
+        using Callback = std::function<void(const vi::ImageData&)>;
+
+        void init(VkDevice p_device, VmaAllocator p_allocator, Timeline& p_timeline);
+        //Waits for the readbacks already submitted and runs their callbacks before returning
+        void cleanup();
+
+        [[nodiscard]] static bool is_supported(VkFormat p_format);
+
+        //Records a copy of the first mip level and layer of p_image, which has to be in TRANSFER_SRC_OPTIMAL.
+        //p_callback runs on the worker thread once the submission signalling p_timeline_value has completed
+        void record(VkCommandBuffer p_cmd, VkImage p_image, VkFormat p_format, VkExtent3D p_extent, uint64_t p_timeline_value, Callback p_callback);
+        //Same for an image tracking its own state, the transition to a transfer source is recorded as well
+        void record(VkCommandBuffer p_cmd, Image& p_image, uint64_t p_timeline_value, Callback p_callback);
+
+        //Passes every readback whose submission has completed to the worker thread, never blocks
+        void collect();
+
+    private:
+        struct PendingReadback
+        {
+            uint64_t m_timeline_value{};
+            std::shared_ptr<Buffer> m_buffer{};
+            VkFormat m_format{};
+            VkExtent3D m_extent{};
+            Callback m_callback{};
+        };
+
+        [[nodiscard]] std::shared_ptr<Buffer> acquire_buffer(VkDeviceSize p_size);
+        void process(PendingReadback p_readback);
+
+        VkDevice m_device{};
+        VmaAllocator m_allocator{};
+        Timeline* m_timeline{};
+
+        vi::ThreadPool m_thread_pool{};
+        std::deque<PendingReadback> m_pending{};
+
+        //buffers go back here once the worker is done with them, so steady captures do not allocate
+        std::mutex m_free_mutex{};
+        std::vector<std::shared_ptr<Buffer>> m_free_buffers{};
+    };
+}
+
+#endif // VULKAN_READBACK_HPP
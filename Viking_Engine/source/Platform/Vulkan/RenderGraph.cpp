@@ -0,0 +1,642 @@
+#include "Platform/Vulkan/RenderGraph.hpp"
+
+#include "Platform/Vulkan/Buffer.hpp"
+#include "Platform/Vulkan/GpuProfiler.hpp"
+#include "Platform/Vulkan/Image.hpp"
+#include "Viking/core/Log.hpp"
+
+#include <vulkan/vk_enum_string_helper.h>
+
+#include <algorithm>
+#include <format>
+#include <numeric>
+#include <ranges>
+#include <stdexcept>
+
+namespace
+{
+    bool lifetimes_overlap(const uint32_t p_first_a, const uint32_t p_last_a, const uint32_t p_first_b, const uint32_t p_last_b)
+    {
+        return !(p_last_a < p_first_b || p_last_b < p_first_a);
+    }
+}
+
+namespace vulkan
+{
+    VkImage RenderGraphResources::get_image(const RenderGraphImage p_image) const
+    {
+        return m_graph.m_images.at(p_image.id).m_image;
+    }
+
+    VkImageView RenderGraphResources::get_image_view(const RenderGraphImage p_image) const
+    {
+        return m_graph.m_images.at(p_image.id).m_image_view;
+    }
+
+    VkExtent3D RenderGraphResources::get_extent(const RenderGraphImage p_image) const
+    {
+        return m_graph.m_images.at(p_image.id).m_extent;
+    }
+
+    VkFormat RenderGraphResources::get_format(const RenderGraphImage p_image) const
+    {
+        return m_graph.m_images.at(p_image.id).m_format;
+    }
+
+    VkBuffer RenderGraphResources::get_buffer(const RenderGraphBuffer p_buffer) const
+    {
+        return m_graph.m_buffers.at(p_buffer.id).m_buffer;
+    }
+
+    void RenderGraphBuilder::read(const RenderGraphImage p_image, const ImageUsage p_usage)
+    {
+        m_graph.m_passes.at(m_pass_index).m_image_accesses.push_back({ .m_id = p_image.id, .m_usage = p_usage, .m_write = false });
+    }
+
+    void RenderGraphBuilder::write(const RenderGraphImage p_image, const ImageUsage p_usage, const bool p_discard)
+    {
+        m_graph.m_passes.at(m_pass_index).m_image_accesses.push_back({ .m_id = p_image.id, .m_usage = p_usage, .m_write = true, .m_discard = p_discard });
+    }
+
+    void RenderGraphBuilder::read(const RenderGraphBuffer p_buffer, const BufferUsage p_usage)
+    {
+        m_graph.m_passes.at(m_pass_index).m_buffer_accesses.push_back({ .m_id = p_buffer.id, .m_usage = p_usage, .m_write = false });
+    }
+
+    void RenderGraphBuilder::write(const RenderGraphBuffer p_buffer, const BufferUsage p_usage)
+    {
+        m_graph.m_passes.at(m_pass_index).m_buffer_accesses.push_back({ .m_id = p_buffer.id, .m_usage = p_usage, .m_write = true });
+    }
+
+    void RenderGraphBuilder::side_effect()
+    {
+        m_graph.m_passes.at(m_pass_index).m_side_effect = true;
+    }
+
+    void RenderGraph::init(const VkDevice p_device, const VmaAllocator p_allocator, const uint32_t p_graphics_family, const uint32_t p_compute_family)
+    {
+        m_device = p_device;
+        m_allocator = p_allocator;
+        m_graphics_family = p_graphics_family;
+        m_compute_family = p_compute_family;
+    }
+
+    void RenderGraph::cleanup()
+    {
+        vi::DeletionQueue deletion_queue{};
+        retire_transients(deletion_queue);
+        deletion_queue.flush();
+
+        reset();
+    }
+
+    void RenderGraph::reset()
+    {
+        m_images.clear();
+        m_buffers.clear();
+        m_passes.clear();
+    }
+
+    RenderGraphImage RenderGraph::import_image(const std::string_view p_name, Image& p_image)
+    {
+        const auto allocated_image = p_image.get_allocated_image();
+        return import_image(p_name, allocated_image.image, allocated_image.image_view, allocated_image.image_format, allocated_image.image_extent, p_image.get_state());
+    }
+
+    RenderGraphImage RenderGraph::import_image(const std::string_view p_name, const VkImage p_image, const VkImageView p_image_view, const VkFormat p_format, const VkExtent3D p_extent, ImageState& p_state)
+    {
+        m_images.push_back({
+            .m_name = std::string{ p_name },
+            .m_image = p_image,
+            .m_image_view = p_image_view,
+            .m_format = p_format,
+            .m_extent = p_extent,
+            .m_state = &p_state
+        });
+
+        return { static_cast<uint32_t>(m_images.size() - 1) };
+    }
+
+    RenderGraphBuffer RenderGraph::import_buffer(const std::string_view p_name, Buffer& p_buffer)
+    {
+        m_buffers.push_back({
+            .m_name = std::string{ p_name },
+            .m_buffer = p_buffer.get_buffer(),
+            .m_state = &p_buffer.get_state()
+        });
+
+        return { static_cast<uint32_t>(m_buffers.size() - 1) };
+    }
+
+    RenderGraphImage RenderGraph::create_image(const std::string_view p_name, const TransientImageDesc& p_desc)
+    {
+        //the physical image is only known once the graph is compiled
+        m_images.push_back({
+            .m_name = std::string{ p_name },
+            .m_format = p_desc.format,
+            .m_extent = p_desc.extent,
+            .m_transient_desc = p_desc
+        });
+
+        return { static_cast<uint32_t>(m_images.size() - 1) };
+    }
+
+    void RenderGraph::export_image(const RenderGraphImage p_image, const std::optional<ImageUsage> p_final_usage)
+    {
+        auto& image = m_images.at(p_image.id);
+        if (image.m_transient_desc)
+        {
+            throw std::runtime_error(std::format("Transient image {} cannot be exported from the render graph", image.m_name));
+        }
+
+        image.m_exported = true;
+        image.m_final_usage = p_final_usage;
+    }
+
+    void RenderGraph::export_buffer(const RenderGraphBuffer p_buffer)
+    {
+        m_buffers.at(p_buffer.id).m_exported = true;
+    }
+
+    void RenderGraph::add_pass(const std::string_view p_name, const SetupFunction& p_setup, ExecuteFunction p_execute, const RenderGraphQueue p_queue)
+    {
+        m_passes.push_back({ .m_name = std::string{ p_name }, .m_execute = std::move(p_execute), .m_queue = p_queue });
+
+        RenderGraphBuilder builder{ *this, static_cast<uint32_t>(m_passes.size() - 1) };
+        p_setup(builder);
+    }
+
+    RenderGraphSubmission RenderGraph::execute(const VkCommandBuffer p_graphics_cmd, const VkCommandBuffer p_compute_cmd, vi::DeletionQueue& p_retire_queue, GpuProfiler* p_profiler)
+    {
+        cull();
+        build_transients(p_retire_queue);
+
+        const RenderGraphResources resources{ *this };
+        RenderGraphSubmission submission{};
+
+        const auto is_async = [this](const uint32_t p_pass_index)
+        {
+            return !m_passes[p_pass_index].m_culled && m_passes[p_pass_index].m_queue == RenderGraphQueue::AsyncCompute;
+        };
+
+        const auto pass_indices = std::views::iota(0u, static_cast<uint32_t>(m_passes.size()));
+        submission.uses_async_compute = p_compute_cmd != VK_NULL_HANDLE && std::ranges::any_of(pass_indices, is_async);
+
+        if (submission.uses_async_compute)
+        {
+            validate_async_passes();
+
+            //earlier graphics work on these resources is ordered by the caller, not by barriers on the compute queue,
+            //whose stages may not even exist there
+            for (const auto pass_index : pass_indices | std::views::filter(is_async))
+            {
+                for (const auto& access : m_passes[pass_index].m_image_accesses)
+                {
+                    *m_images[access.m_id].m_state = {};
+                }
+                for (const auto& access : m_passes[pass_index].m_buffer_accesses)
+                {
+                    *m_buffers[access.m_id].m_state = {};
+                }
+            }
+
+            for (const auto pass_index : pass_indices | std::views::filter(is_async))
+            {
+                record_pass(p_compute_cmd, pass_index, resources, nullptr);
+            }
+
+            submission.graphics_wait_stage = transfer_async_resources(p_compute_cmd, p_graphics_cmd);
+        }
+
+        for (uint32_t pass_index = 0; pass_index < m_passes.size(); ++pass_index)
+        {
+            if (m_passes[pass_index].m_culled || (submission.uses_async_compute && is_async(pass_index)))
+            {
+                continue;
+            }
+
+            record_pass(p_graphics_cmd, pass_index, resources, p_profiler);
+        }
+
+        std::optional<GpuScope> scope;
+        if (p_profiler != nullptr)
+        {
+            scope.emplace(*p_profiler, p_graphics_cmd, "final transitions");
+        }
+
+        for (auto& image : m_images)
+        {
+            if (image.m_exported && image.m_final_usage)
+            {
+                m_barriers.transition(image.m_image, *image.m_state, image_state(*image.m_final_usage), aspect_from_format(image.m_format));
+            }
+        }
+        m_barriers.flush(p_graphics_cmd);
+
+        return submission;
+    }
+
+    void RenderGraph::record_pass(const VkCommandBuffer p_cmd, const uint32_t p_pass_index, const RenderGraphResources& p_resources, GpuProfiler* p_profiler)
+    {
+        auto& pass = m_passes[p_pass_index];
+
+        std::optional<GpuScope> scope;
+        if (p_profiler != nullptr)
+        {
+            scope.emplace(*p_profiler, p_cmd, pass.m_name);
+        }
+
+        for (const auto& access : pass.m_image_accesses)
+        {
+            auto& image = m_images[access.m_id];
+
+            //the first user of a transient inherits whatever last touched its memory, possibly another image
+            if (image.m_transient_index != INVALID_RENDER_GRAPH_RESOURCE && m_transient_lifetimes[image.m_transient_index].m_first_pass == p_pass_index)
+            {
+                const auto& block = m_memory_blocks[m_transient_images[image.m_transient_index].m_block];
+                *image.m_state = { VK_IMAGE_LAYOUT_UNDEFINED, block.m_state.stage, block.m_state.access };
+            }
+
+            m_barriers.transition(image.m_image, *image.m_state, image_state(access.m_usage), aspect_from_format(image.m_format), access.m_discard);
+        }
+
+        for (const auto& access : pass.m_buffer_accesses)
+        {
+            auto& buffer = m_buffers[access.m_id];
+            m_barriers.access(buffer.m_buffer, *buffer.m_state, buffer_state(access.m_usage));
+        }
+
+        //every transition the pass needs goes out in one barrier
+        m_barriers.flush(p_cmd);
+
+        pass.m_execute(p_cmd, p_resources);
+
+        for (const auto& access : pass.m_image_accesses)
+        {
+            const auto& image = m_images[access.m_id];
+            if (image.m_transient_index != INVALID_RENDER_GRAPH_RESOURCE && m_transient_lifetimes[image.m_transient_index].m_last_pass == p_pass_index)
+            {
+                m_memory_blocks[m_transient_images[image.m_transient_index].m_block].m_state = *image.m_state;
+            }
+        }
+    }
+
+    void RenderGraph::validate_async_passes() const
+    {
+        std::vector<bool> image_touched(m_images.size(), false);
+        std::vector<bool> buffer_touched(m_buffers.size(), false);
+        std::vector<bool> image_on_graphics(m_images.size(), false);
+        std::vector<bool> buffer_on_graphics(m_buffers.size(), false);
+
+        for (const auto& pass : m_passes)
+        {
+            if (pass.m_culled)
+            {
+                continue;
+            }
+
+            if (pass.m_queue == RenderGraphQueue::Graphics)
+            {
+                for (const auto& access : pass.m_image_accesses)
+                {
+                    image_on_graphics[access.m_id] = true;
+                }
+                for (const auto& access : pass.m_buffer_accesses)
+                {
+                    buffer_on_graphics[access.m_id] = true;
+                }
+                continue;
+            }
+
+            for (const auto& access : pass.m_image_accesses)
+            {
+                const auto& image = m_images[access.m_id];
+                if (image_on_graphics[access.m_id])
+                {
+                    throw std::runtime_error(std::format("Async compute pass {} uses image {} after a graphics pass", pass.m_name, image.m_name));
+                }
+                if (image.m_transient_desc)
+                {
+                    throw std::runtime_error(std::format("Async compute pass {} cannot use transient image {}", pass.m_name, image.m_name));
+                }
+                //the graphics family owns the contents, only a discarding write can start without acquiring them
+                if (!image_touched[access.m_id] && !access.m_discard)
+                {
+                    throw std::runtime_error(std::format("Async compute pass {} has to discard image {} on first use", pass.m_name, image.m_name));
+                }
+                image_touched[access.m_id] = true;
+            }
+
+            for (const auto& access : pass.m_buffer_accesses)
+            {
+                const auto& buffer = m_buffers[access.m_id];
+                if (buffer_on_graphics[access.m_id])
+                {
+                    throw std::runtime_error(std::format("Async compute pass {} uses buffer {} after a graphics pass", pass.m_name, buffer.m_name));
+                }
+                if (!buffer_touched[access.m_id] && (buffer_state(access.m_usage).access & VK_ACCESS_2_SHADER_STORAGE_READ_BIT) != 0)
+                {
+                    throw std::runtime_error(std::format("Async compute pass {} has to fully write buffer {} before reading it", pass.m_name, buffer.m_name));
+                }
+                buffer_touched[access.m_id] = true;
+            }
+        }
+    }
+
+    VkPipelineStageFlags2 RenderGraph::transfer_async_resources(const VkCommandBuffer p_compute_cmd, const VkCommandBuffer p_graphics_cmd)
+    {
+        //first access of every resource on each side of the queue boundary
+        std::vector<std::optional<ImageState>> image_targets(m_images.size());
+        std::vector<std::optional<BufferState>> buffer_targets(m_buffers.size());
+        std::vector<bool> image_released(m_images.size(), false);
+        std::vector<bool> buffer_released(m_buffers.size(), false);
+
+        for (const auto& pass : m_passes)
+        {
+            if (pass.m_culled)
+            {
+                continue;
+            }
+
+            for (const auto& access : pass.m_image_accesses)
+            {
+                if (pass.m_queue == RenderGraphQueue::AsyncCompute)
+                {
+                    image_released[access.m_id] = true;
+                }
+                else if (!image_targets[access.m_id])
+                {
+                    image_targets[access.m_id] = image_state(access.m_usage);
+                }
+            }
+
+            for (const auto& access : pass.m_buffer_accesses)
+            {
+                if (pass.m_queue == RenderGraphQueue::AsyncCompute)
+                {
+                    buffer_released[access.m_id] = true;
+                }
+                else if (!buffer_targets[access.m_id])
+                {
+                    buffer_targets[access.m_id] = buffer_state(access.m_usage);
+                }
+            }
+        }
+
+        BarrierBatch acquire{};
+        for (uint32_t image_index = 0; image_index < m_images.size(); ++image_index)
+        {
+            if (!image_released[image_index])
+            {
+                continue;
+            }
+
+            //resources nobody reads on graphics still go back, the next frame expects them there
+            auto& image = m_images[image_index];
+            const auto target = image_targets[image_index].value_or(ImageState{ image.m_state->layout, VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE });
+            m_barriers.transfer(image.m_image, *image.m_state, target, m_compute_family, m_graphics_family, acquire, aspect_from_format(image.m_format));
+        }
+
+        for (uint32_t buffer_index = 0; buffer_index < m_buffers.size(); ++buffer_index)
+        {
+            if (!buffer_released[buffer_index])
+            {
+                continue;
+            }
+
+            auto& buffer = m_buffers[buffer_index];
+            const auto target = buffer_targets[buffer_index].value_or(BufferState{});
+            m_barriers.transfer(buffer.m_buffer, *buffer.m_state, target, m_compute_family, m_graphics_family, acquire);
+        }
+
+        m_barriers.flush(p_compute_cmd);
+
+        const auto wait_stage = acquire.get_dst_stages();
+        acquire.flush(p_graphics_cmd);
+
+        return wait_stage != VK_PIPELINE_STAGE_2_NONE ? wait_stage : VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+    }
+
+    void RenderGraph::cull()
+    {
+        std::vector<bool> image_needed(m_images.size(), false);
+        std::vector<bool> buffer_needed(m_buffers.size(), false);
+
+        for (size_t i = 0; i < m_images.size(); ++i)
+        {
+            image_needed[i] = m_images[i].m_exported;
+        }
+        for (size_t i = 0; i < m_buffers.size(); ++i)
+        {
+            buffer_needed[i] = m_buffers[i].m_exported;
+        }
+
+        //walk backwards from the outputs, a pass is kept if it writes something a later kept pass or an output needs
+        for (auto& pass : std::views::reverse(m_passes))
+        {
+            const auto writes_needed_image = std::ranges::any_of(pass.m_image_accesses, [&image_needed](const ImageAccess& p_access)
+            {
+                return p_access.m_write && image_needed[p_access.m_id];
+            });
+            const auto writes_needed_buffer = std::ranges::any_of(pass.m_buffer_accesses, [&buffer_needed](const BufferAccess& p_access)
+            {
+                return p_access.m_write && buffer_needed[p_access.m_id];
+            });
+
+            pass.m_culled = !(pass.m_side_effect || writes_needed_image || writes_needed_buffer);
+            if (pass.m_culled)
+            {
+                continue;
+            }
+
+            //a full overwrite makes earlier writers of the image irrelevant
+            for (const auto& access : pass.m_image_accesses)
+            {
+                if (access.m_write && access.m_discard)
+                {
+                    image_needed[access.m_id] = false;
+                }
+            }
+
+            for (const auto& access : pass.m_image_accesses)
+            {
+                if (!access.m_write)
+                {
+                    image_needed[access.m_id] = true;
+                }
+            }
+
+            for (const auto& access : pass.m_buffer_accesses)
+            {
+                if (!access.m_write)
+                {
+                    buffer_needed[access.m_id] = true;
+                }
+            }
+        }
+    }
+
+    void RenderGraph::build_transients(vi::DeletionQueue& p_retire_queue)
+    {
+        //lifetimes of the transients that survived culling, in declaration order
+        std::vector<TransientLifetime> lifetimes{};
+        std::vector<uint32_t> lifetime_images{};
+
+        for (uint32_t image_index = 0; image_index < m_images.size(); ++image_index)
+        {
+            const auto& image = m_images[image_index];
+            if (!image.m_transient_desc)
+            {
+                continue;
+            }
+
+            std::optional<TransientLifetime> lifetime{};
+            for (uint32_t pass_index = 0; pass_index < m_passes.size(); ++pass_index)
+            {
+                const auto& pass = m_passes[pass_index];
+                if (pass.m_culled || std::ranges::none_of(pass.m_image_accesses, [image_index](const ImageAccess& p_access) { return p_access.m_id == image_index; }))
+                {
+                    continue;
+                }
+
+                if (!lifetime)
+                {
+                    lifetime = TransientLifetime{ .m_desc = *image.m_transient_desc, .m_first_pass = pass_index };
+                }
+                lifetime->m_last_pass = pass_index;
+            }
+
+            if (lifetime)
+            {
+                lifetimes.push_back(*lifetime);
+                lifetime_images.push_back(image_index);
+            }
+        }
+
+        if (lifetimes != m_transient_lifetimes)
+        {
+            retire_transients(p_retire_queue);
+            m_transient_lifetimes = lifetimes;
+
+            //create the images first, their memory requirements decide what can share a block
+            m_transient_images.resize(lifetimes.size());
+            for (size_t i = 0; i < lifetimes.size(); ++i)
+            {
+                const auto& desc = lifetimes[i].m_desc;
+                const auto image_info = image_create_info(desc.format, desc.usage, desc.extent);
+
+                if (const auto result = vkCreateImage(m_device, &image_info, nullptr, &m_transient_images[i].m_image); result != VK_SUCCESS)
+                {
+                    throw std::runtime_error(std::format("Cannot create transient image {}: {}", m_images[lifetime_images[i]].m_name, string_VkResult(result)));
+                }
+
+                vkGetImageMemoryRequirements(m_device, m_transient_images[i].m_image, &m_transient_images[i].m_requirements);
+            }
+
+            //largest first, each image goes into the first block whose users are all dead or not yet born
+            std::vector<uint32_t> order(lifetimes.size());
+            std::iota(order.begin(), order.end(), 0u);
+            std::ranges::sort(order, [this](const uint32_t p_a, const uint32_t p_b)
+            {
+                return m_transient_images[p_a].m_requirements.size > m_transient_images[p_b].m_requirements.size;
+            });
+
+            for (const auto image_index : order)
+            {
+                auto& transient = m_transient_images[image_index];
+                const auto& lifetime = lifetimes[image_index];
+
+                const auto block = std::ranges::find_if(m_memory_blocks, [&](const MemoryBlock& p_block)
+                {
+                    if ((p_block.m_requirements.memoryTypeBits & transient.m_requirements.memoryTypeBits) == 0)
+                    {
+                        return false;
+                    }
+
+                    return std::ranges::none_of(p_block.m_images, [&](const uint32_t p_other)
+                    {
+                        return lifetimes_overlap(lifetime.m_first_pass, lifetime.m_last_pass, lifetimes[p_other].m_first_pass, lifetimes[p_other].m_last_pass);
+                    });
+                });
+
+                if (block == m_memory_blocks.end())
+                {
+                    transient.m_block = static_cast<uint32_t>(m_memory_blocks.size());
+                    m_memory_blocks.push_back({ .m_requirements = transient.m_requirements, .m_images = { image_index } });
+                    continue;
+                }
+
+                block->m_requirements.size = std::max(block->m_requirements.size, transient.m_requirements.size);
+                block->m_requirements.alignment = std::max(block->m_requirements.alignment, transient.m_requirements.alignment);
+                block->m_requirements.memoryTypeBits &= transient.m_requirements.memoryTypeBits;
+                block->m_images.push_back(image_index);
+                transient.m_block = static_cast<uint32_t>(std::distance(m_memory_blocks.begin(), block));
+            }
+
+            VmaAllocationCreateInfo alloc_info{};
+            alloc_info.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+            alloc_info.requiredFlags = static_cast<VkMemoryPropertyFlags>(VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+            for (auto& block : m_memory_blocks)
+            {
+                if (const auto result = vmaAllocateMemory(m_allocator, &block.m_requirements, &alloc_info, &block.m_allocation, nullptr); result != VK_SUCCESS)
+                {
+                    throw std::runtime_error(std::format("Cannot allocate transient memory: {}", string_VkResult(result)));
+                }
+
+                for (const auto image_index : block.m_images)
+                {
+                    auto& transient = m_transient_images[image_index];
+                    if (const auto result = vmaBindImageMemory(m_allocator, block.m_allocation, transient.m_image); result != VK_SUCCESS)
+                    {
+                        throw std::runtime_error(std::format("Cannot bind transient image memory: {}", string_VkResult(result)));
+                    }
+
+                    const auto& desc = lifetimes[image_index].m_desc;
+                    const auto view_info = imageview_create_info(desc.format, transient.m_image, aspect_from_format(desc.format));
+                    if (const auto result = vkCreateImageView(m_device, &view_info, nullptr, &transient.m_image_view); result != VK_SUCCESS)
+                    {
+                        throw std::runtime_error(std::format("Cannot create transient image view: {}", string_VkResult(result)));
+                    }
+                }
+            }
+
+            VI_CORE_TRACE("Render graph placed {} transient images in {} memory blocks", m_transient_images.size(), m_memory_blocks.size());
+        }
+
+        for (size_t i = 0; i < lifetime_images.size(); ++i)
+        {
+            auto& image = m_images[lifetime_images[i]];
+            auto& transient = m_transient_images[i];
+            image.m_transient_index = static_cast<uint32_t>(i);
+            image.m_image = transient.m_image;
+            image.m_image_view = transient.m_image_view;
+            image.m_state = &transient.m_state;
+        }
+    }
+
+    void RenderGraph::retire_transients(vi::DeletionQueue& p_retire_queue)
+    {
+        if (m_transient_images.empty() && m_memory_blocks.empty())
+        {
+            return;
+        }
+
+        p_retire_queue.push_function([device = m_device, allocator = m_allocator, images = m_transient_images, blocks = m_memory_blocks]()
+        {
+            std::ranges::for_each(images, [device](const TransientImage& p_image)
+            {
+                vkDestroyImageView(device, p_image.m_image_view, nullptr);
+                vkDestroyImage(device, p_image.m_image, nullptr);
+            });
+            std::ranges::for_each(blocks, [allocator](const MemoryBlock& p_block)
+            {
+                vmaFreeMemory(allocator, p_block.m_allocation);
+            });
+        });
+
+        m_transient_images.clear();
+        m_memory_blocks.clear();
+        m_transient_lifetimes.clear();
+    }
+}
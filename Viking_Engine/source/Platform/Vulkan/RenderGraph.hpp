@@ -0,0 +1,245 @@
+#ifndef VULKAN_RENDER_GRAPH_HPP
+#define VULKAN_RENDER_GRAPH_HPP
+
+#include "Platform/Vulkan/Barrier.hpp"
+#include "Viking/core/DeletionQueue.hpp"
+
+#include <vulkan/vulkan.hpp>
+
+#include <vk_mem_alloc.h>
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace vulkan
+{
+    class Buffer;
+    class GpuProfiler;
+    class Image;
+    class RenderGraph;
+
+    constexpr uint32_t INVALID_RENDER_GRAPH_RESOURCE{ std::numeric_limits<uint32_t>::max() };
+
+    struct RenderGraphImage
+    {
+        uint32_t id{ INVALID_RENDER_GRAPH_RESOURCE };
+    };
+
+    struct RenderGraphBuffer
+    {
+        uint32_t id{ INVALID_RENDER_GRAPH_RESOURCE };
+    };
+
+    enum class RenderGraphQueue
+    {
+        Graphics,
+        //Runs on the compute queue when there is one, ahead of every graphics pass of the frame
+        AsyncCompute
+    };
+
+    //What the caller has to do with the command buffers the graph recorded
+    struct RenderGraphSubmission
+    {
+        //the compute command buffer has to be submitted before the graphics one
+        bool uses_async_compute{ false };
+        //stage at which the graphics submission waits for the compute one
+        VkPipelineStageFlags2 graphics_wait_stage{ VK_PIPELINE_STAGE_2_NONE };
+    };
+
+    //Images that only live between the passes of one frame, the graph owns them and may alias their memory
+    struct TransientImageDesc
+    {
+        VkExtent3D extent{};
+        VkFormat format{ VK_FORMAT_UNDEFINED };
+        VkImageUsageFlags usage{};
+
+        bool operator==(const TransientImageDesc&) const = default;
+    };
+
+    //Gives a pass the physical handles behind the graph resources it declared
+    class RenderGraphResources
+    {
+    public:
+        explicit RenderGraphResources(const RenderGraph& p_graph): m_graph{ p_graph } {}
+
+        [[nodiscard]] VkImage get_image(RenderGraphImage p_image) const;
+        [[nodiscard]] VkImageView get_image_view(RenderGraphImage p_image) const;
+        [[nodiscard]] VkExtent3D get_extent(RenderGraphImage p_image) const;
+        [[nodiscard]] VkFormat get_format(RenderGraphImage p_image) const;
+        [[nodiscard]] VkBuffer get_buffer(RenderGraphBuffer p_buffer) const;
+
+    private:
+        const RenderGraph& m_graph;
+    };
+
+    //Collects the accesses of a single pass while it is being set up
+    class RenderGraphBuilder
+    {
+    public:
+        RenderGraphBuilder(RenderGraph& p_graph, const uint32_t p_pass_index): m_graph{ p_graph }, m_pass_index{ p_pass_index } {}
+
+        void read(RenderGraphImage p_image, ImageUsage p_usage);
+        //With p_discard the pass overwrites the whole image, so earlier writers are not needed
+        void write(RenderGraphImage p_image, ImageUsage p_usage, bool p_discard = false);
+        void read(RenderGraphBuffer p_buffer, BufferUsage p_usage);
+        void write(RenderGraphBuffer p_buffer, BufferUsage p_usage);
+
+        //The pass does something the graph cannot see (readback, timestamps...) and is never culled
+        void side_effect();
+
+    private:
+        RenderGraph& m_graph;
+        uint32_t m_pass_index{};
+    };
+
+    //Per-frame graph of passes. Passes are recorded in the order they are added; passes whose results
+    //never reach an exported resource are culled, barriers between passes are derived from the declared
+    //accesses, and transient images with disjoint lifetimes share the same device memory.
+    //The graph is rebuilt every frame, the physical transient images are kept as long as the
+    //transient declarations and their lifetimes do not change.
+    class RenderGraph
+    {
+        friend class RenderGraphBuilder;
+        friend class RenderGraphResources;
+
+    public:
+        using SetupFunction = std::function<void(RenderGraphBuilder&)>;
+        using ExecuteFunction = std::function<void(VkCommandBuffer, const RenderGraphResources&)>;
+
+        void init(VkDevice p_device, VmaAllocator p_allocator, uint32_t p_graphics_family, uint32_t p_compute_family);
+        void cleanup();
+
+        //Drops the passes and resources of the previous frame, transient memory is kept
+        void reset();
+
+        [[nodiscard]] RenderGraphImage import_image(std::string_view p_name, Image& p_image);
+        [[nodiscard]] RenderGraphImage import_image(std::string_view p_name, VkImage p_image, VkImageView p_image_view, VkFormat p_format, VkExtent3D p_extent, ImageState& p_state);
+        [[nodiscard]] RenderGraphBuffer import_buffer(std::string_view p_name, Buffer& p_buffer);
+        [[nodiscard]] RenderGraphImage create_image(std::string_view p_name, const TransientImageDesc& p_desc);
+
+        //Exported resources are the outputs of the frame, everything that does not contribute to them is culled.
+        //An exported image is left in p_final_usage once the graph has run
+        void export_image(RenderGraphImage p_image, std::optional<ImageUsage> p_final_usage = std::nullopt);
+        void export_buffer(RenderGraphBuffer p_buffer);
+
+        void add_pass(std::string_view p_name, const SetupFunction& p_setup, ExecuteFunction p_execute, RenderGraphQueue p_queue = RenderGraphQueue::Graphics);
+
+        //Compiles and records the graph. Transient memory replaced because the graph changed
+        //is pushed into p_retire_queue, as frames in flight may still use it.
+        //With a profiler every graphics pass, together with the barriers it needs, is timed under its name.
+        //Async compute passes go into p_compute_cmd, or are recorded in order with the others when it is null.
+        //They are hoisted in front of the graphics passes, so they may not depend on them, may only start
+        //from discarded images or fully written buffers, and cannot use transient images. Everything they
+        //touch is handed back to the graphics queue family at the end of the compute command buffer.
+        //Resources they write must not be in use by earlier graphics submissions, e.g. one image per frame in flight
+        RenderGraphSubmission execute(VkCommandBuffer p_graphics_cmd, VkCommandBuffer p_compute_cmd, vi::DeletionQueue& p_retire_queue, GpuProfiler* p_profiler = nullptr);
+
+    private:
+        struct ImageResource
+        {
+            std::string m_name{};
+            VkImage m_image{};
+            VkImageView m_image_view{};
+            VkFormat m_format{};
+            VkExtent3D m_extent{};
+            ImageState* m_state{};
+            std::optional<TransientImageDesc> m_transient_desc{};
+            uint32_t m_transient_index{ INVALID_RENDER_GRAPH_RESOURCE };
+            bool m_exported{ false };
+            std::optional<ImageUsage> m_final_usage{};
+        };
+
+        struct BufferResource
+        {
+            std::string m_name{};
+            VkBuffer m_buffer{};
+            BufferState* m_state{};
+            bool m_exported{ false };
+        };
+
+        struct ImageAccess
+        {
+            uint32_t m_id{};
+            ImageUsage m_usage{};
+            bool m_write{ false };
+            bool m_discard{ false };
+        };
+
+        struct BufferAccess
+        {
+            uint32_t m_id{};
+            BufferUsage m_usage{};
+            bool m_write{ false };
+        };
+
+        struct Pass
+        {
+            std::string m_name{};
+            ExecuteFunction m_execute{};
+            std::vector<ImageAccess> m_image_accesses{};
+            std::vector<BufferAccess> m_buffer_accesses{};
+            RenderGraphQueue m_queue{ RenderGraphQueue::Graphics };
+            bool m_side_effect{ false };
+            bool m_culled{ false };
+        };
+
+        //Lifetime of a transient image in alive pass indices
+        struct TransientLifetime
+        {
+            TransientImageDesc m_desc{};
+            uint32_t m_first_pass{};
+            uint32_t m_last_pass{};
+
+            bool operator==(const TransientLifetime&) const = default;
+        };
+
+        struct TransientImage
+        {
+            VkImage m_image{};
+            VkImageView m_image_view{};
+            VkMemoryRequirements m_requirements{};
+            ImageState m_state{};
+            uint32_t m_block{};
+        };
+
+        //Device memory shared by transient images whose lifetimes do not overlap.
+        //The state is the last access to the memory, whichever image made it
+        struct MemoryBlock
+        {
+            VmaAllocation m_allocation{};
+            VkMemoryRequirements m_requirements{};
+            std::vector<uint32_t> m_images{};
+            ImageState m_state{};
+        };
+
+        void cull();
+        void validate_async_passes() const;
+        void record_pass(VkCommandBuffer p_cmd, uint32_t p_pass_index, const RenderGraphResources& p_resources, GpuProfiler* p_profiler);
+        //Releases everything the compute passes touched to the graphics family, returns the stages waiting on it
+        VkPipelineStageFlags2 transfer_async_resources(VkCommandBuffer p_compute_cmd, VkCommandBuffer p_graphics_cmd);
+        void build_transients(vi::DeletionQueue& p_retire_queue);
+        void retire_transients(vi::DeletionQueue& p_retire_queue);
+
+        VkDevice m_device{};
+        VmaAllocator m_allocator{};
+        uint32_t m_graphics_family{};
+        uint32_t m_compute_family{};
+
+        std::vector<ImageResource> m_images{};
+        std::vector<BufferResource> m_buffers{};
+        std::vector<Pass> m_passes{};
+
+        std::vector<TransientLifetime> m_transient_lifetimes{};
+        std::vector<TransientImage> m_transient_images{};
+        std::vector<MemoryBlock> m_memory_blocks{};
+
+        BarrierBatch m_barriers{};
+    };
+}
+
+#endif // VULKAN_RENDER_GRAPH_HPP
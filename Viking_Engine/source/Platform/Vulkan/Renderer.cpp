@@ -1,5 +1,19 @@
 #include "Platform/Vulkan/Renderer.hpp"
+#include "Platform/Vulkan/BindlessHeap.hpp"
 #include "Platform/Vulkan/Context.hpp"
+#include "Platform/Vulkan/Descriptors.hpp"
+#include "Platform/Vulkan/DynamicResolution.hpp"
+#include "Platform/Vulkan/FrameAllocator.hpp"
+#include "Platform/Vulkan/GpuProfiler.hpp"
+#include "Platform/Vulkan/Image.hpp"
+#include "Platform/Vulkan/MeshRenderer.hpp"
+#include "Platform/Vulkan/ParallelRecorder.hpp"
+#include "Platform/Vulkan/Pipeline.hpp"
+#include "Platform/Vulkan/Readback.hpp"
+#include "Platform/Vulkan/RenderGraph.hpp"
+#include "Platform/Vulkan/Shader.hpp"
+#include "Platform/Vulkan/TextureLoader.hpp"
+#include "Platform/Vulkan/UploadEngine.hpp"
 
 #include "Viking/core/Log.hpp"
 
@@ -8,6 +22,14 @@
 
 #include <Viking/core/DeletionQueue.hpp>
 
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <vector>
+
 namespace utils
 {
     constexpr uint64_t ONE_SECOND_IN_NS{ 1000000000 };
@@ -33,17 +55,6 @@ namespace utils
         return info;
     }
 
-    [[nodiscard]] VkFenceCreateInfo fence_create_info(const VkFenceCreateFlags p_flags)
-    {
-        VkFenceCreateInfo info;
-        info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-        info.pNext = nullptr;
-
-        info.flags = p_flags;
-
-        return info;
-    }
-
     [[nodiscard]] VkSemaphoreCreateInfo semaphore_create_info(const VkSemaphoreCreateFlags p_flags)
     {
         VkSemaphoreCreateInfo info;
@@ -76,34 +87,7 @@ namespace utils
         return sub_image;
     }
 
-    void transition_image(const VkCommandBuffer p_cmd, const VkImage p_image, const VkImageLayout p_current_layout, const VkImageLayout p_new_layout)
-    {
-        VkImageMemoryBarrier2 image_barrier{ .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2 };
-        image_barrier.pNext = nullptr;
-
-        image_barrier.srcStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
-        image_barrier.srcAccessMask = VK_ACCESS_2_MEMORY_WRITE_BIT;
-        image_barrier.dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
-        image_barrier.dstAccessMask = VK_ACCESS_2_MEMORY_WRITE_BIT | VK_ACCESS_2_MEMORY_READ_BIT;
-
-        image_barrier.oldLayout = p_current_layout;
-        image_barrier.newLayout = p_new_layout;
-
-        const auto aspect_mask = (p_new_layout == VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL) ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
-        image_barrier.subresourceRange = image_subresource_range(aspect_mask);
-        image_barrier.image = p_image;
-
-        VkDependencyInfo dep_info{};
-        dep_info.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
-        dep_info.pNext = nullptr;
-
-        dep_info.imageMemoryBarrierCount = 1;
-        dep_info.pImageMemoryBarriers = &image_barrier;
-
-        vkCmdPipelineBarrier2(p_cmd, &dep_info);
-    }
-
-    VkSemaphoreSubmitInfo semaphore_submit_info(const VkPipelineStageFlags2 p_stage_mask, const VkSemaphore p_semaphore)
+    VkSemaphoreSubmitInfo semaphore_submit_info(const VkPipelineStageFlags2 p_stage_mask, const VkSemaphore p_semaphore, const uint64_t p_value = 1)
     {
         VkSemaphoreSubmitInfo submit_info;
         submit_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
@@ -111,7 +95,8 @@ namespace utils
         submit_info.semaphore = p_semaphore;
         submit_info.stageMask = p_stage_mask;
         submit_info.deviceIndex = 0;
-        submit_info.value = 1;
+        //ignored for binary semaphores
+        submit_info.value = p_value;
 
         return submit_info;
     }
@@ -127,17 +112,50 @@ namespace utils
         return info;
     }
 
-    VkSubmitInfo2 submit_info(const VkCommandBufferSubmitInfo* p_cmd, const VkSemaphoreSubmitInfo* p_signal_semaphore_info, const VkSemaphoreSubmitInfo* p_wait_semaphore_info)
+    //Without a clear value the attachment keeps its contents
+    VkRenderingAttachmentInfo attachment_info(const VkImageView p_view, const VkImageLayout p_layout, const std::optional<VkClearValue>& p_clear = std::nullopt)
+    {
+        VkRenderingAttachmentInfo info{};
+        info.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+        info.pNext = nullptr;
+        info.imageView = p_view;
+        info.imageLayout = p_layout;
+        info.loadOp = p_clear ? VK_ATTACHMENT_LOAD_OP_CLEAR : VK_ATTACHMENT_LOAD_OP_LOAD;
+        info.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+        if (p_clear)
+        {
+            info.clearValue = *p_clear;
+        }
+
+        return info;
+    }
+
+    VkRenderingInfo rendering_info(const VkExtent2D p_extent, const VkRenderingAttachmentInfo* p_color_attachment, const VkRenderingAttachmentInfo* p_depth_attachment)
+    {
+        VkRenderingInfo info{};
+        info.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+        info.pNext = nullptr;
+        info.renderArea = VkRect2D{ VkOffset2D{ 0, 0 }, p_extent };
+        info.layerCount = 1;
+        info.colorAttachmentCount = p_color_attachment != nullptr ? 1 : 0;
+        info.pColorAttachments = p_color_attachment;
+        info.pDepthAttachment = p_depth_attachment;
+        info.pStencilAttachment = nullptr;
+
+        return info;
+    }
+
+    VkSubmitInfo2 submit_info(const VkCommandBufferSubmitInfo* p_cmd, const std::span<const VkSemaphoreSubmitInfo> p_signal_semaphore_infos, const std::span<const VkSemaphoreSubmitInfo> p_wait_semaphore_infos)
     {
         VkSubmitInfo2 info = {};
         info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
         info.pNext = nullptr;
 
-        info.waitSemaphoreInfoCount = p_wait_semaphore_info == nullptr ? 0 : 1;
-        info.pWaitSemaphoreInfos = p_wait_semaphore_info;
+        info.waitSemaphoreInfoCount = static_cast<uint32_t>(p_wait_semaphore_infos.size());
+        info.pWaitSemaphoreInfos = p_wait_semaphore_infos.data();
 
-        info.signalSemaphoreInfoCount = p_signal_semaphore_info == nullptr ? 0 : 1;
-        info.pSignalSemaphoreInfos = p_signal_semaphore_info;
+        info.signalSemaphoreInfoCount = static_cast<uint32_t>(p_signal_semaphore_infos.size());
+        info.pSignalSemaphoreInfos = p_signal_semaphore_infos.data();
 
         info.commandBufferInfoCount = 1;
         info.pCommandBufferInfos = p_cmd;
@@ -154,61 +172,220 @@ namespace
         VkCommandBuffer m_main_command_buffer{};
         VkSemaphore m_swapchain_semaphore{};
         VkSemaphore m_render_semaphore{};
-        VkFence m_render_fence{};
+        //compute side of the frame, only used with an async compute queue
+        VkCommandPool m_compute_command_pool{};
+        VkCommandBuffer m_compute_command_buffer{};
+        //target of the async background pass. One per frame, so the compute queue never writes an image
+        //that graphics work of the previous frame may still be reading
+        std::shared_ptr<vulkan::Image> m_background_image{};
+        //sets only used by this frame, all released at once when the frame comes around again
+        vulkan::DescriptorAllocatorGrowable m_frame_descriptors{};
+        //uniforms and other data written by the CPU for this frame only
+        vulkan::FrameAllocator m_frame_allocator{};
+        //value of the graphics timeline signalled by the last submission of this frame
+        uint64_t m_timeline_value{};
+        vi::DeletionQueue m_deletion_queue{};
+    };
+
+    //Resources that were replaced while frames were still in flight, e.g. a retired swapchain.
+    //They are destroyed once the graphics timeline reaches the value of the last submission that could use them
+    struct RetiredResources
+    {
+        uint64_t m_timeline_value{};
         vi::DeletionQueue m_deletion_queue{};
     };
 
-    constexpr auto FRAME_OVERLAP{ 2 };
+    struct BackgroundConstants
+    {
+        std::array<float, 4> m_top_color{};
+        std::array<float, 4> m_bottom_color{};
+        std::array<int32_t, 2> m_offset{};
+        //size of the rendered area, which can be smaller than the image
+        std::array<int32_t, 2> m_extent{};
+    };
+
+    //stage at which the submission waits for the acquired swapchain image, its first use is the blit
+    constexpr VkPipelineStageFlags2 SWAPCHAIN_WAIT_STAGE{ VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT };
+
+    //how often the GPU timings are written to the log
+    constexpr uint32_t GPU_TIMINGS_LOG_INTERVAL{ 600 };
+
+    constexpr uint32_t MIN_FRAMES_IN_FLIGHT{ 1 };
+    constexpr uint32_t MAX_FRAMES_IN_FLIGHT{ 4 };
+
+    //sets the first pool of each frame holds, later pools are larger
+    constexpr uint32_t FRAME_DESCRIPTOR_SETS{ 1000 };
 
     class InternalRenderer
     {
     public:
-        static void init(const std::shared_ptr<vi::Context>& p_context)
+        static void init(const std::shared_ptr<vi::Context>& p_context, const vi::RendererProps& p_props)
         {
+            if (p_props.FramesInFlight < MIN_FRAMES_IN_FLIGHT || p_props.FramesInFlight > MAX_FRAMES_IN_FLIGHT)
+            {
+                throw std::runtime_error(std::format("Frames in flight must be between {} and {}, got {}", MIN_FRAMES_IN_FLIGHT, MAX_FRAMES_IN_FLIGHT, p_props.FramesInFlight));
+            }
+
             const auto context = std::dynamic_pointer_cast<vulkan::Context>(p_context);
+            m_frames.resize(p_props.FramesInFlight);
+            m_graphics_timeline = &context->get_graphics_timeline();
             m_device = context->get_device();
-            m_swapchain = context->get_swapchain().get_swapchain();
-            m_swapchain_extent = context->get_swapchain().get_extent();
-            m_swapchain_images = context->get_swapchain().get_images();
+            m_swapchain = &context->get_swapchain();
+            m_headless = m_swapchain->is_headless();
             m_graphics_queue = context->get_graphics_queue();
-            m_draw_image = context->get_swapchain().get_draw_image();
+            m_async_compute = context->has_async_compute();
+            m_compute_queue = context->get_compute_queue();
+            m_compute_timeline = &context->get_compute_timeline();
+            m_allocator = context->get_allocator();
+            m_window_extent = m_swapchain->get_extent();
             init_commands(context);
+            init_frame_allocators(context);
             init_sync_structures();
+            init_descriptors();
+            init_pipelines(context);
+            m_render_graph.init(m_device, m_allocator, context->get_graphics_queue_family(), context->get_compute_queue_family());
+            m_gpu_profiler.init(context->get_physical_device(), m_device, context->get_graphics_queue_family(), static_cast<uint32_t>(m_frames.size()));
+            //a change of scale shows up in the timings once every frame in flight has been rendered with it
+            m_dynamic_resolution.init(p_props.TargetGpuFrameTime, p_props.MinRenderScale, static_cast<uint32_t>(m_frames.size()));
+            if (m_dynamic_resolution.is_enabled() && !m_gpu_profiler.is_supported())
+            {
+                VI_CORE_WARN("The graphics queue has no timestamps, dynamic resolution stays at full resolution");
+            }
+            m_parallel_recorder.init(m_device, context->get_graphics_queue_family(), static_cast<uint32_t>(m_frames.size()), p_props.RecordingThreads);
+            m_upload_engine.init(m_device, m_allocator, context->get_transfer_queue(), context->get_transfer_queue_family(), context->get_transfer_timeline(), context->get_graphics_queue_family());
+            m_transfer_timeline = &context->get_transfer_timeline();
+            m_bindless_heap.init(context->get_physical_device(), m_device, *m_graphics_timeline);
+            m_readback.init(m_device, m_allocator, *m_graphics_timeline);
+            m_texture_loader.init(m_device, m_allocator, m_upload_engine, m_bindless_heap);
+
+            //the mesh buffer is written by the transfer queue while graphics draws from it
+            const std::array mesh_queue_families{ context->get_graphics_queue_family(), context->get_transfer_queue_family() };
+            m_mesh_renderer.init(m_device, m_allocator, m_upload_engine, context->get_shader_cache(), context->get_pipeline_cache(), mesh_queue_families,
+                m_swapchain->get_draw_image()->get_allocated_image().image_format);
+            m_mesh_renderer.set_lod_threshold(p_props.LodThreshold);
+
+            VI_CORE_INFO("Renderer initialized with {} frames in flight", m_frames.size());
         }
 
         static void cleanup()
         {
             vkDeviceWaitIdle(m_device);
-            std::ranges::for_each(m_frames, [](const FrameData& p_frame)
+
+            //captures of the last frames are still written out
+            m_readback.cleanup();
+            m_render_graph.cleanup();
+            m_gpu_profiler.cleanup();
+            m_parallel_recorder.cleanup();
+            m_mesh_renderer.cleanup();
+            m_texture_loader.cleanup();
+            m_upload_engine.cleanup();
+            m_bindless_heap.cleanup();
+
+            m_background_pipeline.cleanup();
+            vkDestroyDescriptorSetLayout(m_device, m_draw_image_descriptor_layout, nullptr);
+
+            std::ranges::for_each(m_retired_resources, [](RetiredResources& p_retired)
             {
+                p_retired.m_deletion_queue.flush();
+            });
+            m_retired_resources.clear();
+
+            std::ranges::for_each(m_frames, [](FrameData& p_frame)
+            {
+                p_frame.m_deletion_queue.flush();
+                p_frame.m_frame_allocator.cleanup();
+                p_frame.m_frame_descriptors.cleanup();
+
                 vkDestroyCommandPool(m_device, p_frame.m_command_pool, nullptr);
+                if (p_frame.m_compute_command_pool != VK_NULL_HANDLE)
+                {
+                    vkDestroyCommandPool(m_device, p_frame.m_compute_command_pool, nullptr);
+                }
+                if (p_frame.m_background_image)
+                {
+                    p_frame.m_background_image->cleanup();
+                }
 
                 //destroy sync objects
-                vkDestroyFence(m_device, p_frame.m_render_fence, nullptr);
                 vkDestroySemaphore(m_device, p_frame.m_render_semaphore, nullptr);
                 vkDestroySemaphore(m_device, p_frame.m_swapchain_semaphore, nullptr);
             });
+            m_frames.clear();
         }
 
         static void begin_frame()
         {
-            //Wait until the gpu has finished rendering the last frame. Timeout of 1 second
-            if (const auto result = vkWaitForFences(m_device, 1, &get_current_frame().m_render_fence, true, utils::ONE_SECOND_IN_NS); result != VK_SUCCESS)
+            //Wait until the gpu has finished the last submission that used this frame. Timeout of 1 second
+            //The timeline only moves forward, so there is nothing to reset afterwards
+            m_graphics_timeline->wait(get_current_frame().m_timeline_value, utils::ONE_SECOND_IN_NS);
+
+            get_current_frame().m_deletion_queue.flush();
+            get_current_frame().m_frame_allocator.reset();
+            get_current_frame().m_frame_descriptors.clear();
+            flush_retired_resources();
+            m_bindless_heap.collect();
+            m_readback.collect();
+
+            //the slot's previous submission is complete, so its timestamps are ready to be read
+            //timings that were already fed once would be counted twice in the average
+            if (m_gpu_profiler.begin_frame(m_frame_number % static_cast<uint32_t>(m_frames.size())))
             {
-                throw std::runtime_error(std::format("Something wrong occured when waiting for finish rendering last frame: {}", string_VkResult(result)));
+                update_render_scale();
             }
+            m_parallel_recorder.begin_frame(m_frame_number % static_cast<uint32_t>(m_frames.size()));
 
-            get_current_frame().m_deletion_queue.flush();
+            //draws queued since the previous frame belong to this one, even if it ends up skipped
+            {
+                RetiredResources retired{ .m_timeline_value = m_graphics_timeline->get_last_value() };
+                m_mesh_renderer.begin_frame(get_current_frame().m_frame_allocator, retired.m_deletion_queue);
+                if (!retired.m_deletion_queue.empty())
+                {
+                    m_retired_resources.push_back(std::move(retired));
+                }
+            }
 
-            if (const auto result = vkResetFences(m_device, 1, &get_current_frame().m_render_fence); result != VK_SUCCESS)
+            //nothing can be presented while the window is minimized
+            m_frame_skipped = m_window_extent.width == 0 || m_window_extent.height == 0;
+            if (m_frame_skipped)
             {
-                throw std::runtime_error(std::format("Something wrong occured when resetting render fence: {}", string_VkResult(result)));
+                return;
             }
 
-            //Request image from swapchain
-            if (const auto result = vkAcquireNextImageKHR(m_device, m_swapchain, utils::ONE_SECOND_IN_NS, get_current_frame().m_swapchain_semaphore, nullptr, &m_swapchain_image_index); result != VK_SUCCESS)
+            if (m_frame_number % GPU_TIMINGS_LOG_INTERVAL == 0)
             {
-                throw std::runtime_error(std::format("Something wrong occured when requesting image from swapchain: {}", string_VkResult(result)));
+                m_gpu_profiler.log_timings();
+            }
+
+            if (m_swapchain_dirty)
+            {
+                recreate_swapchain();
+            }
+
+            //Request image from swapchain, an out of date swapchain is rebuilt once and the acquire retried
+            if (!m_headless)
+            {
+                auto acquire_result = acquire_next_image();
+                if (acquire_result == VK_ERROR_OUT_OF_DATE_KHR)
+                {
+                    recreate_swapchain();
+                    acquire_result = acquire_next_image();
+                }
+
+                if (acquire_result == VK_SUBOPTIMAL_KHR)
+                {
+                    //the image is still presentable, rebuild after this frame
+                    m_swapchain_dirty = true;
+                }
+                else if (acquire_result == VK_ERROR_OUT_OF_DATE_KHR)
+                {
+                    m_swapchain_dirty = true;
+                    m_frame_skipped = true;
+                    return;
+                }
+                else if (acquire_result != VK_SUCCESS)
+                {
+                    throw std::runtime_error(std::format("Something wrong occured when requesting image from swapchain: {}", string_VkResult(acquire_result)));
+                }
             }
 
             //naming it cmd for shorter writing
@@ -230,66 +407,261 @@ namespace
                 throw std::runtime_error(std::format("Cannot begin command buffer: {}", string_VkResult(result)));
             }
 
-            //make the swapchain image into writeable mode before rendering
-            //utils::transition_image(cmd, m_swapchain_images[m_swapchain_image_index], VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL);
+            if (m_async_compute)
+            {
+                //the graphics submission of this frame waited for the compute one, so it is done as well
+                const auto compute_cmd = get_current_frame().m_compute_command_buffer;
+                if (const auto result = vkResetCommandBuffer(compute_cmd, 0); result != VK_SUCCESS)
+                {
+                    throw std::runtime_error(std::format("Cannot reset compute command buffer: {}", string_VkResult(result)));
+                }
+                if (const auto result = vkBeginCommandBuffer(compute_cmd, &cmd_begin_info); result != VK_SUCCESS)
+                {
+                    throw std::runtime_error(std::format("Cannot begin compute command buffer: {}", string_VkResult(result)));
+                }
+
+                update_background_image();
+            }
+
+            //everything uploaded so far goes out now, the frame takes ownership of what already went out
+            m_upload_engine.flush();
+            m_upload_wait = m_upload_engine.acquire(cmd);
+            if (m_upload_wait)
+            {
+                m_acquired_upload_value = m_upload_wait->value;
+            }
+
+            //textures whose uploads are acquired by now get their mip chains in this frame
+            m_texture_loader.update(cmd, m_acquired_upload_value);
+
+            //the frame only covers the top left part of the draw image picked by the dynamic resolution
+            const auto draw_image_extent = m_swapchain->get_draw_image()->get_allocated_image().image_extent;
+            m_render_extent = m_dynamic_resolution.get_render_extent({ draw_image_extent.width, draw_image_extent.height });
+
+            m_render_graph.reset();
+            m_draw_image = m_render_graph.import_image("draw", *m_swapchain->get_draw_image());
+
+            if (m_headless)
+            {
+                //without a swapchain the draw image is the output of the frame, left ready to be copied out
+                m_render_graph.export_image(m_draw_image, vulkan::ImageUsage::TransferSrc);
+            }
+            else
+            {
+                //a freshly acquired image has no contents we care about, and is only available from the stage the submission waits at
+                auto& swapchain_image_state = m_swapchain->get_image_state(m_swapchain_image_index);
+                swapchain_image_state = { VK_IMAGE_LAYOUT_UNDEFINED, SWAPCHAIN_WAIT_STAGE, VK_ACCESS_2_NONE };
+
+                m_swapchain_image = m_render_graph.import_image("swapchain", m_swapchain->get_images()[m_swapchain_image_index], m_swapchain->get_image_views()[m_swapchain_image_index],
+                    m_swapchain->get_format(), { m_swapchain->get_extent().width, m_swapchain->get_extent().height, 1 }, swapchain_image_state);
+
+                //the swapchain image is the only output of the frame, anything not contributing to it is culled
+                m_render_graph.export_image(m_swapchain_image, vulkan::ImageUsage::Present);
+            }
+
+            if (m_async_compute)
+            {
+                //the background is computed on the compute queue, overlapping the graphics work of the previous frame,
+                //and copied under the draw image once graphics gets to it
+                m_background_image = m_render_graph.import_image("background", *get_current_frame().m_background_image);
+
+                m_render_graph.add_pass("background", [](vulkan::RenderGraphBuilder& p_builder)
+                {
+                    p_builder.write(m_background_image, vulkan::ImageUsage::ComputeWrite, true);
+                }, [](const VkCommandBuffer p_cmd, const vulkan::RenderGraphResources& p_resources)
+                {
+                    //the worker pools belong to the graphics family, so this one is recorded directly
+                    draw_background(p_cmd, p_resources.get_image_view(m_background_image), { m_render_extent.width, m_render_extent.height, 1 }, false);
+                }, vulkan::RenderGraphQueue::AsyncCompute);
+
+                m_render_graph.add_pass("compose background", [](vulkan::RenderGraphBuilder& p_builder)
+                {
+                    p_builder.read(m_background_image, vulkan::ImageUsage::TransferSrc);
+                    p_builder.write(m_draw_image, vulkan::ImageUsage::TransferDst, true);
+                }, [](const VkCommandBuffer p_cmd, const vulkan::RenderGraphResources& p_resources)
+                {
+                    vulkan::copy_image_to_image(p_cmd, p_resources.get_image(m_background_image), p_resources.get_image(m_draw_image), m_render_extent, m_render_extent);
+                });
+            }
+            else
+            {
+                m_render_graph.add_pass("background", [](vulkan::RenderGraphBuilder& p_builder)
+                {
+                    //we will overwrite it all, so we don't care about what was the older layout
+                    p_builder.write(m_draw_image, vulkan::ImageUsage::ComputeWrite, true);
+                }, [](const VkCommandBuffer p_cmd, const vulkan::RenderGraphResources& p_resources)
+                {
+                    draw_background(p_cmd, p_resources.get_image_view(m_draw_image), { m_render_extent.width, m_render_extent.height, 1 }, true);
+                });
+            }
 
-            //draw_background();
+            if (m_mesh_renderer.has_draws())
+            {
+                //sized like the whole draw image, so the transient memory survives changes of the render extent
+                m_depth_image = m_render_graph.create_image("depth", {
+                    .extent = draw_image_extent,
+                    .format = vulkan::MeshRenderer::DEPTH_FORMAT,
+                    .usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT
+                });
 
-            const auto allocated_image = m_draw_image->get_allocated_image();
-            VkExtent2D draw_extent{allocated_image.image_extent.width , allocated_image.image_extent.height };
+                const auto draw_buffers = m_mesh_renderer.add_cull_passes(m_render_graph, m_render_extent);
 
-            // transition our main draw image into general layout, so we can write into it,
-            // we will overwrite it all, so we don't care about what was the older layout
-            utils::transition_image(cmd, allocated_image.image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL);
+                m_render_graph.add_pass("geometry", [draw_buffers](vulkan::RenderGraphBuilder& p_builder)
+                {
+                    p_builder.read(draw_buffers.draws, vulkan::BufferUsage::IndirectRead);
+                    p_builder.read(draw_buffers.count, vulkan::BufferUsage::IndirectRead);
+                    p_builder.write(m_draw_image, vulkan::ImageUsage::ColorAttachment);
+                    p_builder.write(m_depth_image, vulkan::ImageUsage::DepthAttachment, true);
+                }, [draw_buffers](const VkCommandBuffer p_cmd, const vulkan::RenderGraphResources& p_resources)
+                {
+                    //meshes go over the background, depth is reversed so it starts cleared to the far plane at 0
+                    const auto color_attachment = utils::attachment_info(p_resources.get_image_view(m_draw_image), VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+                    const auto depth_attachment = utils::attachment_info(p_resources.get_image_view(m_depth_image), VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL,
+                        VkClearValue{ .depthStencil = { 0.0f, 0 } });
+
+                    const auto rendering_info = utils::rendering_info(m_render_extent, &color_attachment, &depth_attachment);
+                    vkCmdBeginRendering(p_cmd, &rendering_info);
+                    m_mesh_renderer.record(p_cmd, m_render_extent, p_resources, draw_buffers);
+                    vkCmdEndRendering(p_cmd);
+                });
+            }
 
-            draw_background();
+            if (!m_capture_requests.empty())
+            {
+                m_render_graph.add_pass("capture", [](vulkan::RenderGraphBuilder& p_builder)
+                {
+                    p_builder.read(m_draw_image, vulkan::ImageUsage::TransferSrc);
+                    p_builder.side_effect();
+                }, [](const VkCommandBuffer p_cmd, const vulkan::RenderGraphResources& p_resources)
+                {
+                    //recorded while the frame is built, its submission signals the next graphics timeline value
+                    const auto timeline_value = m_graphics_timeline->get_last_value() + 1;
+                    for (auto& callback : m_capture_requests)
+                    {
+                        m_readback.record(p_cmd, p_resources.get_image(m_draw_image), p_resources.get_format(m_draw_image), { m_render_extent.width, m_render_extent.height, 1 },
+                            timeline_value, std::move(callback));
+                    }
+                    m_capture_requests.clear();
+                });
+            }
 
-            //transition the draw image and the swapchain image into their correct transfer layouts
-            utils::transition_image(cmd, allocated_image.image, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
-            utils::transition_image(cmd, m_swapchain_images[m_swapchain_image_index], VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+            if (m_headless)
+            {
+                return;
+            }
 
-            // execute a copy from the draw image into the swapchain
-            vulkan::copy_image_to_image(cmd, allocated_image.image, m_swapchain_images[m_swapchain_image_index], draw_extent, m_swapchain_extent);
+            m_render_graph.add_pass("present blit", [](vulkan::RenderGraphBuilder& p_builder)
+            {
+                p_builder.read(m_draw_image, vulkan::ImageUsage::TransferSrc);
+                p_builder.write(m_swapchain_image, vulkan::ImageUsage::TransferDst, true);
+            }, [](const VkCommandBuffer p_cmd, const vulkan::RenderGraphResources& p_resources)
+            {
+                // execute a copy from the rendered part of the draw image into the swapchain, scaling it up to the window
+                const auto swapchain_extent = p_resources.get_extent(m_swapchain_image);
+                vulkan::copy_image_to_image(p_cmd, p_resources.get_image(m_draw_image), p_resources.get_image(m_swapchain_image),
+                    m_render_extent, { swapchain_extent.width, swapchain_extent.height });
+            });
         }
 
         static void end_frame()
         {
+            if (m_frame_skipped)
+            {
+                return;
+            }
+
             //naming it cmd for shorter writing
             const auto cmd = get_current_frame().m_main_command_buffer;
+            const auto compute_cmd = m_async_compute ? get_current_frame().m_compute_command_buffer : VK_NULL_HANDLE;
 
-            //make the swapchain image into presentable mode
-            utils::transition_image(cmd, m_swapchain_images[m_swapchain_image_index], VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+            //record every pass of the frame, the graph leaves the swapchain image in presentable mode
+            RetiredResources retired{ .m_timeline_value = m_graphics_timeline->get_last_value() };
+            vulkan::RenderGraphSubmission graph_submission{};
+            {
+                vulkan::GpuScope frame_scope{ m_gpu_profiler, cmd, "frame" };
+                graph_submission = m_render_graph.execute(cmd, compute_cmd, retired.m_deletion_queue, &m_gpu_profiler);
+            }
+            if (!retired.m_deletion_queue.empty())
+            {
+                m_retired_resources.push_back(std::move(retired));
+            }
 
             if (const auto result = vkEndCommandBuffer(cmd); result != VK_SUCCESS)
             {
                 throw std::runtime_error(std::format("Cannot end command buffer: {}", string_VkResult(result)));
             }
 
+            get_current_frame().m_frame_allocator.flush();
+
+            std::vector<VkSemaphoreSubmitInfo> wait_infos{};
+            if (!m_headless)
+            {
+                wait_infos.push_back(utils::semaphore_submit_info(SWAPCHAIN_WAIT_STAGE, get_current_frame().m_swapchain_semaphore));
+            }
+
+            if (compute_cmd != VK_NULL_HANDLE)
+            {
+                if (const auto result = vkEndCommandBuffer(compute_cmd); result != VK_SUCCESS)
+                {
+                    throw std::runtime_error(std::format("Cannot end compute command buffer: {}", string_VkResult(result)));
+                }
+
+                //an unused compute command buffer is simply reset with the frame
+                if (graph_submission.uses_async_compute)
+                {
+                    const auto compute_value = submit_compute(compute_cmd);
+                    wait_infos.push_back(utils::semaphore_submit_info(graph_submission.graphics_wait_stage, m_compute_timeline->get_semaphore(), compute_value));
+                }
+            }
+
+            if (m_upload_wait)
+            {
+                wait_infos.push_back(utils::semaphore_submit_info(m_upload_wait->stage, m_transfer_timeline->get_semaphore(), m_upload_wait->value));
+                m_upload_wait.reset();
+            }
+
             //prepare the submission to the queue.
-            //we want to wait on the m_present_semaphore, as that semaphore is signaled when the swapchain is ready
-            //we will signal the m_render_semaphore, to signal that rendering has finished
+            //we want to wait on the m_swapchain_semaphore, as that semaphore is signaled when the swapchain is ready,
+            //on the compute timeline when part of the frame ran on the compute queue, and on the transfer timeline for new uploads.
+            //we will signal the m_render_semaphore for the presentation engine, and the next graphics timeline value for the CPU
             const auto cmd_info = utils::command_buffer_submit_info(cmd);
 
-            const auto wait_info = utils::semaphore_submit_info(VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR, get_current_frame().m_swapchain_semaphore);
-            const auto signal_info = utils::semaphore_submit_info(VK_PIPELINE_STAGE_2_ALL_GRAPHICS_BIT, get_current_frame().m_render_semaphore);
+            get_current_frame().m_timeline_value = m_graphics_timeline->next_value();
+
+            std::vector signal_infos{
+                utils::semaphore_submit_info(VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, m_graphics_timeline->get_semaphore(), get_current_frame().m_timeline_value)
+            };
+            if (!m_headless)
+            {
+                signal_infos.push_back(utils::semaphore_submit_info(VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, get_current_frame().m_render_semaphore));
+            }
 
-            const auto submit = utils::submit_info(&cmd_info, &signal_info, &wait_info);
+            const auto submit = utils::submit_info(&cmd_info, signal_infos, wait_infos);
 
             //submit command buffer to the queue and execute it.
-            // m_render_fence will now block until the graphic commands finish execution
-            if (const auto result = vkQueueSubmit2(m_graphics_queue, 1, &submit, get_current_frame().m_render_fence); result != VK_SUCCESS)
+            //the frame's timeline value will be reached once the graphic commands finish execution
+            if (const auto result = vkQueueSubmit2(m_graphics_queue, 1, &submit, VK_NULL_HANDLE); result != VK_SUCCESS)
             {
                 throw std::runtime_error(std::format("Cannot submit queue: {}", string_VkResult(result)));
             }
 
+            //headless frames end with the submission, the draw image holds the result
+            if (m_headless)
+            {
+                ++m_frame_number;
+                return;
+            }
+
             //prepare present
             // this will put the image we just rendered to into the visible window.
             // we want to wait on the _renderSemaphore for that, 
             // as its necessary that drawing commands have finished before the image is displayed to the user
+            const auto swapchain = m_swapchain->get_swapchain();
+
             VkPresentInfoKHR present_info{};
             present_info.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
             present_info.pNext = nullptr;
-            present_info.pSwapchains = &m_swapchain;
+            present_info.pSwapchains = &swapchain;
             present_info.swapchainCount = 1;
 
             present_info.pWaitSemaphores = &get_current_frame().m_render_semaphore;
@@ -297,7 +669,12 @@ namespace
 
             present_info.pImageIndices = &m_swapchain_image_index;
 
-            if (const auto result = vkQueuePresentKHR(m_graphics_queue, &present_info); result != VK_SUCCESS)
+            //the swapchain is rebuilt at the start of the next frame instead of failing this one
+            if (const auto result = vkQueuePresentKHR(m_graphics_queue, &present_info); result == VK_SUBOPTIMAL_KHR || result == VK_ERROR_OUT_OF_DATE_KHR)
+            {
+                m_swapchain_dirty = true;
+            }
+            else if (result != VK_SUCCESS)
             {
                 throw std::runtime_error(std::format("Cannot present queue: {}", string_VkResult(result)));
             }
@@ -306,12 +683,191 @@ namespace
             ++m_frame_number;
         }
 
+        static void on_resize(const uint32_t p_width, const uint32_t p_height)
+        {
+            m_window_extent = { p_width, p_height };
+            m_swapchain_dirty = true;
+        }
+
+        static void set_present_mode(const vi::PresentMode p_mode)
+        {
+            m_swapchain->set_present_mode(p_mode);
+            //nothing is presented headless, so there is nothing to rebuild
+            m_swapchain_dirty = !m_headless;
+        }
+
+        static vi::PresentMode get_present_mode()
+        {
+            return m_swapchain->get_present_mode();
+        }
+
+        static const std::vector<vi::GpuTiming>& get_gpu_timings()
+        {
+            return m_gpu_profiler.get_timings();
+        }
+
+        static vulkan::UploadEngine& get_upload_engine()
+        {
+            return m_upload_engine;
+        }
+
+        static vulkan::FrameAllocator& get_frame_allocator()
+        {
+            return get_current_frame().m_frame_allocator;
+        }
+
+        static vulkan::BindlessHeap& get_bindless_heap()
+        {
+            return m_bindless_heap;
+        }
+
+        static vulkan::Readback& get_readback()
+        {
+            return m_readback;
+        }
+
+        static float get_render_scale()
+        {
+            return m_dynamic_resolution.get_scale();
+        }
+
+        static vulkan::TextureLoader& get_texture_loader()
+        {
+            return m_texture_loader;
+        }
+
+        static vi::TextureHandle load_texture(const std::filesystem::path& p_path)
+        {
+            return m_texture_loader.load(p_path);
+        }
+
+        static uint32_t get_texture_index(const vi::TextureHandle p_texture)
+        {
+            return m_texture_loader.get_bindless_index(p_texture);
+        }
+
+        static bool is_texture_ready(const vi::TextureHandle p_texture)
+        {
+            return m_texture_loader.is_ready(p_texture);
+        }
+
+        static void capture_frame(vulkan::Readback::Callback p_callback)
+        {
+            m_capture_requests.push_back(std::move(p_callback));
+        }
+
+        static vi::MeshHandle upload_mesh(const std::span<const vi::Vertex> p_vertices, const std::span<const uint32_t> p_indices, const std::span<const vi::MeshLod> p_lods)
+        {
+            return m_mesh_renderer.add_mesh(p_vertices, p_indices, p_lods);
+        }
+
+        static void draw_mesh(const vi::MeshHandle p_mesh, const glm::mat4& p_transform)
+        {
+            m_mesh_renderer.draw(p_mesh, p_transform);
+        }
+
+        static void set_camera(const glm::mat4& p_view_projection)
+        {
+            m_mesh_renderer.set_view_projection(p_view_projection);
+        }
+
     private:
+        static VkResult acquire_next_image()
+        {
+            return vkAcquireNextImageKHR(m_device, m_swapchain->get_swapchain(), utils::ONE_SECOND_IN_NS, get_current_frame().m_swapchain_semaphore, nullptr, &m_swapchain_image_index);
+        }
+
+        //Feeds the GPU time of the newest frame with results to the dynamic resolution
+        static void update_render_scale()
+        {
+            if (!m_dynamic_resolution.is_enabled())
+            {
+                return;
+            }
+
+            const auto& timings = m_gpu_profiler.get_timings();
+            if (const auto frame = std::ranges::find_if(timings, [](const vi::GpuTiming& p_timing)
+            {
+                return p_timing.Depth == 0 && p_timing.Name == "frame";
+            }); frame != timings.end())
+            {
+                m_dynamic_resolution.update(frame->Milliseconds);
+            }
+        }
+
+        static void recreate_swapchain()
+        {
+            //frames still in flight may use the old swapchain and draw image,
+            //so they are retired until the last submitted graphics work has finished instead of waiting for the device
+            RetiredResources retired{ .m_timeline_value = m_graphics_timeline->get_last_value() };
+            m_swapchain->recreate({ m_window_extent.width, m_window_extent.height }, retired.m_deletion_queue);
+            m_retired_resources.push_back(std::move(retired));
+
+            m_window_extent = m_swapchain->get_extent();
+            m_swapchain_dirty = false;
+        }
+
+        //Submits the compute half of the frame, returns the compute timeline value the graphics half has to wait for
+        static uint64_t submit_compute(const VkCommandBuffer p_compute_cmd)
+        {
+            const auto compute_value = m_compute_timeline->next_value();
+            const auto cmd_info = utils::command_buffer_submit_info(p_compute_cmd);
+            const std::array signal_infos{
+                utils::semaphore_submit_info(VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, m_compute_timeline->get_semaphore(), compute_value)
+            };
+
+            const auto submit = utils::submit_info(&cmd_info, signal_infos, {});
+            if (const auto result = vkQueueSubmit2(m_compute_queue, 1, &submit, VK_NULL_HANDLE); result != VK_SUCCESS)
+            {
+                throw std::runtime_error(std::format("Cannot submit compute queue: {}", string_VkResult(result)));
+            }
+
+            return compute_value;
+        }
+
+        //Keeps the frame's background image at the size of the draw image
+        static void update_background_image()
+        {
+            auto& frame = get_current_frame();
+            const auto draw_image = m_swapchain->get_draw_image()->get_allocated_image();
+            if (frame.m_background_image)
+            {
+                const auto extent = frame.m_background_image->get_allocated_image().image_extent;
+                if (extent.width == draw_image.image_extent.width && extent.height == draw_image.image_extent.height)
+                {
+                    return;
+                }
+
+                //only this frame slot used it, and its last submission is complete
+                frame.m_background_image->cleanup();
+            }
+
+            frame.m_background_image = std::make_shared<vulkan::Image>(draw_image.image_extent, draw_image.image_format,
+                VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT, m_allocator, m_device);
+        }
+
+        static void flush_retired_resources()
+        {
+            if (m_retired_resources.empty())
+            {
+                return;
+            }
+
+            const auto completed_value = m_graphics_timeline->get_completed_value();
+            while (!m_retired_resources.empty() && m_retired_resources.front().m_timeline_value <= completed_value)
+            {
+                m_retired_resources.front().m_deletion_queue.flush();
+                m_retired_resources.pop_front();
+            }
+        }
+
         static void init_commands(const std::shared_ptr<vulkan::Context>& p_context)
         {
             const auto command_pool_info = utils::command_pool_create_info(p_context->get_graphics_queue_family(), VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT);
 
-            std::ranges::for_each(m_frames, [command_pool_info](FrameData& p_frame)
+            const auto compute_pool_info = utils::command_pool_create_info(p_context->get_compute_queue_family(), VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT);
+
+            std::ranges::for_each(m_frames, [command_pool_info, compute_pool_info](FrameData& p_frame)
                 {
                     if (const auto result = vkCreateCommandPool(m_device, &command_pool_info, nullptr, &p_frame.m_command_pool); result != VK_SUCCESS)
                     {
@@ -320,25 +876,40 @@ namespace
 
                     const auto cmd_alloc_info = utils::command_buffer_allocate_info(p_frame.m_command_pool, 1);
                     vkAllocateCommandBuffers(m_device, &cmd_alloc_info, &p_frame.m_main_command_buffer);
+
+                    if (!m_async_compute)
+                    {
+                        return;
+                    }
+
+                    if (const auto result = vkCreateCommandPool(m_device, &compute_pool_info, nullptr, &p_frame.m_compute_command_pool); result != VK_SUCCESS)
+                    {
+                        throw std::runtime_error(std::format("Cannot create compute command pool: {}", string_VkResult(result)));
+                    }
+
+                    const auto compute_alloc_info = utils::command_buffer_allocate_info(p_frame.m_compute_command_pool, 1);
+                    vkAllocateCommandBuffers(m_device, &compute_alloc_info, &p_frame.m_compute_command_buffer);
                 });
         }
 
+        static void init_frame_allocators(const std::shared_ptr<vulkan::Context>& p_context)
+        {
+            std::ranges::for_each(m_frames, [&p_context](FrameData& p_frame)
+            {
+                p_frame.m_frame_allocator.init(p_context->get_physical_device(), m_device, m_allocator);
+            });
+        }
+
         static void init_sync_structures()
         {
             //Create synchronization structures
-            //one fence to control when the gpu has finished rendering the frame,
-            //and 2 semaphores to synchronize rendering with swapchain
-            //we want the fence to start signalled, so we can wait on it on the first frame
-            auto fence_info = utils::fence_create_info(VK_FENCE_CREATE_SIGNALED_BIT);
+            //completion of the frame is tracked on the graphics timeline owned by the context,
+            //we only need 2 binary semaphores to synchronize rendering with swapchain
+            //frames start with timeline value 0, so waiting on them the first time returns immediately
             auto semaphore_info = utils::semaphore_create_info(0);
 
-            std::ranges::for_each(m_frames, [fence_info, semaphore_info](FrameData& p_frame)
+            std::ranges::for_each(m_frames, [semaphore_info](FrameData& p_frame)
             {
-                if (const auto result = vkCreateFence(m_device, &fence_info, nullptr, &p_frame.m_render_fence); result != VK_SUCCESS)
-                {
-                    throw std::runtime_error(std::format("Cannot create render fence: {}", string_VkResult(result)));
-                }
-
                 if (const auto result = vkCreateSemaphore(m_device, &semaphore_info, nullptr, &p_frame.m_swapchain_semaphore); result != VK_SUCCESS)
                 {
                     throw std::runtime_error(std::format("Cannot create swapchain semaphore: {}", string_VkResult(result)));
@@ -351,39 +922,143 @@ namespace
             });
         }
 
-        static FrameData& get_current_frame() { return m_frames.at(m_frame_number % FRAME_OVERLAP); }
+        static FrameData& get_current_frame() { return m_frames.at(m_frame_number % m_frames.size()); }
+
+        static void init_descriptors()
+        {
+            //pools grow on demand, the ratios only describe the mix of descriptors a typical set needs
+            constexpr std::array pool_ratios{
+                vulkan::DescriptorAllocatorGrowable::PoolSizeRatio{ VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 3.f },
+                vulkan::DescriptorAllocatorGrowable::PoolSizeRatio{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 3.f },
+                vulkan::DescriptorAllocatorGrowable::PoolSizeRatio{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 3.f },
+                vulkan::DescriptorAllocatorGrowable::PoolSizeRatio{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1.f },
+                vulkan::DescriptorAllocatorGrowable::PoolSizeRatio{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4.f }
+            };
+            std::ranges::for_each(m_frames, [&pool_ratios](FrameData& p_frame)
+            {
+                p_frame.m_frame_descriptors.init(m_device, FRAME_DESCRIPTOR_SETS, pool_ratios);
+            });
+
+            vulkan::DescriptorLayoutBuilder builder;
+            builder.add_binding(0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE);
+            m_draw_image_descriptor_layout = builder.build(m_device, VK_SHADER_STAGE_COMPUTE_BIT);
+        }
+
+        static void init_pipelines(const std::shared_ptr<vulkan::Context>& p_context)
+        {
+            const auto shader = p_context->get_shader_cache().get_module(vulkan::get_shader_directory() / "gradient.comp.spv");
+
+            m_background_pipeline.init(m_device, {
+                .shader = shader,
+                .set_layouts = { m_draw_image_descriptor_layout },
+                .push_constant_size = sizeof(BackgroundConstants),
+                .local_size = { 16, 16, 1 }
+            }, p_context->get_pipeline_cache());
+        }
 
-        static void draw_background()
+        static void draw_background(const VkCommandBuffer p_cmd, const VkImageView p_image_view, const VkExtent3D p_extent, const bool p_parallel)
         {
-            //make a clear-color from frame number. This will flash with a 120 frame period.
+            //a set for this frame only, the draw image changes with the swapchain
+            const auto descriptors = get_current_frame().m_frame_descriptors.allocate(m_draw_image_descriptor_layout);
+            vulkan::DescriptorWriter writer;
+            writer.write_image(0, p_image_view, VK_NULL_HANDLE, VK_IMAGE_LAYOUT_GENERAL, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE);
+            writer.update_set(m_device, descriptors);
+
+            //make a gradient from frame number. The bottom will flash with a 120 frame period.
             const auto flash = abs(sin(static_cast<float>(m_frame_number) / 120.f));
-            const VkClearColorValue clear_value = { { 0.0f, 0.0f, flash, 1.0f } };
-            const auto clear_range = utils::image_subresource_range(VK_IMAGE_ASPECT_COLOR_BIT);
 
-            //clear image
-            const auto cmd = get_current_frame().m_main_command_buffer;
-            vkCmdClearColorImage(cmd, m_draw_image->get_image(), VK_IMAGE_LAYOUT_GENERAL, &clear_value, 1, &clear_range);
+            //the image is split in horizontal bands of whole workgroups, each recorded by its own thread
+            constexpr uint32_t BAND_ALIGNMENT{ 16 };
+            const auto group_rows = (p_extent.height + BAND_ALIGNMENT - 1) / BAND_ALIGNMENT;
+            const auto band_count = p_parallel ? std::min(m_parallel_recorder.get_thread_count() + 1, group_rows) : 1;
+            const auto band_height = (group_rows + band_count - 1) / band_count * BAND_ALIGNMENT;
+
+            std::vector<vulkan::ParallelRecorder::RecordFunction> bands;
+            for (uint32_t band_start = 0; band_start < p_extent.height; band_start += band_height)
+            {
+                bands.emplace_back([=](const VkCommandBuffer p_band_cmd)
+                {
+                    const BackgroundConstants constants{
+                        .m_top_color = { 0.0f, 0.0f, 0.0f, 1.0f },
+                        .m_bottom_color = { 0.0f, 0.0f, flash, 1.0f },
+                        .m_offset = { 0, static_cast<int32_t>(band_start) },
+                        .m_extent = { static_cast<int32_t>(p_extent.width), static_cast<int32_t>(p_extent.height) }
+                    };
+
+                    m_background_pipeline.bind(p_band_cmd);
+                    m_background_pipeline.bind_descriptor_set(p_band_cmd, 0, descriptors);
+                    m_background_pipeline.push_constants(p_band_cmd, constants);
+                    m_background_pipeline.dispatch(p_band_cmd, p_extent.width, std::min(band_height, p_extent.height - band_start));
+                });
+            }
+
+            if (p_parallel)
+            {
+                m_parallel_recorder.record(p_cmd, bands);
+            }
+            else
+            {
+                bands.front()(p_cmd);
+            }
         }
 
         inline static VkDevice m_device{};
-        inline static VkSwapchainKHR m_swapchain{};
-        inline static VkExtent2D m_swapchain_extent{};
-        inline static std::vector<VkImage> m_swapchain_images;
+        inline static vulkan::Swapchain* m_swapchain{};
         inline static VkQueue m_graphics_queue{};
+        inline static vulkan::Timeline* m_graphics_timeline{};
+        inline static VmaAllocator m_allocator{};
+
+        inline static bool m_async_compute{ false };
+        inline static VkQueue m_compute_queue{};
+        inline static vulkan::Timeline* m_compute_timeline{};
+
+        inline static vulkan::UploadEngine m_upload_engine;
+        inline static vulkan::Timeline* m_transfer_timeline{};
+        inline static std::optional<vulkan::UploadWait> m_upload_wait{};
+        //transfer timeline value up to which uploads are owned by the graphics queue
+        inline static uint64_t m_acquired_upload_value{};
+        inline static vulkan::TextureLoader m_texture_loader;
+
+        inline static vulkan::BindlessHeap m_bindless_heap;
+        inline static vulkan::MeshRenderer m_mesh_renderer;
+
+        inline static vulkan::Readback m_readback;
+
+        inline static vulkan::DynamicResolution m_dynamic_resolution{};
+        //part of the draw image the current frame renders to
+        inline static VkExtent2D m_render_extent{};
+        //captures of the draw image waiting for the next frame that is not skipped
+        inline static std::vector<vulkan::Readback::Callback> m_capture_requests{};
 
         inline static uint32_t m_frame_number{};
-        inline static std::array<FrameData, FRAME_OVERLAP> m_frames;
+        inline static std::vector<FrameData> m_frames;
 
         inline static uint32_t m_swapchain_image_index{};
-        inline static std::shared_ptr<vulkan::Image> m_draw_image{};
+
+        inline static VkExtent2D m_window_extent{};
+        inline static bool m_swapchain_dirty{ false };
+        inline static bool m_headless{ false };
+        inline static bool m_frame_skipped{ false };
+        inline static vulkan::RenderGraph m_render_graph;
+        inline static vulkan::RenderGraphImage m_draw_image{};
+        inline static vulkan::RenderGraphImage m_swapchain_image{};
+        inline static vulkan::RenderGraphImage m_background_image{};
+        inline static vulkan::RenderGraphImage m_depth_image{};
+        inline static std::deque<RetiredResources> m_retired_resources;
+
+        inline static VkDescriptorSetLayout m_draw_image_descriptor_layout{};
+        inline static vulkan::ComputePipeline m_background_pipeline;
+
+        inline static vulkan::GpuProfiler m_gpu_profiler;
+        inline static vulkan::ParallelRecorder m_parallel_recorder;
     };
 }
 
 namespace vulkan
 {
-    void Renderer::init(const std::shared_ptr<vi::Context>& p_context)
+    void Renderer::init(const std::shared_ptr<vi::Context>& p_context, const vi::RendererProps& p_props)
     {
-        InternalRenderer::init(p_context);
+        InternalRenderer::init(p_context, p_props);
     }
 
     void Renderer::cleanup()
@@ -400,4 +1075,89 @@ namespace vulkan
     {
         InternalRenderer::end_frame();
     }
+
+    void Renderer::on_resize(const uint32_t p_width, const uint32_t p_height)
+    {
+        InternalRenderer::on_resize(p_width, p_height);
+    }
+
+    void Renderer::set_present_mode(const vi::PresentMode p_mode)
+    {
+        InternalRenderer::set_present_mode(p_mode);
+    }
+
+    vi::PresentMode Renderer::get_present_mode() const
+    {
+        return InternalRenderer::get_present_mode();
+    }
+
+    const std::vector<vi::GpuTiming>& Renderer::get_gpu_timings() const
+    {
+        return InternalRenderer::get_gpu_timings();
+    }
+
+    float Renderer::get_render_scale() const
+    {
+        return InternalRenderer::get_render_scale();
+    }
+
+    TextureLoader& Renderer::get_texture_loader()
+    {
+        return InternalRenderer::get_texture_loader();
+    }
+
+    vi::TextureHandle Renderer::load_texture(const std::filesystem::path& p_path)
+    {
+        return InternalRenderer::load_texture(p_path);
+    }
+
+    uint32_t Renderer::get_texture_index(const vi::TextureHandle p_texture) const
+    {
+        return InternalRenderer::get_texture_index(p_texture);
+    }
+
+    bool Renderer::is_texture_ready(const vi::TextureHandle p_texture) const
+    {
+        return InternalRenderer::is_texture_ready(p_texture);
+    }
+
+    UploadEngine& Renderer::get_upload_engine()
+    {
+        return InternalRenderer::get_upload_engine();
+    }
+
+    FrameAllocator& Renderer::get_frame_allocator()
+    {
+        return InternalRenderer::get_frame_allocator();
+    }
+
+    BindlessHeap& Renderer::get_bindless_heap()
+    {
+        return InternalRenderer::get_bindless_heap();
+    }
+
+    Readback& Renderer::get_readback()
+    {
+        return InternalRenderer::get_readback();
+    }
+
+    void Renderer::capture_frame(std::function<void(const vi::ImageData&)> p_callback)
+    {
+        InternalRenderer::capture_frame(std::move(p_callback));
+    }
+
+    vi::MeshHandle Renderer::upload_mesh(const std::span<const vi::Vertex> p_vertices, const std::span<const uint32_t> p_indices, const std::span<const vi::MeshLod> p_lods)
+    {
+        return InternalRenderer::upload_mesh(p_vertices, p_indices, p_lods);
+    }
+
+    void Renderer::draw_mesh(const vi::MeshHandle p_mesh, const glm::mat4& p_transform)
+    {
+        InternalRenderer::draw_mesh(p_mesh, p_transform);
+    }
+
+    void Renderer::set_camera(const glm::mat4& p_view_projection)
+    {
+        InternalRenderer::set_camera(p_view_projection);
+    }
 }
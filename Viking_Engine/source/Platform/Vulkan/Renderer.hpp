@@ -2,17 +2,52 @@
 #define VULKAN_RENDERER_HPP
 
 #include "Viking/renderer/Context.hpp"
+#include "Viking/renderer/Renderer.hpp"
 
 namespace vulkan
 {
+    class BindlessHeap;
+    class FrameAllocator;
+    class Readback;
+    class TextureLoader;
+    class UploadEngine;
+
     class Renderer
     {
     public:
-        void init(const std::shared_ptr<vi::Context>& p_context);
+        void init(const std::shared_ptr<vi::Context>& p_context, const vi::RendererProps& p_props);
         void cleanup();
 
         void begin_frame();
         void end_frame();
+
+        void on_resize(uint32_t p_width, uint32_t p_height);
+
+        void set_present_mode(vi::PresentMode p_mode);
+        [[nodiscard]] vi::PresentMode get_present_mode() const;
+
+        [[nodiscard]] const std::vector<vi::GpuTiming>& get_gpu_timings() const;
+        [[nodiscard]] float get_render_scale() const;
+
+        [[nodiscard]] vi::MeshHandle upload_mesh(std::span<const vi::Vertex> p_vertices, std::span<const uint32_t> p_indices, std::span<const vi::MeshLod> p_lods = {});
+        void draw_mesh(vi::MeshHandle p_mesh, const glm::mat4& p_transform);
+        void set_camera(const glm::mat4& p_view_projection);
+        void capture_frame(std::function<void(const vi::ImageData&)> p_callback);
+
+        [[nodiscard]] vi::TextureHandle load_texture(const std::filesystem::path& p_path);
+        [[nodiscard]] uint32_t get_texture_index(vi::TextureHandle p_texture) const;
+        [[nodiscard]] bool is_texture_ready(vi::TextureHandle p_texture) const;
+
+        //Uploads made through it are visible to the frames that begin after they were made
+        [[nodiscard]] UploadEngine& get_upload_engine();
+        //Allocator of the frame being recorded, only valid between begin_frame and end_frame
+        [[nodiscard]] FrameAllocator& get_frame_allocator();
+        //Descriptor set every pipeline layout can put first, so shaders index resources instead of binding them
+        [[nodiscard]] BindlessHeap& get_bindless_heap();
+        //Copies images back to the host without waiting for the GPU, the copies have to be recorded into the frame
+        [[nodiscard]] Readback& get_readback();
+        //Decodes and uploads textures in the background, finishing them in the frames that acquire the uploads
+        [[nodiscard]] TextureLoader& get_texture_loader();
     };
 }
 
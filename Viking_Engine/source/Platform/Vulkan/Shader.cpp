@@ -0,0 +1,113 @@
+#include "Platform/Vulkan/Shader.hpp"
+
+#include "Viking/core/Log.hpp"
+#include "Viking/core/Paths.hpp"
+
+#include <vulkan/vk_enum_string_helper.h>
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+
+namespace
+{
+    //FNV-1a, SPIR-V modules are small enough that a simple byte hash is not worth replacing
+    uint64_t hash_code(const std::span<const uint32_t> p_code)
+    {
+        constexpr uint64_t FNV_OFFSET_BASIS{ 14695981039346656037ull };
+        constexpr uint64_t FNV_PRIME{ 1099511628211ull };
+
+        uint64_t hash{ FNV_OFFSET_BASIS };
+        for (const auto byte : std::as_bytes(p_code))
+        {
+            hash ^= static_cast<uint64_t>(byte);
+            hash *= FNV_PRIME;
+        }
+
+        return hash;
+    }
+}
+
+namespace vulkan
+{
+    std::vector<uint32_t> load_spirv(const std::filesystem::path& p_path)
+    {
+        std::ifstream file(p_path, std::ios::ate | std::ios::binary);
+        if (!file.is_open())
+        {
+            throw std::runtime_error(std::format("Cannot open shader {}", p_path.string()));
+        }
+
+        const auto file_size = static_cast<size_t>(file.tellg());
+        if (file_size == 0 || file_size % sizeof(uint32_t) != 0)
+        {
+            throw std::runtime_error(std::format("{} is not a valid SPIR-V binary", p_path.string()));
+        }
+
+        std::vector<uint32_t> code(file_size / sizeof(uint32_t));
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(code.data()), static_cast<std::streamsize>(file_size));
+
+        return code;
+    }
+
+    std::filesystem::path get_shader_directory()
+    {
+        if (auto directory = vi::get_executable_directory() / "shaders"; std::filesystem::is_directory(directory))
+        {
+            return directory;
+        }
+
+        return std::filesystem::current_path() / "shaders";
+    }
+
+    void ShaderCache::init(const VkDevice p_device)
+    {
+        m_device = p_device;
+    }
+
+    void ShaderCache::cleanup()
+    {
+        for (const auto& [hash, cached] : m_modules)
+        {
+            vkDestroyShaderModule(m_device, cached.m_module, nullptr);
+        }
+        m_modules.clear();
+    }
+
+    VkShaderModule ShaderCache::get_module(const std::span<const uint32_t> p_code)
+    {
+        const auto hash = hash_code(p_code);
+        if (const auto it = m_modules.find(hash); it != m_modules.end())
+        {
+            if (!std::ranges::equal(it->second.m_code, p_code))
+            {
+                throw std::runtime_error(std::format("Shader hash collision on {:016x}", hash));
+            }
+            return it->second.m_module;
+        }
+
+        VkShaderModuleCreateInfo info{};
+        info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+        info.pNext = nullptr;
+        info.codeSize = p_code.size_bytes();
+        info.pCode = p_code.data();
+
+        VkShaderModule module{};
+        if (const auto result = vkCreateShaderModule(m_device, &info, nullptr, &module); result != VK_SUCCESS)
+        {
+            throw std::runtime_error(std::format("Cannot create shader module: {}", string_VkResult(result)));
+        }
+
+        m_modules.emplace(hash, CachedModule{ module, { p_code.begin(), p_code.end() } });
+        return module;
+    }
+
+    VkShaderModule ShaderCache::get_module(const std::filesystem::path& p_path)
+    {
+        const auto code = load_spirv(p_path);
+        VI_CORE_TRACE("Loaded shader {}", p_path.string());
+        return get_module(code);
+    }
+}
@@ -0,0 +1,42 @@
+#ifndef VULKAN_SHADER_HPP
+#define VULKAN_SHADER_HPP
+
+#include <vulkan/vulkan.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace vulkan
+{
+    [[nodiscard]] std::vector<uint32_t> load_spirv(const std::filesystem::path& p_path);
+    //The shaders directory next to the executable, or the one in the working directory when there is none
+    [[nodiscard]] std::filesystem::path get_shader_directory();
+
+    //Owns every VkShaderModule of the device. Modules are keyed by a hash of their SPIR-V,
+    //so the same code loaded from different places or by different pipelines is only created once
+    class ShaderCache
+    {
+    public:
+        void init(VkDevice p_device);
+        void cleanup();
+
+        [[nodiscard]] VkShaderModule get_module(std::span<const uint32_t> p_code);
+        [[nodiscard]] VkShaderModule get_module(const std::filesystem::path& p_path);
+
+    private:
+        struct CachedModule
+        {
+            VkShaderModule m_module{};
+            //a hash hit only reuses the module when the code is the same
+            std::vector<uint32_t> m_code{};
+        };
+
+        VkDevice m_device{};
+        std::unordered_map<uint64_t, CachedModule> m_modules{};
+    };
+}
+
+#endif // VULKAN_SHADER_HPP
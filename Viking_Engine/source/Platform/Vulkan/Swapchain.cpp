@@ -1,43 +1,242 @@
 #include "Platform/Vulkan/Swapchain.hpp"
 
+#include "Viking/core/Log.hpp"
+
 #include <VkBootstrap.h>
+#include <vulkan/vk_enum_string_helper.h>
+
+#include <algorithm>
+#include <array>
+#include <format>
+#include <span>
+#include <stdexcept>
+
+namespace
+{
+    VkPresentModeKHR to_vulkan_present_mode(const vi::PresentMode p_present_mode)
+    {
+        switch (p_present_mode)
+        {
+        case vi::PresentMode::FifoRelaxed:
+            return VK_PRESENT_MODE_FIFO_RELAXED_KHR;
+        case vi::PresentMode::Mailbox:
+            return VK_PRESENT_MODE_MAILBOX_KHR;
+        case vi::PresentMode::Immediate:
+            return VK_PRESENT_MODE_IMMEDIATE_KHR;
+        case vi::PresentMode::Fifo:
+        default:
+            return VK_PRESENT_MODE_FIFO_KHR;
+        }
+    }
+
+    vi::PresentMode from_vulkan_present_mode(const VkPresentModeKHR p_present_mode)
+    {
+        switch (p_present_mode)
+        {
+        case VK_PRESENT_MODE_FIFO_RELAXED_KHR:
+            return vi::PresentMode::FifoRelaxed;
+        case VK_PRESENT_MODE_MAILBOX_KHR:
+            return vi::PresentMode::Mailbox;
+        case VK_PRESENT_MODE_IMMEDIATE_KHR:
+            return vi::PresentMode::Immediate;
+        case VK_PRESENT_MODE_FIFO_KHR:
+        default:
+            return vi::PresentMode::Fifo;
+        }
+    }
+
+    //Order in which modes are tried for each policy, FIFO is guaranteed by the spec so every chain ends with it.
+    //Mailbox never tears so it falls back to vsync, immediate already tears so it takes mailbox first, relaxed FIFO degrades to plain vsync
+    std::span<const VkPresentModeKHR> present_mode_fallbacks(const VkPresentModeKHR p_present_mode)
+    {
+        static constexpr std::array MAILBOX_CHAIN{ VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_FIFO_KHR };
+        static constexpr std::array IMMEDIATE_CHAIN{ VK_PRESENT_MODE_IMMEDIATE_KHR, VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_FIFO_KHR };
+        static constexpr std::array FIFO_RELAXED_CHAIN{ VK_PRESENT_MODE_FIFO_RELAXED_KHR, VK_PRESENT_MODE_FIFO_KHR };
+        static constexpr std::array FIFO_CHAIN{ VK_PRESENT_MODE_FIFO_KHR };
+
+        switch (p_present_mode)
+        {
+        case VK_PRESENT_MODE_MAILBOX_KHR:
+            return MAILBOX_CHAIN;
+        case VK_PRESENT_MODE_IMMEDIATE_KHR:
+            return IMMEDIATE_CHAIN;
+        case VK_PRESENT_MODE_FIFO_RELAXED_KHR:
+            return FIFO_RELAXED_CHAIN;
+        default:
+            return FIFO_CHAIN;
+        }
+    }
+}
 
 namespace vulkan
 {
-    void Swapchain::init(const VkPhysicalDevice p_physical_device, const VkDevice p_device, const VkSurfaceKHR p_surface, const std::pair<uint32_t, uint32_t>& p_resolution, VmaAllocator p_allocator, vi::DeletionQueue& p_deletion_queue)
+    void Swapchain::init(const VkPhysicalDevice p_physical_device, const VkDevice p_device, const VkSurfaceKHR p_surface, const std::pair<uint32_t, uint32_t>& p_resolution, const vi::PresentMode p_present_mode, VmaAllocator p_allocator)
     {
-        vkb::SwapchainBuilder swapchain_builder{ p_physical_device, p_device, p_surface };
+        m_physical_device = p_physical_device;
+        m_device = p_device;
+        m_surface = p_surface;
+        m_allocator = p_allocator;
+        m_requested_present_mode = p_present_mode;
         m_swapchain_image_format = VK_FORMAT_R8G8B8A8_UNORM;
 
+        if (is_headless())
+        {
+            const auto [width, height] = p_resolution;
+            m_swapchain_extent = { width, height };
+        }
+        else
+        {
+            create_swapchain(p_resolution, VK_NULL_HANDLE);
+        }
+        create_draw_image(p_resolution);
+    }
+
+    void Swapchain::cleanup()
+    {
+        if (m_draw_image)
+        {
+            m_draw_image->cleanup();
+            m_draw_image.reset();
+        }
+
+        //headless devices are created without VK_KHR_swapchain, its commands cannot be called there
+        if (m_swapchain != VK_NULL_HANDLE)
+        {
+            vkDestroySwapchainKHR(m_device, m_swapchain, nullptr);
+            m_swapchain = VK_NULL_HANDLE;
+        }
+        std::ranges::for_each(m_swapchain_image_views, [this](const VkImageView p_image_view)
+        {
+            vkDestroyImageView(m_device, p_image_view, nullptr);
+        });
+        m_swapchain_image_views.clear();
+        m_swapchain_images.clear();
+        m_swapchain_image_states.clear();
+    }
+
+    void Swapchain::recreate(const std::pair<uint32_t, uint32_t>& p_resolution, vi::DeletionQueue& p_retire_queue)
+    {
+        const auto old_swapchain = m_swapchain;
+        const auto old_image_views = m_swapchain_image_views;
+        const auto old_draw_image = m_draw_image;
+
+        if (is_headless())
+        {
+            const auto [width, height] = p_resolution;
+            m_swapchain_extent = { width, height };
+        }
+        else
+        {
+            //the old swapchain is retired by this call, but it stays valid until destroyed
+            create_swapchain(p_resolution, old_swapchain);
+        }
+        create_draw_image({ m_swapchain_extent.width, m_swapchain_extent.height });
+
+        p_retire_queue.push_function([device = m_device, old_swapchain, old_image_views, old_draw_image]()
+        {
+            std::ranges::for_each(old_image_views, [device](const VkImageView p_image_view)
+            {
+                vkDestroyImageView(device, p_image_view, nullptr);
+            });
+            if (old_swapchain != VK_NULL_HANDLE)
+            {
+                vkDestroySwapchainKHR(device, old_swapchain, nullptr);
+            }
+            old_draw_image->cleanup();
+        });
+
+        VI_CORE_TRACE("Swapchain recreated with extent {}x{}", m_swapchain_extent.width, m_swapchain_extent.height);
+    }
+
+    vi::PresentMode Swapchain::get_present_mode() const
+    {
+        if (is_headless())
+        {
+            return m_requested_present_mode;
+        }
+
+        return from_vulkan_present_mode(m_present_mode);
+    }
+
+    void Swapchain::create_swapchain(const std::pair<uint32_t, uint32_t>& p_resolution, const VkSwapchainKHR p_old_swapchain)
+    {
+        vkb::SwapchainBuilder swapchain_builder{ m_physical_device, m_device, m_surface };
+
+        const auto present_mode = select_present_mode();
+
         const auto [width, height] = p_resolution;
-        auto vkb_swapchain = swapchain_builder
+        auto swapchain_return = swapchain_builder
             .set_desired_format(VkSurfaceFormatKHR{ .format = m_swapchain_image_format, .colorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR })
-            .set_desired_present_mode(VK_PRESENT_MODE_FIFO_KHR)
+            .set_desired_present_mode(present_mode)
+            .set_desired_min_image_count(select_image_count(present_mode))
             .set_desired_extent(width, height)
             .add_image_usage_flags(VK_IMAGE_USAGE_TRANSFER_DST_BIT)
-            .build()
-            .value();
+            .set_old_swapchain(p_old_swapchain)
+            .build();
+
+        if (!swapchain_return)
+        {
+            throw std::runtime_error(std::format("Cannot create swapchain: {}", swapchain_return.error().message()));
+        }
+
+        auto vkb_swapchain = swapchain_return.value();
 
         m_swapchain_extent = vkb_swapchain.extent;
         m_swapchain = vkb_swapchain.swapchain;
+        m_present_mode = vkb_swapchain.present_mode;
         m_swapchain_images = vkb_swapchain.get_images().value();
         m_swapchain_image_views = vkb_swapchain.get_image_views().value();
+        m_swapchain_image_states.assign(m_swapchain_images.size(), ImageState{});
 
-        m_device = p_device;
+        VI_CORE_INFO("Swapchain uses {} with {} images", string_VkPresentModeKHR(m_present_mode), m_swapchain_images.size());
+    }
+
+    VkPresentModeKHR Swapchain::select_present_mode() const
+    {
+        uint32_t mode_count{};
+        vkGetPhysicalDeviceSurfacePresentModesKHR(m_physical_device, m_surface, &mode_count, nullptr);
+        std::vector<VkPresentModeKHR> supported_modes(mode_count);
+        vkGetPhysicalDeviceSurfacePresentModesKHR(m_physical_device, m_surface, &mode_count, supported_modes.data());
+
+        const auto requested = to_vulkan_present_mode(m_requested_present_mode);
+        for (const auto candidate : present_mode_fallbacks(requested))
+        {
+            if (std::ranges::find(supported_modes, candidate) != supported_modes.end())
+            {
+                if (candidate != requested)
+                {
+                    VI_CORE_WARN("{} is not supported by the surface, falling back to {}", string_VkPresentModeKHR(requested), string_VkPresentModeKHR(candidate));
+                }
+                return candidate;
+            }
+        }
 
-        create_draw_image(p_resolution, p_allocator, p_deletion_queue);
+        return VK_PRESENT_MODE_FIFO_KHR;
     }
 
-    void Swapchain::cleanup()
+    uint32_t Swapchain::select_image_count(const VkPresentModeKHR p_present_mode) const
     {
-        vkDestroySwapchainKHR(m_device, m_swapchain, nullptr);
-        std::ranges::for_each(m_swapchain_image_views, [this](const VkImageView p_image_view)
+        VkSurfaceCapabilitiesKHR capabilities{};
+        vkGetPhysicalDeviceSurfaceCapabilitiesKHR(m_physical_device, m_surface, &capabilities);
+
+        //one image more than the minimum lets us acquire while the engine holds the others,
+        //mailbox needs a third image to always have somewhere to render while one is queued and one is on screen
+        auto image_count = capabilities.minImageCount + 1;
+        if (p_present_mode == VK_PRESENT_MODE_MAILBOX_KHR)
         {
-            vkDestroyImageView(m_device, p_image_view, nullptr);
-        });
+            image_count = std::max(image_count, 3u);
+        }
+
+        //a max of 0 means there is no limit
+        if (capabilities.maxImageCount > 0)
+        {
+            image_count = std::min(image_count, capabilities.maxImageCount);
+        }
+
+        return image_count;
     }
 
-    void Swapchain::create_draw_image(const std::pair<uint32_t, uint32_t>& p_resolution, VmaAllocator p_allocator, vi::DeletionQueue& p_deletion_queue)
+    void Swapchain::create_draw_image(const std::pair<uint32_t, uint32_t>& p_resolution)
     {
         //draw image size will match the window
         const auto [width, height] = p_resolution;
@@ -53,6 +252,6 @@ namespace vulkan
         draw_image_usages |= VK_IMAGE_USAGE_STORAGE_BIT;
         draw_image_usages |= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
 
-        m_draw_image = std::make_shared<Image>(draw_image_extent, VK_FORMAT_R16G16B16A16_SFLOAT, draw_image_usages, p_allocator, m_device, p_deletion_queue);
+        m_draw_image = std::make_shared<Image>(draw_image_extent, VK_FORMAT_R16G16B16A16_SFLOAT, draw_image_usages, m_allocator, m_device);
     }
 }
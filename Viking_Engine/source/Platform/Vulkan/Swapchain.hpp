@@ -3,7 +3,9 @@
 
 #include "Platform/Vulkan/Image.hpp"
 #include "Viking/core/DeletionQueue.hpp"
+#include "Viking/core/Window.hpp"
 
+#include <memory>
 #include <utility>
 #include <vector>
 #include <vulkan/vulkan.hpp>
@@ -21,25 +23,49 @@ namespace vulkan
         Swapchain& operator=(Swapchain&) = delete;
         Swapchain& operator=(Swapchain&&) = delete;
 
-        void init(VkPhysicalDevice p_physical_device, VkDevice p_device, VkSurfaceKHR p_surface, const std::pair<uint32_t, uint32_t>& p_resolution, VmaAllocator p_allocator, vi::DeletionQueue& p_deletion_queue);
+        //Without a surface only the draw image is created, the extent is the requested resolution and nothing can be acquired
+        void init(VkPhysicalDevice p_physical_device, VkDevice p_device, VkSurfaceKHR p_surface, const std::pair<uint32_t, uint32_t>& p_resolution, vi::PresentMode p_present_mode, VmaAllocator p_allocator);
         void cleanup();
 
+        //Rebuilds the swapchain and the draw image for the new resolution, passing the current handle as oldSwapchain.
+        //The old handles may still be used by frames in flight, so their destruction is pushed into p_retire_queue
+        //which the caller flushes once the GPU is done with them.
+        void recreate(const std::pair<uint32_t, uint32_t>& p_resolution, vi::DeletionQueue& p_retire_queue);
+
+        [[nodiscard]] bool is_headless() const { return m_surface == VK_NULL_HANDLE; }
         [[nodiscard]] VkSwapchainKHR get_swapchain() const { return m_swapchain; }
         [[nodiscard]] std::vector<VkImage>& get_images() { return m_swapchain_images; }
+        [[nodiscard]] std::vector<VkImageView>& get_image_views() { return m_swapchain_image_views; }
+        [[nodiscard]] VkFormat get_format() const { return m_swapchain_image_format; }
+        [[nodiscard]] ImageState& get_image_state(const uint32_t p_index) { return m_swapchain_image_states.at(p_index); }
 
         [[nodiscard]] std::shared_ptr<Image> get_draw_image() { return m_draw_image; }
 
         [[nodiscard]] VkExtent2D get_extent() { return m_swapchain_extent; }
 
+        //Takes effect on the next recreate
+        void set_present_mode(const vi::PresentMode p_present_mode) { m_requested_present_mode = p_present_mode; }
+        [[nodiscard]] vi::PresentMode get_present_mode() const;
+
     private:
-        void create_draw_image(const std::pair<uint32_t, uint32_t>& p_resolution, VmaAllocator p_allocator, vi::DeletionQueue& p_deletion_queue);
+        void create_swapchain(const std::pair<uint32_t, uint32_t>& p_resolution, VkSwapchainKHR p_old_swapchain);
+        void create_draw_image(const std::pair<uint32_t, uint32_t>& p_resolution);
+        [[nodiscard]] VkPresentModeKHR select_present_mode() const;
+        [[nodiscard]] uint32_t select_image_count(VkPresentModeKHR p_present_mode) const;
 
+        VkPhysicalDevice            m_physical_device{};
         VkDevice                    m_device{};
+        VkSurfaceKHR                m_surface{};
+        VmaAllocator                m_allocator{};
+
         VkSwapchainKHR              m_swapchain{};
         VkFormat                    m_swapchain_image_format{};
         std::vector<VkImage>        m_swapchain_images{};
         std::vector<VkImageView>    m_swapchain_image_views{};
+        std::vector<ImageState>     m_swapchain_image_states{};
         VkExtent2D                  m_swapchain_extent{};
+        VkPresentModeKHR            m_present_mode{ VK_PRESENT_MODE_FIFO_KHR };
+        vi::PresentMode             m_requested_present_mode{ vi::PresentMode::Fifo };
 
         std::shared_ptr<Image>      m_draw_image{};
     };
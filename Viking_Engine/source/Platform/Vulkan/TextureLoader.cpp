@@ -0,0 +1,223 @@
+#include "Platform/Vulkan/TextureLoader.hpp"
+
+#include "Platform/Vulkan/BindlessHeap.hpp"
+#include "Platform/Vulkan/Image.hpp"
+#include "Viking/core/Log.hpp"
+#include "Viking/core/Profiler.hpp"
+
+#include <vulkan/vk_enum_string_helper.h>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <exception>
+#include <format>
+#include <span>
+#include <stdexcept>
+#include <thread>
+
+namespace
+{
+    //color textures are authored in sRGB, sampling them returns linear values
+    constexpr VkFormat TEXTURE_FORMAT{ VK_FORMAT_R8G8B8A8_SRGB };
+}
+
+namespace vulkan
+{
+    void TextureLoader::init(const VkDevice p_device, const VmaAllocator p_allocator, UploadEngine& p_upload_engine, BindlessHeap& p_bindless_heap, const uint32_t p_thread_count)
+    {
+        m_device = p_device;
+        m_allocator = p_allocator;
+        m_upload_engine = &p_upload_engine;
+        m_bindless_heap = &p_bindless_heap;
+
+        VkSamplerCreateInfo sampler_info{};
+        sampler_info.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+        sampler_info.pNext = nullptr;
+        sampler_info.magFilter = VK_FILTER_LINEAR;
+        sampler_info.minFilter = VK_FILTER_LINEAR;
+        sampler_info.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+        sampler_info.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+        sampler_info.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+        sampler_info.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+        sampler_info.minLod = 0.0f;
+        sampler_info.maxLod = VK_LOD_CLAMP_NONE;
+
+        if (const auto result = vkCreateSampler(m_device, &sampler_info, nullptr, &m_sampler); result != VK_SUCCESS)
+        {
+            throw std::runtime_error(std::format("Cannot create texture sampler: {}", string_VkResult(result)));
+        }
+
+        //the placeholder is acquired by the first frame like any other upload, before a shader can sample it
+        constexpr std::array<uint8_t, 4> WHITE{ 255, 255, 255, 255 };
+        m_placeholder = std::make_shared<Image>(VkExtent3D{ 1, 1, 1 }, TEXTURE_FORMAT, VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT, m_allocator, m_device);
+        static_cast<void>(m_upload_engine->upload(*m_placeholder, std::as_bytes(std::span{ WHITE }), ImageUsage::ShaderRead));
+        m_placeholder_index = m_bindless_heap->register_sampled_image(m_placeholder->get_allocated_image().image_view, m_sampler);
+
+        m_thread_pool.init("Texture", p_thread_count);
+    }
+
+    void TextureLoader::cleanup()
+    {
+        //a decode waiting for staging space only continues once the render thread flushes,
+        //so this thread keeps flushing until every decode has returned instead of joining the workers right away
+        m_stopping.store(true, std::memory_order_relaxed);
+        while (m_pending_decodes.load(std::memory_order_acquire) > 0)
+        {
+            m_upload_engine->flush();
+            std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+        }
+
+        //no decode runs after this, and the uploads they made have to finish before their images go
+        m_thread_pool.shutdown();
+
+        for (auto& texture : m_textures)
+        {
+            if (texture.m_status == TextureStatus::Uploaded)
+            {
+                m_upload_engine->wait(texture.m_upload);
+            }
+            if (texture.m_image)
+            {
+                texture.m_image->cleanup();
+            }
+        }
+        m_textures.clear();
+        m_uploaded.clear();
+
+        m_placeholder->cleanup();
+        m_placeholder.reset();
+        vkDestroySampler(m_device, m_sampler, nullptr);
+    }
+
+    vi::TextureHandle TextureLoader::load(const std::filesystem::path& p_path)
+    {
+        uint32_t id{};
+        {
+            std::scoped_lock lock{ m_mutex };
+            id = static_cast<uint32_t>(m_textures.size());
+            m_textures.push_back({ .m_path = p_path, .m_bindless_index = m_placeholder_index });
+        }
+
+        //the future is not kept, decode reports its own failures
+        m_pending_decodes.fetch_add(1, std::memory_order_relaxed);
+        static_cast<void>(m_thread_pool.submit([this, id]()
+        {
+            //counted down however the decode ends, cleanup waits for zero
+            struct PendingDecode
+            {
+                std::atomic<uint32_t>& m_count;
+                ~PendingDecode() { m_count.fetch_sub(1, std::memory_order_release); }
+            } pending{ m_pending_decodes };
+
+            if (!m_stopping.load(std::memory_order_relaxed))
+            {
+                decode(id);
+            }
+        }));
+
+        return { id };
+    }
+
+    void TextureLoader::update(const VkCommandBuffer p_cmd, const uint64_t p_acquired_value)
+    {
+        VI_PROFILE_FUNCTION();
+
+        std::scoped_lock lock{ m_mutex };
+        std::erase_if(m_uploaded, [this, p_cmd, p_acquired_value](const uint32_t p_id)
+        {
+            auto& texture = m_textures[p_id];
+            if (texture.m_upload.value > p_acquired_value)
+            {
+                return false;
+            }
+
+            //mip 0 and its ownership are on the graphics queue now, the frame waits for the transfer before this runs.
+            //A fresh index is never read by earlier frames, unlike the placeholder's which they may be sampling
+            generate_mipmaps(p_cmd, *texture.m_image, ImageUsage::ShaderRead);
+            texture.m_bindless_index = m_bindless_heap->register_sampled_image(texture.m_image->get_allocated_image().image_view, m_sampler);
+            texture.m_status = TextureStatus::Ready;
+            return true;
+        });
+    }
+
+    uint32_t TextureLoader::get_bindless_index(const vi::TextureHandle p_texture) const
+    {
+        std::scoped_lock lock{ m_mutex };
+        if (p_texture.Id >= m_textures.size())
+        {
+            return m_placeholder_index;
+        }
+
+        return m_textures[p_texture.Id].m_bindless_index;
+    }
+
+    bool TextureLoader::is_ready(const vi::TextureHandle p_texture) const
+    {
+        std::scoped_lock lock{ m_mutex };
+        return p_texture.Id < m_textures.size() && m_textures[p_texture.Id].m_status == TextureStatus::Ready;
+    }
+
+    void TextureLoader::decode(const uint32_t p_id)
+    {
+        VI_PROFILE_FUNCTION();
+
+        std::filesystem::path path{};
+        {
+            std::scoped_lock lock{ m_mutex };
+            path = m_textures[p_id].m_path;
+        }
+
+        int32_t width{};
+        int32_t height{};
+        int32_t channels{};
+        //every texture is expanded to RGBA, three channel formats are rarely supported for sampling
+        auto* pixels = stbi_load(path.string().c_str(), &width, &height, &channels, STBI_rgb_alpha);
+        if (pixels == nullptr)
+        {
+            VI_CORE_ERROR("Cannot load texture {}: {}", path.string(), stbi_failure_reason());
+            std::scoped_lock lock{ m_mutex };
+            m_textures[p_id].m_status = TextureStatus::Failed;
+            return;
+        }
+
+        std::shared_ptr<Image> image{};
+        UploadToken upload{};
+        try
+        {
+            const VkExtent3D extent{ static_cast<uint32_t>(width), static_cast<uint32_t>(height), 1 };
+            image = std::make_shared<Image>(extent, TEXTURE_FORMAT, VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                m_allocator, m_device, mip_level_count(extent));
+
+            //the rest of the chain is blitted on the graphics queue, so the whole image stays a transfer destination
+            const auto size = static_cast<size_t>(width) * static_cast<size_t>(height) * 4;
+            upload = m_upload_engine->upload(*image, std::as_bytes(std::span{ pixels, size }), ImageUsage::TransferDst);
+        }
+        catch (const std::exception& p_exception)
+        {
+            VI_CORE_ERROR("Cannot upload texture {}: {}", path.string(), p_exception.what());
+            stbi_image_free(pixels);
+            if (image)
+            {
+                image->cleanup();
+            }
+
+            std::scoped_lock lock{ m_mutex };
+            m_textures[p_id].m_status = TextureStatus::Failed;
+            return;
+        }
+        stbi_image_free(pixels);
+
+        VI_CORE_TRACE("Texture {} decoded, {}x{} with {} mip levels", path.string(), width, height, image->get_allocated_image().mip_levels);
+
+        std::scoped_lock lock{ m_mutex };
+        auto& texture = m_textures[p_id];
+        texture.m_image = std::move(image);
+        texture.m_upload = upload;
+        texture.m_status = TextureStatus::Uploaded;
+        m_uploaded.push_back(p_id);
+    }
+}
@@ -0,0 +1,92 @@
+#ifndef VULKAN_TEXTURE_LOADER_HPP
+#define VULKAN_TEXTURE_LOADER_HPP
+
+#include "Platform/Vulkan/UploadEngine.hpp"
+#include "Viking/core/ThreadPool.hpp"
+#include "Viking/renderer/Texture.hpp"
+
+#include <vulkan/vulkan.hpp>
+
+#include <vk_mem_alloc.h>
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace vulkan
+{
+    class BindlessHeap;
+    class Image;
+
+    //Loads image files into sampled textures without blocking the frame loop.
+    //Files are decoded by stb_image on worker threads, which also create the image and upload mip 0 through the UploadEngine.
+    //Once the upload has been acquired by a frame, that frame blits the rest of the mip chain and the texture
+    //gets its own bindless index. Until then the handle resolves to a 1x1 white placeholder
+    class TextureLoader
+    {
+    public:
+        //Decoding comes in bursts, a couple of threads keep it from competing with the recording workers
+        void init(VkDevice p_device, VmaAllocator p_allocator, UploadEngine& p_upload_engine, BindlessHeap& p_bindless_heap, uint32_t p_thread_count = 2);
+        //Waits for the decodes in progress and skips the queued ones, the GPU has to be idle
+        void cleanup();
+
+        //Returns at once, the file is read and decoded in the background. Safe to call from any thread
+        [[nodiscard]] vi::TextureHandle load(const std::filesystem::path& p_path);
+
+        //Finishes the textures whose uploads the frame has acquired, p_acquired_value is the highest transfer
+        //timeline value the graphics queue waits on so far. Records into the frame's graphics command buffer
+        void update(VkCommandBuffer p_cmd, uint64_t p_acquired_value);
+
+        //Index into the sampled images of the bindless heap, the placeholder's until the texture is ready
+        [[nodiscard]] uint32_t get_bindless_index(vi::TextureHandle p_texture) const;
+        [[nodiscard]] bool is_ready(vi::TextureHandle p_texture) const;
+
+        [[nodiscard]] VkSampler get_sampler() const { return m_sampler; }
+
+    private:
+        enum class TextureStatus
+        {
+            Loading,
+            Uploaded,
+            Ready,
+            Failed
+        };
+
+        struct Texture
+        {
+            std::filesystem::path m_path{};
+            std::shared_ptr<Image> m_image{};
+            UploadToken m_upload{};
+            TextureStatus m_status{ TextureStatus::Loading };
+            uint32_t m_bindless_index{};
+        };
+
+        void decode(uint32_t p_id);
+
+        VkDevice m_device{};
+        VmaAllocator m_allocator{};
+        UploadEngine* m_upload_engine{};
+        BindlessHeap* m_bindless_heap{};
+
+        VkSampler m_sampler{};
+        std::shared_ptr<Image> m_placeholder{};
+        uint32_t m_placeholder_index{};
+
+        vi::ThreadPool m_thread_pool{};
+        //decodes queued or running, cleanup keeps flushing uploads until they are gone
+        std::atomic<uint32_t> m_pending_decodes{ 0 };
+        //queued decodes are skipped once cleanup has started
+        std::atomic<bool> m_stopping{ false };
+
+        //guards the texture table, workers only change the status and image of their own entry
+        mutable std::mutex m_mutex{};
+        std::vector<Texture> m_textures{};
+        //textures whose mip 0 is uploaded, waiting for a frame to finish them
+        std::vector<uint32_t> m_uploaded{};
+    };
+}
+
+#endif // VULKAN_TEXTURE_LOADER_HPP
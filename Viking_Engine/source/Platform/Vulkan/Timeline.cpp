@@ -0,0 +1,70 @@
+#include "Platform/Vulkan/Timeline.hpp"
+
+#include <vulkan/vk_enum_string_helper.h>
+
+#include <format>
+#include <stdexcept>
+
+namespace vulkan
+{
+    void Timeline::init(const VkDevice p_device)
+    {
+        m_device = p_device;
+
+        VkSemaphoreTypeCreateInfo type_info{};
+        type_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+        type_info.pNext = nullptr;
+        type_info.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        type_info.initialValue = 0;
+
+        VkSemaphoreCreateInfo info{};
+        info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        info.pNext = &type_info;
+        info.flags = 0;
+
+        if (const auto result = vkCreateSemaphore(m_device, &info, nullptr, &m_semaphore); result != VK_SUCCESS)
+        {
+            throw std::runtime_error(std::format("Cannot create timeline semaphore: {}", string_VkResult(result)));
+        }
+
+        m_value = 0;
+    }
+
+    void Timeline::cleanup()
+    {
+        vkDestroySemaphore(m_device, m_semaphore, nullptr);
+        m_semaphore = VK_NULL_HANDLE;
+    }
+
+    uint64_t Timeline::get_completed_value() const
+    {
+        uint64_t value{};
+        if (const auto result = vkGetSemaphoreCounterValue(m_device, m_semaphore, &value); result != VK_SUCCESS)
+        {
+            throw std::runtime_error(std::format("Cannot read timeline semaphore value: {}", string_VkResult(result)));
+        }
+
+        return value;
+    }
+
+    bool Timeline::is_reached(const uint64_t p_value) const
+    {
+        return get_completed_value() >= p_value;
+    }
+
+    void Timeline::wait(const uint64_t p_value, const uint64_t p_timeout) const
+    {
+        VkSemaphoreWaitInfo wait_info{};
+        wait_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+        wait_info.pNext = nullptr;
+        wait_info.flags = 0;
+        wait_info.semaphoreCount = 1;
+        wait_info.pSemaphores = &m_semaphore;
+        wait_info.pValues = &p_value;
+
+        if (const auto result = vkWaitSemaphores(m_device, &wait_info, p_timeout); result != VK_SUCCESS)
+        {
+            throw std::runtime_error(std::format("Something wrong occured when waiting for timeline value {}: {}", p_value, string_VkResult(result)));
+        }
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef VULKAN_TIMELINE_HPP
+#define VULKAN_TIMELINE_HPP
+
+#include <vulkan/vulkan.hpp>
+
+#include <atomic>
+#include <cstdint>
+
+namespace vulkan
+{
+    //Wrapper around a single VK_SEMAPHORE_TYPE_TIMELINE semaphore owned by one queue.
+    //Every submission to that queue reserves the next value and signals it, so the CPU can
+    //wait for (or poll) any earlier submission without a fence per submission.
+    class Timeline
+    {
+    public:
+        Timeline() = default;
+        ~Timeline() = default;
+        Timeline(Timeline&) = delete;
+        Timeline(Timeline&&) = delete;
+
+        Timeline& operator=(Timeline&) = delete;
+        Timeline& operator=(Timeline&&) = delete;
+
+        void init(VkDevice p_device);
+        void cleanup();
+
+        [[nodiscard]] VkSemaphore get_semaphore() const { return m_semaphore; }
+
+        //Reserves the value that the next submission on the owning queue will signal
+        [[nodiscard]] uint64_t next_value() { return ++m_value; }
+        //Last value handed out by next_value, the queue is idle once it is reached
+        [[nodiscard]] uint64_t get_last_value() const { return m_value; }
+        //Value the GPU has actually reached
+        [[nodiscard]] uint64_t get_completed_value() const;
+
+        [[nodiscard]] bool is_reached(uint64_t p_value) const;
+        void wait(uint64_t p_value, uint64_t p_timeout) const;
+
+    private:
+        VkDevice m_device{};
+        VkSemaphore m_semaphore{};
+        std::atomic<uint64_t> m_value{ 0 };
+    };
+}
+
+#endif // VULKAN_TIMELINE_HPP
@@ -0,0 +1,400 @@
+#include "Platform/Vulkan/UploadEngine.hpp"
+
+#include "Platform/Vulkan/Buffer.hpp"
+#include "Platform/Vulkan/Image.hpp"
+#include "Platform/Vulkan/Timeline.hpp"
+#include "Viking/core/Log.hpp"
+#include "Viking/core/Profiler.hpp"
+
+#include <vulkan/vk_enum_string_helper.h>
+
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+namespace
+{
+    //covers the offset alignment of buffer copies and of every texel size used for image copies
+    constexpr VkDeviceSize STAGING_ALIGNMENT{ 16 };
+
+    constexpr uint64_t align_up(const uint64_t p_value, const uint64_t p_alignment)
+    {
+        return (p_value + p_alignment - 1) / p_alignment * p_alignment;
+    }
+}
+
+namespace vulkan
+{
+    void UploadEngine::init(const VkDevice p_device, const VmaAllocator p_allocator, const VkQueue p_queue, const uint32_t p_queue_family, Timeline& p_timeline, const uint32_t p_graphics_family, const VkDeviceSize p_ring_size)
+    {
+        m_device = p_device;
+        m_queue = p_queue;
+        m_queue_family = p_queue_family;
+        m_graphics_family = p_graphics_family;
+        m_timeline = &p_timeline;
+        m_ring_size = p_ring_size;
+        m_render_thread = std::this_thread::get_id();
+
+        VkCommandPoolCreateInfo pool_info{};
+        pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        pool_info.pNext = nullptr;
+        pool_info.queueFamilyIndex = m_queue_family;
+        pool_info.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+        if (const auto result = vkCreateCommandPool(m_device, &pool_info, nullptr, &m_command_pool); result != VK_SUCCESS)
+        {
+            throw std::runtime_error(std::format("Cannot create upload command pool: {}", string_VkResult(result)));
+        }
+
+        //written once by the CPU and read once by the GPU, so sequential writes to host memory are enough
+        m_staging = std::make_unique<Buffer>(m_ring_size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_AUTO_PREFER_HOST, p_allocator, m_device,
+            VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT);
+        m_staging_data = static_cast<std::byte*>(m_staging->get_mapped_data());
+
+        m_ring_head = 0;
+        m_ring_tail = 0;
+
+        VI_CORE_INFO("Upload engine uses queue family {} with a {} MiB staging ring", m_queue_family, m_ring_size / (1024 * 1024));
+    }
+
+    void UploadEngine::cleanup()
+    {
+        {
+            std::scoped_lock lock{ m_mutex };
+            flush_locked();
+        }
+
+        if (!m_in_flight.empty())
+        {
+            m_timeline->wait(m_in_flight.back().m_value, std::numeric_limits<uint64_t>::max());
+        }
+        m_in_flight.clear();
+
+        vkDestroyCommandPool(m_device, m_command_pool, nullptr);
+        m_free_cmds.clear();
+
+        m_staging->cleanup();
+        m_staging.reset();
+        m_staging_data = nullptr;
+    }
+
+    UploadToken UploadEngine::upload(Buffer& p_destination, const std::span<const std::byte> p_data, const BufferUsage p_final_usage, const VkDeviceSize p_destination_offset)
+    {
+        VI_PROFILE_FUNCTION();
+
+        if (p_destination_offset + p_data.size() > p_destination.get_size())
+        {
+            throw std::runtime_error(std::format("Upload of {} bytes at offset {} does not fit a buffer of {} bytes", p_data.size(), p_destination_offset, p_destination.get_size()));
+        }
+
+        std::unique_lock lock{ m_mutex };
+
+        //the destination is idle, whatever used it last is ordered by the caller
+        p_destination.get_state() = {};
+
+        VkDeviceSize copied{ 0 };
+        while (copied < p_data.size())
+        {
+            const auto chunk_size = std::min<VkDeviceSize>(p_data.size() - copied, m_ring_size);
+            const auto staging_offset = allocate_staging(lock, chunk_size);
+            std::memcpy(m_staging_data + staging_offset, p_data.data() + copied, chunk_size);
+
+            const auto cmd = get_recording_cmd();
+            m_barriers.access(p_destination, BufferUsage::TransferDst);
+            m_barriers.flush(cmd);
+
+            VkBufferCopy copy{};
+            copy.srcOffset = staging_offset;
+            copy.dstOffset = p_destination_offset + copied;
+            copy.size = chunk_size;
+            vkCmdCopyBuffer(cmd, m_staging->get_buffer(), p_destination.get_buffer(), 1, &copy);
+
+            copied += chunk_size;
+        }
+
+        if (p_destination.is_concurrent())
+        {
+            //no ownership to hand over, the semaphore the graphics submission waits on makes the copy visible
+            p_destination.get_state() = {};
+        }
+        else if (m_queue_family == m_graphics_family)
+        {
+            m_barriers.access(p_destination, p_final_usage);
+        }
+        else
+        {
+            m_barriers.transfer(p_destination.get_buffer(), p_destination.get_state(), buffer_state(p_final_usage), m_queue_family, m_graphics_family, m_recording_acquires);
+        }
+        m_barriers.flush(get_recording_cmd());
+
+        return { m_timeline->get_last_value() + 1 };
+    }
+
+    UploadToken UploadEngine::upload(Image& p_destination, const std::span<const std::byte> p_data, const ImageUsage p_final_usage)
+    {
+        VI_PROFILE_FUNCTION();
+
+        const auto allocated_image = p_destination.get_allocated_image();
+        const auto aspect = aspect_from_format(allocated_image.image_format);
+        const auto extent = allocated_image.image_extent;
+
+        //the texels are split into rows of single slices, the same way buffers are split into ring sized chunks
+        const auto row_count = static_cast<VkDeviceSize>(extent.height) * extent.depth;
+        const auto row_size = p_data.size() / row_count;
+        if (row_size * row_count != p_data.size() || row_size > m_ring_size)
+        {
+            throw std::runtime_error(std::format("Image upload of {} bytes does not split into {} rows that fit the {} bytes staging ring", p_data.size(), row_count, m_ring_size));
+        }
+
+        std::unique_lock lock{ m_mutex };
+
+        //every texel is replaced, the previous contents are discarded
+        p_destination.get_state() = {};
+        m_barriers.transition(p_destination, ImageUsage::TransferDst, true);
+        m_barriers.flush(get_recording_cmd());
+
+        VkDeviceSize copied_rows{ 0 };
+        while (copied_rows < row_count)
+        {
+            const auto slice = static_cast<uint32_t>(copied_rows / extent.height);
+            const auto first_row = static_cast<uint32_t>(copied_rows % extent.height);
+            const auto rows = static_cast<uint32_t>(std::min<VkDeviceSize>(extent.height - first_row, m_ring_size / row_size));
+            const auto chunk_size = rows * row_size;
+
+            const auto staging_offset = allocate_staging(lock, chunk_size);
+            std::memcpy(m_staging_data + staging_offset, p_data.data() + copied_rows * row_size, chunk_size);
+
+            VkBufferImageCopy copy{};
+            copy.bufferOffset = staging_offset;
+            copy.bufferRowLength = 0;
+            copy.bufferImageHeight = 0;
+            copy.imageSubresource.aspectMask = aspect;
+            copy.imageSubresource.mipLevel = 0;
+            copy.imageSubresource.baseArrayLayer = 0;
+            copy.imageSubresource.layerCount = 1;
+            copy.imageOffset = { 0, static_cast<int32_t>(first_row), static_cast<int32_t>(slice) };
+            copy.imageExtent = { extent.width, rows, 1 };
+            vkCmdCopyBufferToImage(get_recording_cmd(), m_staging->get_buffer(), allocated_image.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copy);
+
+            copied_rows += rows;
+        }
+
+        if (m_queue_family == m_graphics_family)
+        {
+            m_barriers.transition(p_destination, p_final_usage);
+        }
+        else
+        {
+            m_barriers.transfer(allocated_image.image, p_destination.get_state(), image_state(p_final_usage), m_queue_family, m_graphics_family, m_recording_acquires, aspect);
+        }
+        m_barriers.flush(get_recording_cmd());
+
+        return { m_timeline->get_last_value() + 1 };
+    }
+
+    void UploadEngine::flush()
+    {
+        std::scoped_lock lock{ m_mutex };
+        flush_locked();
+    }
+
+    bool UploadEngine::is_complete(const UploadToken p_token) const
+    {
+        return m_timeline->is_reached(p_token.value);
+    }
+
+    void UploadEngine::wait(const UploadToken p_token)
+    {
+        {
+            std::scoped_lock lock{ m_mutex };
+            if (p_token.value > m_timeline->get_last_value())
+            {
+                flush_locked();
+            }
+        }
+
+        m_timeline->wait(p_token.value, std::numeric_limits<uint64_t>::max());
+    }
+
+    std::optional<UploadWait> UploadEngine::acquire(const VkCommandBuffer p_cmd)
+    {
+        std::scoped_lock lock{ m_mutex };
+
+        auto wait = m_pending_wait;
+        if (wait)
+        {
+            //the whole transfer queue work is awaited, the barriers only move ownership and layouts
+            const auto stages = m_pending_acquires.get_dst_stages();
+            wait->stage = stages != VK_PIPELINE_STAGE_2_NONE ? stages : VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+            m_pending_acquires.flush(p_cmd);
+            m_pending_wait.reset();
+        }
+
+        return wait;
+    }
+
+    VkDeviceSize UploadEngine::allocate_staging(std::unique_lock<std::mutex>& p_lock, const VkDeviceSize p_size)
+    {
+        while (true)
+        {
+            reclaim_completed();
+
+            auto position = align_up(m_ring_head, STAGING_ALIGNMENT);
+            //an allocation never wraps, it moves to the start of the ring instead
+            if (position % m_ring_size + p_size > m_ring_size)
+            {
+                position = align_up(position, m_ring_size);
+            }
+
+            if (position + p_size - m_ring_tail <= m_ring_size)
+            {
+                m_ring_head = position + p_size;
+                return position % m_ring_size;
+            }
+
+            VI_PROFILE_ZONE("Wait for staging space");
+            if (!m_in_flight.empty())
+            {
+                //other threads keep recording while the GPU reads the oldest batch
+                const auto value = m_in_flight.front().m_value;
+                p_lock.unlock();
+                m_timeline->wait(value, std::numeric_limits<uint64_t>::max());
+                p_lock.lock();
+            }
+            else if (std::this_thread::get_id() == m_render_thread)
+            {
+                //the batch being recorded is what fills the ring
+                flush_locked();
+            }
+            else
+            {
+                //the queue may be shared with graphics, the batch being recorded waits for the render thread to submit it
+                m_flushed.wait(p_lock);
+            }
+        }
+    }
+
+    VkCommandBuffer UploadEngine::get_recording_cmd()
+    {
+        if (m_recording)
+        {
+            return m_recording->m_cmd;
+        }
+
+        VkCommandBuffer cmd{};
+        if (!m_free_cmds.empty())
+        {
+            cmd = m_free_cmds.back();
+            m_free_cmds.pop_back();
+            vkResetCommandBuffer(cmd, 0);
+        }
+        else
+        {
+            VkCommandBufferAllocateInfo alloc_info{};
+            alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            alloc_info.pNext = nullptr;
+            alloc_info.commandPool = m_command_pool;
+            alloc_info.commandBufferCount = 1;
+            alloc_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+
+            if (const auto result = vkAllocateCommandBuffers(m_device, &alloc_info, &cmd); result != VK_SUCCESS)
+            {
+                throw std::runtime_error(std::format("Cannot allocate upload command buffer: {}", string_VkResult(result)));
+            }
+        }
+
+        VkCommandBufferBeginInfo begin_info{};
+        begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        begin_info.pNext = nullptr;
+        begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+        if (const auto result = vkBeginCommandBuffer(cmd, &begin_info); result != VK_SUCCESS)
+        {
+            throw std::runtime_error(std::format("Cannot begin upload command buffer: {}", string_VkResult(result)));
+        }
+
+        m_recording = Batch{ .m_cmd = cmd };
+        return cmd;
+    }
+
+    void UploadEngine::flush_locked()
+    {
+        if (!m_recording)
+        {
+            return;
+        }
+
+        VI_PROFILE_FUNCTION();
+
+        auto batch = *m_recording;
+        m_recording.reset();
+
+        if (const auto result = vkEndCommandBuffer(batch.m_cmd); result != VK_SUCCESS)
+        {
+            throw std::runtime_error(std::format("Cannot end upload command buffer: {}", string_VkResult(result)));
+        }
+
+        batch.m_value = m_timeline->next_value();
+        batch.m_ring_end = m_ring_head;
+
+        VkCommandBufferSubmitInfo cmd_info{};
+        cmd_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO;
+        cmd_info.pNext = nullptr;
+        cmd_info.commandBuffer = batch.m_cmd;
+        cmd_info.deviceMask = 0;
+
+        VkSemaphoreSubmitInfo signal_info{};
+        signal_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+        signal_info.pNext = nullptr;
+        signal_info.semaphore = m_timeline->get_semaphore();
+        signal_info.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+        signal_info.value = batch.m_value;
+        signal_info.deviceIndex = 0;
+
+        VkSubmitInfo2 submit{};
+        submit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
+        submit.pNext = nullptr;
+        submit.commandBufferInfoCount = 1;
+        submit.pCommandBufferInfos = &cmd_info;
+        submit.signalSemaphoreInfoCount = 1;
+        submit.pSignalSemaphoreInfos = &signal_info;
+
+        if (const auto result = vkQueueSubmit2(m_queue, 1, &submit, VK_NULL_HANDLE); result != VK_SUCCESS)
+        {
+            throw std::runtime_error(std::format("Cannot submit uploads: {}", string_VkResult(result)));
+        }
+
+        m_in_flight.push_back(batch);
+
+        //graphics can only take the resources over once this batch is done
+        m_pending_acquires.append(m_recording_acquires);
+        m_pending_wait = UploadWait{ .value = batch.m_value };
+        m_flushed.notify_all();
+    }
+
+    void UploadEngine::reclaim_completed()
+    {
+        if (m_in_flight.empty())
+        {
+            return;
+        }
+
+        const auto completed_value = m_timeline->get_completed_value();
+        while (!m_in_flight.empty() && m_in_flight.front().m_value <= completed_value)
+        {
+            m_ring_tail = m_in_flight.front().m_ring_end;
+            m_free_cmds.push_back(m_in_flight.front().m_cmd);
+            m_in_flight.pop_front();
+        }
+
+        //nothing in flight, nothing being recorded: the ring starts over at offset 0, so any allocation up to its size fits
+        if (m_in_flight.empty() && !m_recording)
+        {
+            m_ring_head = align_up(m_ring_head, m_ring_size);
+            m_ring_tail = m_ring_head;
+        }
+    }
+}
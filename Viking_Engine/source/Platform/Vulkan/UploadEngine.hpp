@@ -0,0 +1,117 @@
+#ifndef VULKAN_UPLOAD_ENGINE_HPP
+#define VULKAN_UPLOAD_ENGINE_HPP
+
+#include "Platform/Vulkan/Barrier.hpp"
+
+#include <vulkan/vulkan.hpp>
+
+#include <vk_mem_alloc.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace vulkan
+{
+    class Buffer;
+    class Image;
+    class Timeline;
+
+    //Identifies the batch an upload went into, complete once the transfer timeline reaches value
+    struct UploadToken
+    {
+        uint64_t value{};
+    };
+
+    //What the graphics submission has to wait on before it may use the uploaded resources
+    struct UploadWait
+    {
+        uint64_t value{};
+        VkPipelineStageFlags2 stage{ VK_PIPELINE_STAGE_2_NONE };
+    };
+
+    //Copies data to device-local buffers and images through a persistently mapped staging ring.
+    //Uploads are recorded into one command buffer and submitted together to the transfer queue on flush.
+    //Staging space is reused as soon as the batch that read it completes. Destinations must not be in use by the GPU while they are written.
+    //upload, is_complete and acquire may be called from any thread; flush and wait submit to the transfer queue,
+    //which can be shared with other queues, so they belong to the render thread that called init.
+    //Only that thread ever submits: a full ring makes other threads wait for its next flush and for the GPU to read the oldest batch
+    class UploadEngine
+    {
+    public:
+        static constexpr VkDeviceSize DEFAULT_RING_SIZE{ 64ull * 1024 * 1024 };
+
+        void init(VkDevice p_device, VmaAllocator p_allocator, VkQueue p_queue, uint32_t p_queue_family, Timeline& p_timeline, uint32_t p_graphics_family, VkDeviceSize p_ring_size = DEFAULT_RING_SIZE);
+        void cleanup();
+
+        //Buffers larger than the ring are split over several batches. Concurrently shared buffers can take
+        //uploads into parts the GPU is not using while other parts are read, p_final_usage is ignored for them
+        UploadToken upload(Buffer& p_destination, std::span<const std::byte> p_data, BufferUsage p_final_usage, VkDeviceSize p_destination_offset = 0);
+        //Fills mip 0 from tightly packed texels. Images larger than the ring are split by rows over several batches
+        UploadToken upload(Image& p_destination, std::span<const std::byte> p_data, ImageUsage p_final_usage);
+
+        void flush();
+
+        [[nodiscard]] bool is_complete(UploadToken p_token) const;
+        void wait(UploadToken p_token);
+
+        //Records the graphics half of the ownership transfers of every submitted batch into p_cmd.
+        //The submission of p_cmd has to wait on the returned value of the transfer timeline
+        [[nodiscard]] std::optional<UploadWait> acquire(VkCommandBuffer p_cmd);
+
+    private:
+        struct Batch
+        {
+            VkCommandBuffer m_cmd{};
+            uint64_t m_value{};
+            //ring position right after the last byte the batch reads
+            uint64_t m_ring_end{};
+        };
+
+        //Returns the ring offset of p_size free bytes, waiting with p_lock released while the ring is full
+        [[nodiscard]] VkDeviceSize allocate_staging(std::unique_lock<std::mutex>& p_lock, VkDeviceSize p_size);
+        [[nodiscard]] VkCommandBuffer get_recording_cmd();
+        void flush_locked();
+        void reclaim_completed();
+
+        VkDevice m_device{};
+        VkQueue m_queue{};
+        uint32_t m_queue_family{};
+        uint32_t m_graphics_family{};
+        Timeline* m_timeline{};
+
+        VkCommandPool m_command_pool{};
+        std::vector<VkCommandBuffer> m_free_cmds{};
+
+        std::unique_ptr<Buffer> m_staging{};
+        std::byte* m_staging_data{};
+        VkDeviceSize m_ring_size{};
+        //positions grow forever, the ring offset is the position modulo the size
+        uint64_t m_ring_head{};
+        uint64_t m_ring_tail{};
+
+        std::optional<Batch> m_recording{};
+        std::deque<Batch> m_in_flight{};
+
+        BarrierBatch m_barriers{};
+        //acquires of submitted batches not yet recorded on graphics
+        BarrierBatch m_pending_acquires{};
+        std::optional<UploadWait> m_pending_wait{};
+        //releases of the batch being recorded, they join m_pending_acquires when it is submitted
+        BarrierBatch m_recording_acquires{};
+
+        std::thread::id m_render_thread{};
+        mutable std::mutex m_mutex{};
+        //notified on every submission, uploads waiting for staging space recheck the ring
+        std::condition_variable m_flushed{};
+    };
+}
+
+#endif // VULKAN_UPLOAD_ENGINE_HPP
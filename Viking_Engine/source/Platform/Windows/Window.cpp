@@ -29,6 +29,13 @@ namespace windows
 
     void Window::on_update()
     {
+        //a minimized window has nothing to present, so the loop sleeps until an event restores or closes it
+        if (const auto& [width, height] = m_window_props.Size; width == 0 || height == 0)
+        {
+            glfwWaitEvents();
+            return;
+        }
+
         glfwPollEvents();
     }
 
@@ -47,6 +54,11 @@ namespace windows
         return m_window_props.Size;
     }
 
+    vi::PresentMode Window::get_present_mode() const
+    {
+        return m_window_props.Present;
+    }
+
     float Window::get_time() const
     {
         return static_cast<float>(glfwGetTime());
@@ -64,7 +76,9 @@ namespace windows
 
     void Window::init()
     {
+#ifdef _WIN32
         glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_WIN32);
+#endif
         if (!glfwInit())
         {
             throw std::runtime_error("Cannot initialize GLFW");
@@ -89,10 +103,20 @@ namespace windows
             throw std::runtime_error("Cannot create GLFW window");
         }
 
+        glfwSetWindowUserPointer(m_window, this);
+
         glfwSetWindowCloseCallback(m_window, [](GLFWwindow*)
         {
             VI_CORE_TRACE("Received window should close");
             vi::EventDispatcher::send_event(std::make_shared<vi::WindowCloseEvent>());
         });
+
+        //the swapchain follows the framebuffer, which is 0x0 while the window is minimized
+        glfwSetFramebufferSizeCallback(m_window, [](GLFWwindow* p_window, const int p_width, const int p_height)
+        {
+            auto* window = static_cast<Window*>(glfwGetWindowUserPointer(p_window));
+            window->m_window_props.Size = { p_width, p_height };
+            vi::EventDispatcher::send_event(std::make_shared<vi::WindowResizeEvent>(static_cast<uint32_t>(p_width), static_cast<uint32_t>(p_height)));
+        });
     }
 }
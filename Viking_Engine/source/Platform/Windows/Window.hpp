@@ -20,6 +20,7 @@ public:
     void on_update() override;
     void on_swap() override;
     [[nodiscard]] std::pair<int32_t, int32_t> get_size() const override;
+    [[nodiscard]] vi::PresentMode get_present_mode() const override;
     [[nodiscard]] float get_time() const override;
 
     [[nodiscard]] VkSurfaceKHR create_surface(VkInstance p_instance) const;
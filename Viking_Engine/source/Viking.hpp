@@ -8,5 +8,6 @@
 #include "Viking/core/Application.hpp"
 #include "Viking/core/Layer.hpp"
 #include "Viking/core/Log.hpp"
+#include "Viking/core/Profiler.hpp"
 
 #endif //VIKING_HPP
@@ -4,18 +4,28 @@
 
 #include "Viking/core/Application.hpp"
 #include "Viking/core/Log.hpp"
+#include "Viking/core/Profiler.hpp"
+#include "Viking/event/ApplicationEvent.hpp"
 #include "Viking/event/DispatcherEvent.hpp"
 
 #include <algorithm>
+#include <cstdlib>
 
 namespace vi {
-Application::Application(const std::string_view &p_name): m_application_name{p_name}
+Application::Application(const std::string_view &p_name, RendererProps p_renderer_props): m_application_name{p_name}, m_window_props{m_application_name, {800, 600}}, m_renderer_props{p_renderer_props}
 {
 }
 
 void Application::init()
 {
-    m_window = Window::create(WindowProps{m_application_name, {800, 600}});
+    Profiler::set_thread_name("Main");
+
+    if (const auto* headless = std::getenv("VIKING_HEADLESS"); headless != nullptr)
+    {
+        set_headless(static_cast<uint32_t>(std::strtoul(headless, nullptr, 10)));
+    }
+
+    m_window = Window::create(m_window_props);
     VI_CORE_INFO("{} initialized", m_application_name);
 
     EventDispatcher::add_listener(EventType::WindowClose, [this](const EventPointer&)
@@ -23,13 +33,21 @@ void Application::init()
         m_running = false;
     });
 
-    m_renderer.init(m_application_name, m_window);
+    EventDispatcher::add_listener(EventType::WindowResize, [this](const EventPointer& p_event)
+    {
+        const auto resize_event = std::static_pointer_cast<WindowResizeEvent>(p_event);
+        m_renderer.on_resize(resize_event->get_width(), resize_event->get_height());
+    });
+
+    m_renderer.init(m_application_name, m_window, m_renderer_props);
 }
 
 void Application::run()
 {
     while (m_running)
     {
+        VI_PROFILE_ZONE("Frame");
+
         EventDispatcher::dispatch();
 
         const auto now = m_window->get_time();
@@ -38,6 +56,7 @@ void Application::run()
 
         std::ranges::for_each(m_layer_stack, [&time_step](Layer* p_layer)
         {
+            VI_PROFILE_ZONE(p_layer->get_name());
             p_layer->on_update(time_step);
         });
 
@@ -67,4 +86,25 @@ void Application::push_overlay(Layer* p_layer)
     m_layer_stack.push_overlay(p_layer);
     p_layer->on_attach();
 }
+
+void Application::set_present_mode(const PresentMode p_mode)
+{
+    m_window_props.Present = p_mode;
+    if (m_window)
+    {
+        m_renderer.set_present_mode(p_mode);
+    }
+}
+
+void Application::set_headless(const uint32_t p_frame_limit)
+{
+    if (m_window)
+    {
+        VI_CORE_WARN("Headless mode has to be set before the application is initialized");
+        return;
+    }
+
+    m_window_props.Headless = true;
+    m_window_props.FrameLimit = p_frame_limit;
+}
 }
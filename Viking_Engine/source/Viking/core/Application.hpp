@@ -6,7 +6,7 @@
 #define APPLICATION_H
 
 #include "Viking/core/LayerStack.hpp"
-#include "Viking/core/Timestep.hpp"
+#include "Viking/core/TimeStep.hpp"
 #include "Viking/core/Window.hpp"
 #include "Viking/renderer/Renderer.hpp"
 
@@ -15,7 +15,7 @@
 namespace vi {
 class Application {
 public:
-    explicit Application(const std::string_view& p_name);
+    explicit Application(const std::string_view& p_name, RendererProps p_renderer_props = RendererProps());
 
     void init();
     void run();
@@ -24,12 +24,21 @@ public:
     void push_layer(Layer* p_layer);
     void push_overlay(Layer* p_layer);
 
+    //Can be called before init to pick the initial mode, or at any time afterwards to switch it
+    void set_present_mode(PresentMode p_mode);
+
+    //Has to be called before init, the same loop then renders offscreen and closes after p_frame_limit frames (0 never does).
+    //Setting the VIKING_HEADLESS environment variable to the frame limit does the same without touching the application
+    void set_headless(uint32_t p_frame_limit = 0);
+
 private:
     std::string m_application_name{};
+    WindowProps m_window_props;
     std::shared_ptr<Window> m_window;
     bool m_running{ true };
     LayerStack m_layer_stack;
     TimeStep m_last_frame_time;
+    RendererProps m_renderer_props{};
     Renderer m_renderer;
 };
 }
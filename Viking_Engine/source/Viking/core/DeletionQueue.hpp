@@ -1,5 +1,6 @@
 #ifndef DELETION_QUEUE_HPP
 #define DELETION_QUEUE_HPP
+#include <algorithm>
 #include <deque>
 #include <functional>
 
@@ -20,8 +21,13 @@ namespace vi
             std::for_each(m_deletors.rbegin(), m_deletors.rend(), [](const deletors_function& p_function) {
                 p_function();
             });
+
+            //per-frame queues are flushed every time the frame comes around again
+            m_deletors.clear();
         }
 
+        [[nodiscard]] bool empty() const { return m_deletors.empty(); }
+
     private:
         std::deque<deletors_function> m_deletors;
     };
@@ -0,0 +1,116 @@
+#include "Viking/core/MappedFile.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace vi
+{
+#ifdef _WIN32
+    bool MappedFile::open(const std::filesystem::path& p_path)
+    {
+        close();
+
+        const auto file = CreateFileW(p_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+
+        LARGE_INTEGER size{};
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+        {
+            CloseHandle(file);
+            return false;
+        }
+
+        const auto mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr)
+        {
+            CloseHandle(file);
+            return false;
+        }
+
+        const auto* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (data == nullptr)
+        {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            return false;
+        }
+
+        m_file = file;
+        m_mapping = mapping;
+        m_data = static_cast<const std::byte*>(data);
+        m_size = static_cast<size_t>(size.QuadPart);
+        return true;
+    }
+
+    void MappedFile::close()
+    {
+        if (m_data != nullptr)
+        {
+            UnmapViewOfFile(m_data);
+            CloseHandle(m_mapping);
+            CloseHandle(m_file);
+        }
+
+        m_data = nullptr;
+        m_size = 0;
+        m_file = nullptr;
+        m_mapping = nullptr;
+    }
+#else
+    bool MappedFile::open(const std::filesystem::path& p_path)
+    {
+        close();
+
+        const auto file = ::open(p_path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (file < 0)
+        {
+            return false;
+        }
+
+        struct stat status{};
+        if (fstat(file, &status) != 0 || status.st_size <= 0)
+        {
+            ::close(file);
+            return false;
+        }
+
+        const auto size = static_cast<size_t>(status.st_size);
+        auto* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+        //the mapping keeps its own reference to the file
+        ::close(file);
+        if (data == MAP_FAILED)
+        {
+            return false;
+        }
+
+        //the whole file is about to be read, start paging it in now
+        madvise(data, size, MADV_WILLNEED);
+
+        m_data = static_cast<const std::byte*>(data);
+        m_size = size;
+        return true;
+    }
+
+    void MappedFile::close()
+    {
+        if (m_data != nullptr)
+        {
+            munmap(const_cast<std::byte*>(m_data), m_size);
+        }
+
+        m_data = nullptr;
+        m_size = 0;
+    }
+#endif
+}
@@ -0,0 +1,39 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+namespace vi
+{
+    //Read-only view of a whole file mapped into memory. Pages are read in by the OS on first touch,
+    //so opening costs no copy. The file must not be truncated while it is mapped
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        ~MappedFile() { close(); }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        //Returns false when the file is missing, empty or cannot be mapped
+        bool open(const std::filesystem::path& p_path);
+        void close();
+
+        [[nodiscard]] bool is_open() const { return m_data != nullptr; }
+        [[nodiscard]] std::span<const std::byte> get_data() const { return { m_data, m_size }; }
+
+    private:
+        const std::byte* m_data{};
+        size_t m_size{};
+
+#ifdef _WIN32
+        void* m_file{};
+        void* m_mapping{};
+#endif
+    };
+}
+
+#endif
@@ -0,0 +1,47 @@
+#include "Viking/core/Paths.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+#include <string>
+#include <system_error>
+
+namespace
+{
+    std::filesystem::path find_executable_directory()
+    {
+#ifdef _WIN32
+        std::wstring path(MAX_PATH, L'\0');
+        while (true)
+        {
+            const auto length = GetModuleFileNameW(nullptr, path.data(), static_cast<DWORD>(path.size()));
+            if (length == 0)
+            {
+                return std::filesystem::current_path();
+            }
+            if (length < path.size())
+            {
+                path.resize(length);
+                return std::filesystem::path{ path }.parent_path();
+            }
+            path.resize(path.size() * 2);
+        }
+#else
+        std::error_code error;
+        const auto path = std::filesystem::read_symlink("/proc/self/exe", error);
+        return error ? std::filesystem::current_path() : path.parent_path();
+#endif
+    }
+}
+
+namespace vi
+{
+    const std::filesystem::path& get_executable_directory()
+    {
+        static const auto directory{ find_executable_directory() };
+        return directory;
+    }
+}
@@ -0,0 +1,13 @@
+#ifndef PATHS_HPP
+#define PATHS_HPP
+
+#include <filesystem>
+
+namespace vi
+{
+    //Directory holding the running executable, files shipped next to it are found whatever the working directory is.
+    //Falls back to the working directory when the platform cannot tell
+    [[nodiscard]] const std::filesystem::path& get_executable_directory();
+}
+
+#endif
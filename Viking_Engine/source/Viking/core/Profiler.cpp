@@ -0,0 +1,178 @@
+#include "Viking/core/Profiler.hpp"
+
+#include "Viking/core/Log.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <fstream>
+
+namespace
+{
+    //zone names come from code, but layer names are user strings
+    void write_escaped(std::ofstream& p_file, const std::string_view p_text)
+    {
+        for (const auto character : p_text)
+        {
+            switch (character)
+            {
+            case '"':
+                p_file << "\\\"";
+                break;
+            case '\\':
+                p_file << "\\\\";
+                break;
+            default:
+                if (static_cast<unsigned char>(character) < 0x20)
+                {
+                    p_file << std::format("\\u{:04x}", static_cast<unsigned int>(character));
+                }
+                else
+                {
+                    p_file << character;
+                }
+                break;
+            }
+        }
+    }
+}
+
+namespace vi
+{
+    void Profiler::set_thread_name(const std::string_view p_name)
+    {
+        auto& ring = get_thread_ring();
+
+        std::scoped_lock lock{ s_rings_mutex };
+        ring.m_thread_name = p_name;
+    }
+
+    void Profiler::record(const std::string_view p_name, const uint64_t p_start_ns, const uint64_t p_end_ns)
+    {
+        auto& ring = get_thread_ring();
+
+        //single producer, so a relaxed load of our own head is enough
+        const auto head = ring.m_head.load(std::memory_order_relaxed);
+        auto& slot = ring.m_zones[head % RING_CAPACITY];
+
+        Zone zone{};
+        const auto length = std::min(p_name.size(), MAX_ZONE_NAME_LENGTH);
+        std::copy_n(p_name.data(), length, zone.m_name.data());
+        zone.m_name[length] = '\0';
+
+        std::array<uint64_t, ZONE_NAME_WORDS> name_words{};
+        std::memcpy(name_words.data(), zone.m_name.data(), sizeof(name_words));
+
+        //seqlock: a reader that sees the slot change while it copies drops the copy
+        slot.m_sequence.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t word = 0; word < ZONE_NAME_WORDS; ++word)
+        {
+            slot.m_name[word].store(name_words[word], std::memory_order_relaxed);
+        }
+        slot.m_start_ns.store(p_start_ns, std::memory_order_relaxed);
+        slot.m_duration_ns.store(p_end_ns - p_start_ns, std::memory_order_relaxed);
+        slot.m_sequence.store(head + 1, std::memory_order_release);
+
+        //publishes the zone to write_trace
+        ring.m_head.store(head + 1, std::memory_order_release);
+    }
+
+    uint64_t Profiler::now()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - s_epoch).count());
+    }
+
+    void Profiler::write_trace(const std::filesystem::path& p_path)
+    {
+        std::ofstream file(p_path, std::ios::trunc);
+        if (!file.is_open())
+        {
+            VI_CORE_ERROR("Cannot open {} to write the trace", p_path.string());
+            return;
+        }
+
+        std::scoped_lock lock{ s_rings_mutex };
+
+        file << R"({"displayTimeUnit":"ms","traceEvents":[)";
+        bool first{ true };
+        size_t zone_count{};
+
+        for (const auto& ring : s_rings)
+        {
+            if (!first)
+            {
+                file << ',';
+            }
+            first = false;
+
+            file << std::format(R"({{"name":"thread_name","ph":"M","pid":0,"tid":{},"args":{{"name":")", ring->m_thread_id);
+            write_escaped(file, ring->m_thread_name);
+            file << "\"}}";
+
+            //the owner keeps writing while we copy, so the ring is snapshot first
+            const auto head = ring->m_head.load(std::memory_order_acquire);
+            const auto begin = head > RING_CAPACITY ? head - RING_CAPACITY : 0;
+
+            std::vector<Zone> zones;
+            zones.reserve(head - begin);
+            for (auto index = begin; index < head; ++index)
+            {
+                //zones overwritten before or during the copy are dropped, they may be torn
+                const auto& slot = ring->m_zones[index % RING_CAPACITY];
+                if (slot.m_sequence.load(std::memory_order_acquire) != index + 1)
+                {
+                    continue;
+                }
+
+                std::array<uint64_t, ZONE_NAME_WORDS> name_words{};
+                for (size_t word = 0; word < ZONE_NAME_WORDS; ++word)
+                {
+                    name_words[word] = slot.m_name[word].load(std::memory_order_relaxed);
+                }
+                Zone zone{};
+                zone.m_start_ns = slot.m_start_ns.load(std::memory_order_relaxed);
+                zone.m_duration_ns = slot.m_duration_ns.load(std::memory_order_relaxed);
+
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.m_sequence.load(std::memory_order_relaxed) != index + 1)
+                {
+                    continue;
+                }
+
+                std::memcpy(zone.m_name.data(), name_words.data(), sizeof(name_words));
+                zones.push_back(zone);
+            }
+
+            for (const auto& zone : zones)
+            {
+                file << R"(,{"name":")";
+                write_escaped(file, zone.m_name.data());
+                //chrome traces are in microseconds
+                file << std::format(R"(","cat":"cpu","ph":"X","pid":0,"tid":{},"ts":{:.3f},"dur":{:.3f}}})", ring->m_thread_id,
+                    static_cast<double>(zone.m_start_ns) / 1000.0, static_cast<double>(zone.m_duration_ns) / 1000.0);
+            }
+
+            zone_count += zones.size();
+        }
+
+        file << "]}\n";
+        VI_CORE_INFO("Wrote {} profiler zones to {}", zone_count, p_path.string());
+    }
+
+    Profiler::ThreadRing& Profiler::get_thread_ring()
+    {
+        //rings live until exit, so a trace can still show threads that have finished
+        thread_local ThreadRing* ring{ nullptr };
+        if (ring == nullptr)
+        {
+            std::scoped_lock lock{ s_rings_mutex };
+            auto& created = s_rings.emplace_back(std::make_unique<ThreadRing>());
+            created->m_thread_id = static_cast<uint32_t>(s_rings.size());
+            created->m_thread_name = std::format("Thread {}", created->m_thread_id);
+            ring = created.get();
+        }
+
+        return *ring;
+    }
+}
@@ -0,0 +1,98 @@
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace vi
+{
+    //CPU instrumentation. Every thread records its zones into its own ring buffer without locking,
+    //only the oldest zones are lost when a ring wraps. write_trace dumps all rings as a Chrome/Perfetto JSON trace
+    class Profiler
+    {
+    public:
+        static constexpr size_t MAX_ZONE_NAME_LENGTH{ 47 };
+
+        struct Zone
+        {
+            std::array<char, MAX_ZONE_NAME_LENGTH + 1> m_name{};
+            uint64_t m_start_ns{};
+            uint64_t m_duration_ns{};
+        };
+
+        static void set_thread_name(std::string_view p_name);
+        static void record(std::string_view p_name, uint64_t p_start_ns, uint64_t p_end_ns);
+
+        //Nanoseconds since the profiler started
+        [[nodiscard]] static uint64_t now();
+
+        //Can be called from any thread while the others keep recording
+        static void write_trace(const std::filesystem::path& p_path);
+
+    private:
+        static constexpr size_t RING_CAPACITY{ 1 << 15 };
+        static constexpr size_t ZONE_NAME_WORDS{ sizeof(Zone::m_name) / sizeof(uint64_t) };
+
+        //A zone stored as atomics, so write_trace can copy it while the owner overwrites it
+        struct ZoneSlot
+        {
+            //zone index + 1 once the slot holds that zone, 0 while the owner writes it
+            std::atomic<uint64_t> m_sequence{ 0 };
+            std::array<std::atomic<uint64_t>, ZONE_NAME_WORDS> m_name{};
+            std::atomic<uint64_t> m_start_ns{};
+            std::atomic<uint64_t> m_duration_ns{};
+        };
+
+        struct ThreadRing
+        {
+            uint32_t m_thread_id{};
+            std::string m_thread_name{};
+            std::array<ZoneSlot, RING_CAPACITY> m_zones{};
+            //total number of zones written, only the owning thread stores it
+            std::atomic<uint64_t> m_head{ 0 };
+        };
+
+        static ThreadRing& get_thread_ring();
+
+        inline static const auto s_epoch{ std::chrono::steady_clock::now() };
+
+        //only taken when a thread records its first zone, when it is named, and while writing a trace
+        inline static std::mutex s_rings_mutex{};
+        inline static std::vector<std::unique_ptr<ThreadRing>> s_rings{};
+    };
+
+    class ProfileZone
+    {
+    public:
+        explicit ProfileZone(const std::string_view p_name): m_name{ p_name }, m_start_ns{ Profiler::now() } {}
+        ~ProfileZone() { Profiler::record(m_name, m_start_ns, Profiler::now()); }
+
+        ProfileZone(const ProfileZone&) = delete;
+        ProfileZone& operator=(const ProfileZone&) = delete;
+
+    private:
+        std::string_view m_name{};
+        uint64_t m_start_ns{};
+    };
+}
+
+#define VI_PROFILE_CONCAT_IMPL(a, b) a##b
+#define VI_PROFILE_CONCAT(a, b) VI_PROFILE_CONCAT_IMPL(a, b)
+
+#ifdef VI_PROFILING_ENABLED
+    #define VI_PROFILE_ZONE(name) ::vi::ProfileZone VI_PROFILE_CONCAT(vi_profile_zone_, __LINE__){ name }
+    #define VI_PROFILE_FUNCTION() VI_PROFILE_ZONE(__func__)
+#else
+    #define VI_PROFILE_ZONE(name)
+    #define VI_PROFILE_FUNCTION()
+#endif
+
+#endif // PROFILER_HPP
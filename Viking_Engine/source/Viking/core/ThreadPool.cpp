@@ -0,0 +1,82 @@
+#include "Viking/core/ThreadPool.hpp"
+
+#include "Viking/core/Log.hpp"
+#include "Viking/core/Profiler.hpp"
+
+#include <algorithm>
+#include <format>
+
+namespace vi
+{
+    void ThreadPool::init(const std::string_view p_name, const uint32_t p_thread_count)
+    {
+        auto thread_count = p_thread_count;
+        if (thread_count == 0)
+        {
+            thread_count = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+        }
+
+        m_threads.reserve(thread_count);
+        for (uint32_t index = 0; index < thread_count; ++index)
+        {
+            m_threads.emplace_back([this, index, name = std::format("{} {}", p_name, index)](const std::stop_token& p_stop)
+            {
+                worker_loop(p_stop, index, name);
+            });
+        }
+
+        VI_CORE_INFO("{} started with {} threads", p_name, thread_count);
+    }
+
+    void ThreadPool::shutdown()
+    {
+        for (auto& thread : m_threads)
+        {
+            thread.request_stop();
+        }
+        m_condition.notify_all();
+
+        //jthread joins on destruction
+        m_threads.clear();
+    }
+
+    std::future<void> ThreadPool::submit(std::function<void()> p_job)
+    {
+        std::packaged_task<void()> task{ std::move(p_job) };
+        auto future = task.get_future();
+
+        {
+            std::scoped_lock lock{ m_mutex };
+            m_jobs.push_back(std::move(task));
+        }
+        m_condition.notify_one();
+
+        return future;
+    }
+
+    void ThreadPool::worker_loop(const std::stop_token& p_stop, const uint32_t p_index, const std::string& p_name)
+    {
+        t_worker_pool = this;
+        t_worker_index = p_index;
+        Profiler::set_thread_name(p_name);
+
+        while (true)
+        {
+            std::packaged_task<void()> task;
+            {
+                std::unique_lock lock{ m_mutex };
+                //queued jobs are still run after a stop is requested, nobody is left waiting on a broken promise
+                m_condition.wait(lock, p_stop, [this]() { return !m_jobs.empty(); });
+                if (m_jobs.empty())
+                {
+                    return;
+                }
+
+                task = std::move(m_jobs.front());
+                m_jobs.pop_front();
+            }
+
+            task();
+        }
+    }
+}
@@ -0,0 +1,56 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace vi
+{
+    class ThreadPool
+    {
+    public:
+        static constexpr uint32_t INVALID_WORKER{ std::numeric_limits<uint32_t>::max() };
+
+        ThreadPool() = default;
+        ~ThreadPool() { shutdown(); }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        //0 threads uses every hardware thread but the calling one
+        void init(std::string_view p_name, uint32_t p_thread_count = 0);
+        //Finishes the queued jobs and joins the workers
+        void shutdown();
+
+        //The future rethrows anything the job threw
+        std::future<void> submit(std::function<void()> p_job);
+
+        [[nodiscard]] uint32_t get_thread_count() const { return static_cast<uint32_t>(m_threads.size()); }
+
+        //Index of the calling worker in this pool, INVALID_WORKER on threads that are not workers of this pool
+        [[nodiscard]] uint32_t get_worker_index() const { return t_worker_pool == this ? t_worker_index : INVALID_WORKER; }
+
+    private:
+        void worker_loop(const std::stop_token& p_stop, uint32_t p_index, const std::string& p_name);
+
+        std::mutex m_mutex{};
+        std::condition_variable_any m_condition{};
+        std::deque<std::packaged_task<void()>> m_jobs{};
+        std::vector<std::jthread> m_threads{};
+
+        //a worker of one pool can run code that asks another pool for its index
+        inline static thread_local const ThreadPool* t_worker_pool{ nullptr };
+        inline static thread_local uint32_t t_worker_index{ INVALID_WORKER };
+    };
+}
+
+#endif // THREAD_POOL_HPP
@@ -3,10 +3,15 @@
 //
 
 #include "Viking/core/Window.hpp"
+#include "Platform/Headless/Window.hpp"
 #include "Platform/Windows/Window.hpp"
 
 namespace vi {
     std::shared_ptr<Window> Window::create(const WindowProps &p_props) {
+        if (p_props.Headless) {
+            return std::make_shared<headless::Window>(p_props);
+        }
+
         return std::make_shared<windows::Window>(p_props);
     }
 
@@ -5,18 +5,33 @@
 #ifndef WINDOW_HPP
 #define WINDOW_HPP
 
+#include <cstdint>
 #include <memory>
 #include <string>
 
 namespace vi
 {
+    //Presentation policy, the renderer falls back to the closest mode the surface supports
+    enum class PresentMode
+    {
+        Fifo,           //vsync, never tears, always supported
+        FifoRelaxed,    //vsync, tears instead of stuttering when a frame is late
+        Mailbox,        //low latency, newest frame replaces the queued one without tearing
+        Immediate       //uncapped, may tear
+    };
+
     struct WindowProps {
     std::string Title{};
     std::pair<int32_t, int32_t> Size{};
+    PresentMode Present{ PresentMode::Fifo };
+    //Renders offscreen without a surface or swapchain, for CI and benchmarks on machines without a display or GPU
+    bool Headless{ false };
+    //Headless only, the window asks to close after this many frames, 0 runs until closed otherwise
+    uint32_t FrameLimit{ 0 };
 
-    explicit WindowProps(std::string p_title = "Viking Engine", const std::pair<int32_t, int32_t> p_size = {800, 600}): Title{
+    explicit WindowProps(std::string p_title = "Viking Engine", const std::pair<int32_t, int32_t> p_size = {800, 600}, const PresentMode p_present = PresentMode::Fifo): Title{
         std::move(p_title)
-    }, Size{p_size} {}
+    }, Size{p_size}, Present{p_present} {}
 };
 
 class Window {
@@ -27,6 +42,7 @@ public:
     virtual void on_swap() = 0;
 
     [[nodiscard]] virtual std::pair<int32_t, int32_t> get_size() const = 0;
+    [[nodiscard]] virtual PresentMode get_present_mode() const = 0;
 
     [[nodiscard]] virtual float get_time() const = 0;
 
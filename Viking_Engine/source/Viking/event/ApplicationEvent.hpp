@@ -3,6 +3,8 @@
 
 #include "Viking/event/Event.hpp"
 
+#include <cstdint>
+
 namespace vi
 {
     class WindowCloseEvent : public Event
@@ -14,6 +16,23 @@ namespace vi
         }
         ~WindowCloseEvent() override = default;
     };
+
+    class WindowResizeEvent : public Event
+    {
+    public:
+        WindowResizeEvent(const uint32_t p_width, const uint32_t p_height) : Event(EventType::WindowResize), m_width{ p_width }, m_height{ p_height }
+        {
+
+        }
+        ~WindowResizeEvent() override = default;
+
+        [[nodiscard]] uint32_t get_width() const { return m_width; }
+        [[nodiscard]] uint32_t get_height() const { return m_height; }
+
+    private:
+        uint32_t m_width{};
+        uint32_t m_height{};
+    };
 }
 
 #endif // !APPLICATION_EVENT_HPP
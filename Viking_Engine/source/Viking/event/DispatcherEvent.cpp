@@ -1,5 +1,7 @@
 #include "DispatcherEvent.hpp"
 
+#include "Viking/core/Profiler.hpp"
+
 namespace vi
 {
     void EventDispatcher::add_listener(const EventType p_type, const std::function<void(const EventPointer&)>& p_callback)
@@ -19,6 +21,7 @@ namespace vi
 
     void EventDispatcher::dispatch()
     {
+        VI_PROFILE_FUNCTION();
         m_event_queue.process();
     }
 }
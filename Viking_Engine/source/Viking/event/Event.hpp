@@ -6,7 +6,8 @@ namespace vi
     enum class EventType
     {
         None = 0,
-        WindowClose
+        WindowClose,
+        WindowResize
     };
 
     class Event
@@ -0,0 +1,144 @@
+#include "Viking/renderer/ImageFile.hpp"
+
+#include <algorithm>
+#include <array>
+#include <format>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    constexpr uint32_t PNG_MAX_STORED_BLOCK{ 65535 };
+
+    constexpr std::array<uint32_t, 256> make_crc_table()
+    {
+        std::array<uint32_t, 256> table{};
+        for (uint32_t n = 0; n < table.size(); ++n)
+        {
+            auto c = n;
+            for (auto k = 0; k < 8; ++k)
+            {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            table[n] = c;
+        }
+        return table;
+    }
+
+    constexpr auto CRC_TABLE{ make_crc_table() };
+
+    uint32_t update_crc(uint32_t p_crc, const std::span<const uint8_t> p_data)
+    {
+        for (const auto byte : p_data)
+        {
+            p_crc = CRC_TABLE[(p_crc ^ byte) & 0xFF] ^ (p_crc >> 8);
+        }
+        return p_crc;
+    }
+
+    void append_u32(std::vector<uint8_t>& p_out, const uint32_t p_value)
+    {
+        p_out.push_back(static_cast<uint8_t>(p_value >> 24));
+        p_out.push_back(static_cast<uint8_t>(p_value >> 16));
+        p_out.push_back(static_cast<uint8_t>(p_value >> 8));
+        p_out.push_back(static_cast<uint8_t>(p_value));
+    }
+
+    //length, type, data and a crc over type and data
+    void append_chunk(std::vector<uint8_t>& p_out, const std::string_view p_type, const std::span<const uint8_t> p_data)
+    {
+        append_u32(p_out, static_cast<uint32_t>(p_data.size()));
+        const auto type_begin = p_out.size();
+        p_out.insert(p_out.end(), p_type.begin(), p_type.end());
+        p_out.insert(p_out.end(), p_data.begin(), p_data.end());
+
+        const auto crc = update_crc(0xFFFFFFFFu, std::span{ p_out }.subspan(type_begin)) ^ 0xFFFFFFFFu;
+        append_u32(p_out, crc);
+    }
+
+    std::vector<uint8_t> encode_png(const vi::ImageData& p_image)
+    {
+        //every scanline starts with filter type 0, the pixels follow unchanged
+        const auto row_size = static_cast<size_t>(p_image.Width) * 4;
+        std::vector<uint8_t> scanlines{};
+        scanlines.reserve((row_size + 1) * p_image.Height);
+        for (uint32_t y = 0; y < p_image.Height; ++y)
+        {
+            scanlines.push_back(0);
+            const auto row = p_image.Pixels.begin() + static_cast<std::ptrdiff_t>(row_size * y);
+            scanlines.insert(scanlines.end(), row, row + static_cast<std::ptrdiff_t>(row_size));
+        }
+
+        //zlib stream made of stored deflate blocks, followed by the adler32 of the raw data
+        std::vector<uint8_t> zlib{ 0x78, 0x01 };
+        zlib.reserve(scanlines.size() + scanlines.size() / PNG_MAX_STORED_BLOCK * 5 + 11);
+        size_t offset{};
+        do
+        {
+            const auto size = static_cast<uint16_t>(std::min<size_t>(scanlines.size() - offset, PNG_MAX_STORED_BLOCK));
+            const auto inverse_size = static_cast<uint16_t>(~size);
+            const auto last = offset + size == scanlines.size();
+            zlib.push_back(last ? 1 : 0);
+            zlib.push_back(static_cast<uint8_t>(size));
+            zlib.push_back(static_cast<uint8_t>(size >> 8));
+            zlib.push_back(static_cast<uint8_t>(inverse_size));
+            zlib.push_back(static_cast<uint8_t>(inverse_size >> 8));
+            zlib.insert(zlib.end(), scanlines.begin() + static_cast<std::ptrdiff_t>(offset), scanlines.begin() + static_cast<std::ptrdiff_t>(offset + size));
+            offset += size;
+        } while (offset < scanlines.size());
+
+        uint32_t a{ 1 };
+        uint32_t b{ 0 };
+        for (const auto byte : scanlines)
+        {
+            a = (a + byte) % 65521;
+            b = (b + a) % 65521;
+        }
+        append_u32(zlib, (b << 16) | a);
+
+        std::vector<uint8_t> header{};
+        append_u32(header, p_image.Width);
+        append_u32(header, p_image.Height);
+        //8 bit RGBA, deflate, adaptive filtering, no interlacing
+        header.insert(header.end(), { 8, 6, 0, 0, 0 });
+
+        std::vector<uint8_t> png{ 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+        append_chunk(png, "IHDR", header);
+        append_chunk(png, "IDAT", zlib);
+        append_chunk(png, "IEND", {});
+        return png;
+    }
+
+    std::vector<uint8_t> encode_ppm(const vi::ImageData& p_image)
+    {
+        const auto header = std::format("P6\n{} {}\n255\n", p_image.Width, p_image.Height);
+        std::vector<uint8_t> ppm{ header.begin(), header.end() };
+        ppm.reserve(ppm.size() + static_cast<size_t>(p_image.Width) * p_image.Height * 3);
+        for (size_t i = 0; i < p_image.Pixels.size(); i += 4)
+        {
+            ppm.insert(ppm.end(), p_image.Pixels.begin() + static_cast<std::ptrdiff_t>(i), p_image.Pixels.begin() + static_cast<std::ptrdiff_t>(i + 3));
+        }
+        return ppm;
+    }
+}
+
+namespace vi
+{
+    void write_image(const std::filesystem::path& p_path, const ImageData& p_image)
+    {
+        if (p_image.Pixels.size() != static_cast<size_t>(p_image.Width) * p_image.Height * 4)
+        {
+            throw std::runtime_error(std::format("Image of {}x{} has {} bytes of pixels", p_image.Width, p_image.Height, p_image.Pixels.size()));
+        }
+
+        const auto bytes = p_path.extension() == ".png" ? encode_png(p_image) : encode_ppm(p_image);
+
+        std::ofstream file{ p_path, std::ios::binary };
+        if (!file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size())))
+        {
+            throw std::runtime_error(std::format("Cannot write image {}", p_path.string()));
+        }
+    }
+}
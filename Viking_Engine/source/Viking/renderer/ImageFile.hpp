@@ -0,0 +1,22 @@
+#ifndef IMAGE_FILE_HPP
+#define IMAGE_FILE_HPP
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace vi
+{
+    //Tightly packed 8 bit RGBA pixels, rows from top to bottom
+    struct ImageData {
+        uint32_t Width{};
+        uint32_t Height{};
+        std::vector<uint8_t> Pixels{};
+    };
+
+    //Writes a PNG for the .png extension and a binary PPM, which drops the alpha channel, for anything else.
+    //The PNG is stored without compression, it is meant for dumps and comparisons rather than for size
+    void write_image(const std::filesystem::path& p_path, const ImageData& p_image);
+}
+
+#endif
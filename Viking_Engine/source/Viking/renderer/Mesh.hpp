@@ -0,0 +1,41 @@
+#ifndef MESH_HPP
+#define MESH_HPP
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <limits>
+
+namespace vi
+{
+    //Layout shared with the shaders, the uvs fill the padding std430 puts after each vec3
+    struct Vertex {
+        glm::vec3 Position{};
+        float UvX{};
+        glm::vec3 Normal{};
+        float UvY{};
+        glm::vec4 Color{ 1.0f };
+    };
+
+    static_assert(sizeof(Vertex) == 48, "Vertex has to match the std430 layout of the shaders");
+
+    //Most levels of detail a mesh can be drawn with, LOD 0 included
+    inline constexpr uint32_t MAX_MESH_LODS{ 4 };
+
+    //Index range of one level of detail, every level indexes the same vertices.
+    //Error is how far, in mesh units, the simplified surface may be from the full one
+    struct MeshLod {
+        uint32_t FirstIndex{};
+        uint32_t IndexCount{};
+        float Error{};
+    };
+
+    //Mesh living in the renderer's geometry buffer
+    struct MeshHandle {
+        uint32_t Id{ std::numeric_limits<uint32_t>::max() };
+
+        [[nodiscard]] bool is_valid() const { return Id != std::numeric_limits<uint32_t>::max(); }
+    };
+}
+
+#endif
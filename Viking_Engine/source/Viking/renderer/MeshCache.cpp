@@ -0,0 +1,298 @@
+#include "Viking/renderer/MeshCache.hpp"
+
+#include "Viking/core/Log.hpp"
+#include "Viking/core/Profiler.hpp"
+#include "Viking/renderer/MeshImporter.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+
+namespace
+{
+    constexpr uint32_t MESH_CACHE_MAGIC{ 0x434D4956 }; // "VIMC"
+    constexpr uint32_t MESH_CACHE_VERSION{ 3 };
+    //enough for any SIMD load and a cache line, the mapping itself starts on a page
+    constexpr uint64_t BLOB_ALIGNMENT{ 64 };
+
+    struct FileHeader
+    {
+        uint32_t m_magic{};
+        uint32_t m_version{};
+        uint32_t m_vertex_size{};
+        uint32_t m_submesh_count{};
+        uint64_t m_source_size{};
+        int64_t m_source_time{};
+        uint64_t m_lods_offset{};
+        uint64_t m_lod_count{};
+        uint64_t m_names_offset{};
+        uint64_t m_names_size{};
+        uint64_t m_vertices_offset{};
+        uint64_t m_vertex_count{};
+        uint64_t m_indices_offset{};
+        uint64_t m_index_count{};
+        uint64_t m_file_size{};
+    };
+
+    //Follows the header, offsets are counted in elements from the start of the blobs
+    struct SubMeshEntry
+    {
+        uint32_t m_name_offset{};
+        uint32_t m_name_size{};
+        uint64_t m_first_vertex{};
+        uint64_t m_vertex_count{};
+        uint64_t m_first_index{};
+        uint64_t m_index_count{};
+        //first index of every level is relative to the submesh's indices
+        uint32_t m_first_lod{};
+        uint32_t m_lod_count{};
+    };
+
+    static_assert(sizeof(vi::MeshLod) == 12, "MeshLod is stored as it is in memory");
+
+    struct SourceStamp
+    {
+        uint64_t m_size{};
+        int64_t m_time{};
+    };
+
+    uint64_t align_up(const uint64_t p_value)
+    {
+        return (p_value + BLOB_ALIGNMENT - 1) & ~(BLOB_ALIGNMENT - 1);
+    }
+
+    //false when there is no source to compare against
+    bool get_source_stamp(const std::filesystem::path& p_source, SourceStamp& p_stamp)
+    {
+        std::error_code error;
+        const auto size = std::filesystem::file_size(p_source, error);
+        if (error)
+        {
+            return false;
+        }
+        const auto time = std::filesystem::last_write_time(p_source, error);
+        if (error)
+        {
+            return false;
+        }
+
+        p_stamp.m_size = size;
+        p_stamp.m_time = static_cast<int64_t>(time.time_since_epoch().count());
+        return true;
+    }
+
+    //p_count elements of p_element_size starting at p_offset fit in p_size bytes
+    bool fits(const uint64_t p_offset, const uint64_t p_count, const uint64_t p_element_size, const uint64_t p_size)
+    {
+        return p_offset <= p_size && p_count <= (p_size - p_offset) / p_element_size;
+    }
+
+    void write_padding(std::ofstream& p_file, const uint64_t p_offset)
+    {
+        constexpr std::array<char, BLOB_ALIGNMENT> zeros{};
+        const auto position = static_cast<uint64_t>(p_file.tellp());
+        p_file.write(zeros.data(), static_cast<std::streamsize>(p_offset - position));
+    }
+}
+
+namespace vi
+{
+    std::filesystem::path MeshCache::get_cache_path(const std::filesystem::path& p_source)
+    {
+        auto path = p_source;
+        path += ".vimesh";
+        return path;
+    }
+
+    void MeshCache::write(const std::filesystem::path& p_path, const std::span<const MeshData> p_meshes, const std::filesystem::path& p_source)
+    {
+        VI_PROFILE_FUNCTION();
+
+        FileHeader header{};
+        header.m_magic = MESH_CACHE_MAGIC;
+        header.m_version = MESH_CACHE_VERSION;
+        header.m_vertex_size = sizeof(Vertex);
+        header.m_submesh_count = static_cast<uint32_t>(p_meshes.size());
+
+        SourceStamp stamp{};
+        if (get_source_stamp(p_source, stamp))
+        {
+            header.m_source_size = stamp.m_size;
+            header.m_source_time = stamp.m_time;
+        }
+
+        std::vector<SubMeshEntry> entries;
+        entries.reserve(p_meshes.size());
+        for (const auto& mesh : p_meshes)
+        {
+            SubMeshEntry entry{};
+            entry.m_name_offset = static_cast<uint32_t>(header.m_names_size);
+            entry.m_name_size = static_cast<uint32_t>(mesh.Name.size());
+            entry.m_first_vertex = header.m_vertex_count;
+            entry.m_vertex_count = mesh.Vertices.size();
+            entry.m_first_index = header.m_index_count;
+            entry.m_index_count = mesh.Indices.size();
+            entry.m_first_lod = static_cast<uint32_t>(header.m_lod_count);
+            entry.m_lod_count = static_cast<uint32_t>(mesh.Lods.size());
+            entries.push_back(entry);
+
+            header.m_names_size += mesh.Name.size();
+            header.m_lod_count += mesh.Lods.size();
+            header.m_vertex_count += mesh.Vertices.size();
+            header.m_index_count += mesh.Indices.size();
+        }
+
+        header.m_lods_offset = sizeof(FileHeader) + entries.size() * sizeof(SubMeshEntry);
+        header.m_names_offset = header.m_lods_offset + header.m_lod_count * sizeof(MeshLod);
+        header.m_vertices_offset = align_up(header.m_names_offset + header.m_names_size);
+        header.m_indices_offset = align_up(header.m_vertices_offset + header.m_vertex_count * sizeof(Vertex));
+        header.m_file_size = header.m_indices_offset + header.m_index_count * sizeof(uint32_t);
+
+        //write next to the destination and rename over it, so readers never see a partial file
+        auto temporary_path = p_path;
+        temporary_path += ".tmp";
+
+        {
+            std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+            if (!file.is_open())
+            {
+                throw std::runtime_error(std::format("Cannot open {}", temporary_path.string()));
+            }
+
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(SubMeshEntry)));
+            for (const auto& mesh : p_meshes)
+            {
+                file.write(reinterpret_cast<const char*>(mesh.Lods.data()), static_cast<std::streamsize>(mesh.Lods.size() * sizeof(MeshLod)));
+            }
+            for (const auto& mesh : p_meshes)
+            {
+                file.write(mesh.Name.data(), static_cast<std::streamsize>(mesh.Name.size()));
+            }
+
+            write_padding(file, header.m_vertices_offset);
+            for (const auto& mesh : p_meshes)
+            {
+                file.write(reinterpret_cast<const char*>(mesh.Vertices.data()), static_cast<std::streamsize>(mesh.Vertices.size() * sizeof(Vertex)));
+            }
+
+            write_padding(file, header.m_indices_offset);
+            for (const auto& mesh : p_meshes)
+            {
+                file.write(reinterpret_cast<const char*>(mesh.Indices.data()), static_cast<std::streamsize>(mesh.Indices.size() * sizeof(uint32_t)));
+            }
+
+            file.flush();
+            if (!file)
+            {
+                throw std::runtime_error(std::format("Cannot write {}", temporary_path.string()));
+            }
+        }
+
+        std::filesystem::rename(temporary_path, p_path);
+        VI_CORE_INFO("Wrote mesh cache {} ({} bytes)", p_path.string(), header.m_file_size);
+    }
+
+    bool MeshCache::open(const std::filesystem::path& p_path, const std::filesystem::path& p_source)
+    {
+        VI_PROFILE_FUNCTION();
+
+        close();
+
+        if (!m_file.open(p_path))
+        {
+            return false;
+        }
+
+        const auto data = m_file.get_data();
+        FileHeader header{};
+        if (data.size() < sizeof(header))
+        {
+            VI_CORE_WARN("Mesh cache {} is truncated, ignoring it", p_path.string());
+            close();
+            return false;
+        }
+        std::memcpy(&header, data.data(), sizeof(header));
+
+        if (header.m_magic != MESH_CACHE_MAGIC || header.m_version != MESH_CACHE_VERSION || header.m_vertex_size != sizeof(Vertex))
+        {
+            VI_CORE_INFO("Mesh cache {} was written by another version, ignoring it", p_path.string());
+            close();
+            return false;
+        }
+
+        //a cache shipped without its source is used as it is
+        if (SourceStamp stamp{}; get_source_stamp(p_source, stamp) && (stamp.m_size != header.m_source_size || stamp.m_time != header.m_source_time))
+        {
+            VI_CORE_INFO("Mesh cache {} is older than {}, ignoring it", p_path.string(), p_source.string());
+            close();
+            return false;
+        }
+
+        //every offset and count is checked against the mapping before anything points into it
+        const auto size = static_cast<uint64_t>(data.size());
+        if (header.m_file_size != size
+            || !fits(sizeof(FileHeader), header.m_submesh_count, sizeof(SubMeshEntry), size)
+            || !fits(header.m_lods_offset, header.m_lod_count, sizeof(MeshLod), size)
+            || !fits(header.m_names_offset, header.m_names_size, 1, size)
+            || !fits(header.m_vertices_offset, header.m_vertex_count, sizeof(Vertex), size)
+            || !fits(header.m_indices_offset, header.m_index_count, sizeof(uint32_t), size)
+            || header.m_lods_offset % alignof(MeshLod) != 0
+            || header.m_vertices_offset % BLOB_ALIGNMENT != 0 || header.m_indices_offset % BLOB_ALIGNMENT != 0)
+        {
+            VI_CORE_WARN("Mesh cache {} is corrupted, ignoring it", p_path.string());
+            close();
+            return false;
+        }
+
+        const auto* lods = reinterpret_cast<const MeshLod*>(data.data() + header.m_lods_offset);
+        const auto* names = reinterpret_cast<const char*>(data.data() + header.m_names_offset);
+        const auto* vertices = reinterpret_cast<const Vertex*>(data.data() + header.m_vertices_offset);
+        const auto* indices = reinterpret_cast<const uint32_t*>(data.data() + header.m_indices_offset);
+
+        m_submeshes.reserve(header.m_submesh_count);
+        for (uint32_t index = 0; index < header.m_submesh_count; ++index)
+        {
+            SubMeshEntry entry{};
+            std::memcpy(&entry, data.data() + sizeof(FileHeader) + index * sizeof(SubMeshEntry), sizeof(entry));
+
+            if (!fits(entry.m_name_offset, entry.m_name_size, 1, header.m_names_size)
+                || !fits(entry.m_first_vertex, entry.m_vertex_count, 1, header.m_vertex_count)
+                || !fits(entry.m_first_index, entry.m_index_count, 1, header.m_index_count)
+                || !fits(entry.m_first_lod, entry.m_lod_count, 1, header.m_lod_count)
+                || std::ranges::any_of(std::span{ lods + entry.m_first_lod, entry.m_lod_count }, [&entry](const MeshLod& p_lod)
+                {
+                    return !fits(p_lod.FirstIndex, p_lod.IndexCount, 1, entry.m_index_count);
+                })
+                //an index past the submesh's vertices would make the GPU read another mesh or past the pool
+                || std::ranges::any_of(std::span{ indices + entry.m_first_index, entry.m_index_count }, [&entry](const uint32_t p_index)
+                {
+                    return p_index >= entry.m_vertex_count;
+                }))
+            {
+                VI_CORE_WARN("Mesh cache {} is corrupted, ignoring it", p_path.string());
+                close();
+                return false;
+            }
+
+            SubMesh submesh{};
+            submesh.Name = { names + entry.m_name_offset, entry.m_name_size };
+            submesh.Vertices = { vertices + entry.m_first_vertex, entry.m_vertex_count };
+            submesh.Indices = { indices + entry.m_first_index, entry.m_index_count };
+            submesh.Lods = { lods + entry.m_first_lod, entry.m_lod_count };
+            m_submeshes.push_back(submesh);
+        }
+
+        VI_CORE_INFO("Mapped mesh cache {}: {} meshes, {} vertices, {} indices", p_path.string(), m_submeshes.size(), header.m_vertex_count, header.m_index_count);
+        return true;
+    }
+
+    void MeshCache::close()
+    {
+        m_submeshes.clear();
+        m_file.close();
+    }
+}
@@ -0,0 +1,57 @@
+#ifndef MESH_CACHE_HPP
+#define MESH_CACHE_HPP
+
+#include "Viking/core/MappedFile.hpp"
+#include "Viking/renderer/Mesh.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace vi
+{
+    struct MeshData;
+
+    //One mesh of a cache file, the spans point into the mapping and stay valid while the cache is open
+    struct SubMesh {
+        std::string_view Name{};
+        std::span<const Vertex> Vertices{};
+        std::span<const uint32_t> Indices{};
+        //LOD 0 first, ranges of Indices. Empty when Indices is a single level
+        std::span<const MeshLod> Lods{};
+    };
+
+    //Imported meshes stored in a binary file that is memory mapped instead of parsed.
+    //The file holds a header, the submesh and LOD tables, the names and then the vertex and index blobs, each 64 byte aligned,
+    //so the data can be handed to Renderer::upload_mesh straight from the mapping.
+    //It records the size and write time of the source it was made from and is ignored once the source changes
+    class MeshCache
+    {
+    public:
+        MeshCache() = default;
+
+        MeshCache(const MeshCache&) = delete;
+        MeshCache& operator=(const MeshCache&) = delete;
+
+        //Cache file used for p_source, written next to it
+        [[nodiscard]] static std::filesystem::path get_cache_path(const std::filesystem::path& p_source);
+
+        //The file is replaced atomically, readers never see a partial cache
+        static void write(const std::filesystem::path& p_path, std::span<const MeshData> p_meshes, const std::filesystem::path& p_source);
+
+        //Returns false when the file is missing, corrupted, from another format version or out of date with p_source
+        bool open(const std::filesystem::path& p_path, const std::filesystem::path& p_source);
+        void close();
+
+        [[nodiscard]] bool is_open() const { return m_file.is_open(); }
+        [[nodiscard]] const std::vector<SubMesh>& get_submeshes() const { return m_submeshes; }
+
+    private:
+        MappedFile m_file{};
+        std::vector<SubMesh> m_submeshes{};
+    };
+}
+
+#endif
@@ -0,0 +1,390 @@
+#include "Viking/renderer/MeshImporter.hpp"
+
+#include "Viking/core/Log.hpp"
+#include "Viking/core/Profiler.hpp"
+#include "Viking/renderer/MeshCache.hpp"
+#include "Viking/renderer/MeshOptimizer.hpp"
+
+#define TINYOBJLOADER_IMPLEMENTATION
+#include <tiny_obj_loader.h>
+
+#include <atomic>
+#include <exception>
+#include <format>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace
+{
+    //each level aims for half the triangles of the one before
+    constexpr float LOD_REDUCTION{ 0.5f };
+    //a level saving less than this fraction of the one before is not worth its indices
+    constexpr float LOD_MIN_SAVING{ 0.2f };
+    //largest error a level may have, relative to the radius of the mesh
+    constexpr float LOD_MAX_ERROR{ 0.1f };
+
+    //OBJ faces index positions, normals and uvs separately, a vertex is one combination of the three
+    struct VertexKey
+    {
+        int position{};
+        int normal{};
+        int uv{};
+
+        bool operator==(const VertexKey&) const = default;
+    };
+
+    struct VertexKeyHash
+    {
+        size_t operator()(const VertexKey& p_key) const
+        {
+            auto hash = static_cast<uint64_t>(static_cast<uint32_t>(p_key.position)) * 0x9E3779B97F4A7C15ull;
+            hash ^= (static_cast<uint64_t>(static_cast<uint32_t>(p_key.normal)) + (hash << 6) + (hash >> 2)) * 0xC2B2AE3D27D4EB4Full;
+            hash ^= (static_cast<uint64_t>(static_cast<uint32_t>(p_key.uv)) + (hash << 6) + (hash >> 2)) * 0x165667B19E3779F9ull;
+            return static_cast<size_t>(hash ^ (hash >> 32));
+        }
+    };
+
+    //tinyobjloader passes face indices through as written, a key may point past the attributes of the file
+    bool is_in_range(const tinyobj::attrib_t& p_attrib, const VertexKey& p_key)
+    {
+        return p_key.position >= 0 && static_cast<size_t>(p_key.position) * 3 + 2 < p_attrib.vertices.size()
+            && (p_key.normal < 0 || static_cast<size_t>(p_key.normal) * 3 + 2 < p_attrib.normals.size())
+            && (p_key.uv < 0 || static_cast<size_t>(p_key.uv) * 2 + 1 < p_attrib.texcoords.size());
+    }
+
+    vi::Vertex make_vertex(const tinyobj::attrib_t& p_attrib, const VertexKey& p_key)
+    {
+        vi::Vertex vertex{};
+
+        const auto position = static_cast<size_t>(p_key.position) * 3;
+        vertex.Position = { p_attrib.vertices[position], p_attrib.vertices[position + 1], p_attrib.vertices[position + 2] };
+
+        if (p_attrib.colors.size() == p_attrib.vertices.size())
+        {
+            vertex.Color = { p_attrib.colors[position], p_attrib.colors[position + 1], p_attrib.colors[position + 2], 1.0f };
+        }
+
+        if (p_key.normal >= 0)
+        {
+            const auto normal = static_cast<size_t>(p_key.normal) * 3;
+            vertex.Normal = { p_attrib.normals[normal], p_attrib.normals[normal + 1], p_attrib.normals[normal + 2] };
+        }
+
+        if (p_key.uv >= 0)
+        {
+            //OBJ puts the uv origin at the bottom left, Vulkan samples from the top left
+            const auto uv = static_cast<size_t>(p_key.uv) * 2;
+            vertex.UvX = p_attrib.texcoords[uv];
+            vertex.UvY = 1.0f - p_attrib.texcoords[uv + 1];
+        }
+
+        return vertex;
+    }
+
+    void optimize_triangle_order(const std::span<uint32_t> p_indices, const std::span<const vi::Vertex> p_vertices)
+    {
+        vi::optimize_vertex_cache(p_indices, p_vertices.size());
+        vi::optimize_overdraw(p_indices, p_vertices);
+    }
+
+    //Appends the coarser levels to the indices of p_mesh, every one simplified from the full mesh so its error is measured against it
+    void build_lods(vi::MeshData& p_mesh)
+    {
+        VI_PROFILE_FUNCTION();
+
+        glm::vec3 min{ p_mesh.Vertices.front().Position };
+        glm::vec3 max{ p_mesh.Vertices.front().Position };
+        for (const auto& vertex : p_mesh.Vertices)
+        {
+            min = glm::min(min, vertex.Position);
+            max = glm::max(max, vertex.Position);
+        }
+        const auto max_error = glm::length(max - min) * 0.5f * LOD_MAX_ERROR;
+
+        const std::vector<uint32_t> full_detail{ p_mesh.Indices };
+        p_mesh.Lods.push_back({ 0, static_cast<uint32_t>(full_detail.size()), 0.0f });
+
+        while (p_mesh.Lods.size() < vi::MAX_MESH_LODS)
+        {
+            const auto previous_count = p_mesh.Lods.back().IndexCount;
+            const auto target_count = static_cast<size_t>(static_cast<float>(previous_count / 3) * LOD_REDUCTION) * 3;
+
+            auto error = 0.0f;
+            auto lod = vi::simplify(full_detail, p_mesh.Vertices, target_count, max_error, error);
+            if (lod.empty() || static_cast<float>(lod.size()) > static_cast<float>(previous_count) * (1.0f - LOD_MIN_SAVING))
+            {
+                break;
+            }
+
+            optimize_triangle_order(lod, p_mesh.Vertices);
+            p_mesh.Lods.push_back({ static_cast<uint32_t>(p_mesh.Indices.size()), static_cast<uint32_t>(lod.size()), error });
+            p_mesh.Indices.insert(p_mesh.Indices.end(), lod.begin(), lod.end());
+        }
+    }
+}
+
+namespace vi
+{
+    struct MeshImporter::Import
+    {
+        std::filesystem::path m_path{};
+        std::filesystem::path m_cache_path{};
+        tinyobj::ObjReader m_reader{};
+        //shapes with faces, in file order, each worker only fills its own entry
+        std::vector<MeshData> m_meshes{};
+        std::atomic<size_t> m_remaining{};
+
+        std::mutex m_error_mutex{};
+        std::exception_ptr m_error{};
+
+        std::promise<std::vector<MeshData>> m_promise{};
+    };
+
+    void MeshImporter::init(const uint32_t p_thread_count)
+    {
+        m_thread_pool.init("Mesh Import", p_thread_count);
+    }
+
+    void MeshImporter::shutdown()
+    {
+        m_thread_pool.shutdown();
+    }
+
+    std::future<std::vector<MeshData>> MeshImporter::import_obj(const std::filesystem::path& p_path, const std::filesystem::path& p_cache_path)
+    {
+        auto import = std::make_shared<Import>();
+        import->m_path = p_path;
+        import->m_cache_path = p_cache_path;
+        auto future = import->m_promise.get_future();
+
+        static_cast<void>(m_thread_pool.submit([this, import]()
+        {
+            parse(import);
+        }));
+
+        return future;
+    }
+
+    std::future<std::vector<MeshData>> MeshImporter::load_obj(const std::filesystem::path& p_path)
+    {
+        auto import = std::make_shared<Import>();
+        import->m_path = p_path;
+        import->m_cache_path = MeshCache::get_cache_path(p_path);
+        auto future = import->m_promise.get_future();
+
+        static_cast<void>(m_thread_pool.submit([this, import]()
+        {
+            if (!load_cache(*import))
+            {
+                parse(import);
+            }
+        }));
+
+        return future;
+    }
+
+    bool MeshImporter::load_cache(Import& p_import)
+    {
+        VI_PROFILE_FUNCTION();
+
+        MeshCache cache{};
+        if (!cache.open(p_import.m_cache_path, p_import.m_path))
+        {
+            return false;
+        }
+
+        //the cache is closed once the meshes are copied out, callers own what they get like after an import
+        std::vector<MeshData> meshes;
+        meshes.reserve(cache.get_submeshes().size());
+        for (const auto& submesh : cache.get_submeshes())
+        {
+            auto& mesh = meshes.emplace_back();
+            mesh.Name = submesh.Name;
+            mesh.Vertices.assign(submesh.Vertices.begin(), submesh.Vertices.end());
+            mesh.Indices.assign(submesh.Indices.begin(), submesh.Indices.end());
+            mesh.Lods.assign(submesh.Lods.begin(), submesh.Lods.end());
+        }
+
+        p_import.m_promise.set_value(std::move(meshes));
+        return true;
+    }
+
+    void MeshImporter::parse(const std::shared_ptr<Import>& p_import)
+    {
+        VI_PROFILE_FUNCTION();
+
+        tinyobj::ObjReaderConfig config{};
+        config.triangulate = true;
+        config.vertex_color = true;
+
+        if (!p_import->m_reader.ParseFromFile(p_import->m_path.string(), config))
+        {
+            p_import->m_promise.set_exception(std::make_exception_ptr(std::runtime_error(std::format("Cannot import {}: {}", p_import->m_path.string(), p_import->m_reader.Error()))));
+            return;
+        }
+
+        if (!p_import->m_reader.Warning().empty())
+        {
+            VI_CORE_WARN("{}: {}", p_import->m_path.string(), p_import->m_reader.Warning());
+        }
+
+        //lines and points have no faces to draw
+        const auto& shapes = p_import->m_reader.GetShapes();
+        std::vector<size_t> shapes_with_faces;
+        for (size_t shape = 0; shape < shapes.size(); ++shape)
+        {
+            if (!shapes[shape].mesh.indices.empty())
+            {
+                shapes_with_faces.push_back(shape);
+            }
+        }
+
+        if (shapes_with_faces.empty())
+        {
+            VI_CORE_WARN("{} has no faces", p_import->m_path.string());
+            p_import->m_promise.set_value({});
+            return;
+        }
+
+        p_import->m_meshes.resize(shapes_with_faces.size());
+        p_import->m_remaining = shapes_with_faces.size();
+
+        //the last shape is indexed on this thread, it is already here and holds the parsed data
+        for (size_t mesh = 0; mesh + 1 < shapes_with_faces.size(); ++mesh)
+        {
+            static_cast<void>(m_thread_pool.submit([p_import, shape = shapes_with_faces[mesh], mesh]()
+            {
+                index_shape(*p_import, shape, mesh);
+            }));
+        }
+        index_shape(*p_import, shapes_with_faces.back(), shapes_with_faces.size() - 1);
+    }
+
+    void MeshImporter::index_shape(Import& p_import, const size_t p_shape, const size_t p_mesh)
+    {
+        VI_PROFILE_FUNCTION();
+
+        try
+        {
+            const auto& attrib = p_import.m_reader.GetAttrib();
+            const auto& shape = p_import.m_reader.GetShapes()[p_shape];
+            auto& mesh = p_import.m_meshes[p_mesh];
+
+            mesh.Name = shape.name;
+            mesh.Indices.reserve(shape.mesh.indices.size());
+
+            std::unordered_map<VertexKey, uint32_t, VertexKeyHash> vertex_indices;
+            vertex_indices.reserve(shape.mesh.indices.size());
+
+            auto missing_normals = false;
+            for (const auto& index : shape.mesh.indices)
+            {
+                const VertexKey key{ index.vertex_index, index.normal_index, index.texcoord_index };
+
+                const auto [it, inserted] = vertex_indices.try_emplace(key, static_cast<uint32_t>(mesh.Vertices.size()));
+                if (inserted)
+                {
+                    if (!is_in_range(attrib, key))
+                    {
+                        throw std::runtime_error(std::format("Cannot import {}: a face refers to position {}, normal {} and uv {} of {} positions, {} normals and {} uvs",
+                            p_import.m_path.string(), key.position, key.normal, key.uv, attrib.vertices.size() / 3, attrib.normals.size() / 3, attrib.texcoords.size() / 2));
+                    }
+                    mesh.Vertices.push_back(make_vertex(attrib, key));
+                    missing_normals |= key.normal < 0;
+                }
+                mesh.Indices.push_back(it->second);
+            }
+
+            if (missing_normals)
+            {
+                //vertices without a normal sum the area weighted normals of their faces
+                std::vector<bool> generated(mesh.Vertices.size(), false);
+                for (const auto& [key, index] : vertex_indices)
+                {
+                    generated[index] = key.normal < 0;
+                }
+
+                for (size_t triangle = 0; triangle + 2 < mesh.Indices.size(); triangle += 3)
+                {
+                    const auto a = mesh.Indices[triangle];
+                    const auto b = mesh.Indices[triangle + 1];
+                    const auto c = mesh.Indices[triangle + 2];
+                    const auto face_normal = glm::cross(mesh.Vertices[b].Position - mesh.Vertices[a].Position, mesh.Vertices[c].Position - mesh.Vertices[a].Position);
+
+                    for (const auto vertex : { a, b, c })
+                    {
+                        if (generated[vertex])
+                        {
+                            mesh.Vertices[vertex].Normal += face_normal;
+                        }
+                    }
+                }
+
+                for (size_t vertex = 0; vertex < mesh.Vertices.size(); ++vertex)
+                {
+                    if (generated[vertex] && glm::dot(mesh.Vertices[vertex].Normal, mesh.Vertices[vertex].Normal) > 0.0f)
+                    {
+                        mesh.Vertices[vertex].Normal = glm::normalize(mesh.Vertices[vertex].Normal);
+                    }
+                }
+            }
+
+            //OBJ order follows how the file was authored, not how the GPU walks it
+            optimize_triangle_order(mesh.Indices, mesh.Vertices);
+            build_lods(mesh);
+            //the coarser levels only use vertices of the full one, which comes first
+            optimize_vertex_fetch(mesh.Vertices, mesh.Indices);
+        }
+        catch (...)
+        {
+            std::scoped_lock lock{ p_import.m_error_mutex };
+            if (!p_import.m_error)
+            {
+                p_import.m_error = std::current_exception();
+            }
+        }
+
+        finish_shape(p_import);
+    }
+
+    void MeshImporter::finish_shape(Import& p_import)
+    {
+        if (p_import.m_remaining.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        {
+            return;
+        }
+
+        //last shape done, every other worker has released its entry
+        if (p_import.m_error)
+        {
+            p_import.m_promise.set_exception(p_import.m_error);
+            return;
+        }
+
+        size_t vertex_count{};
+        size_t index_count{};
+        for (const auto& mesh : p_import.m_meshes)
+        {
+            vertex_count += mesh.Vertices.size();
+            index_count += mesh.Indices.size();
+        }
+        VI_CORE_INFO("Imported {}: {} meshes, {} vertices, {} indices", p_import.m_path.string(), p_import.m_meshes.size(), vertex_count, index_count);
+
+        //the import itself succeeded, a cache that cannot be written only costs the next load
+        if (!p_import.m_cache_path.empty())
+        {
+            try
+            {
+                MeshCache::write(p_import.m_cache_path, p_import.m_meshes, p_import.m_path);
+            }
+            catch (const std::exception& p_exception)
+            {
+                VI_CORE_WARN("Cannot write mesh cache: {}", p_exception.what());
+            }
+        }
+
+        p_import.m_promise.set_value(std::move(p_import.m_meshes));
+    }
+}
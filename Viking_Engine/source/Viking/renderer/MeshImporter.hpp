@@ -0,0 +1,65 @@
+#ifndef MESH_IMPORTER_HPP
+#define MESH_IMPORTER_HPP
+
+#include "Viking/core/ThreadPool.hpp"
+#include "Viking/renderer/Mesh.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace vi
+{
+    //Indexed geometry of one shape, laid out the way Renderer::upload_mesh takes it
+    struct MeshData {
+        std::string Name{};
+        std::vector<Vertex> Vertices{};
+        std::vector<uint32_t> Indices{};
+        //LOD 0 first, each level a range of Indices. Empty when Indices is a single level
+        std::vector<MeshLod> Lods{};
+    };
+
+    //Imports OBJ files with tinyobjloader without blocking the calling thread.
+    //A file is parsed by one worker, then its shapes are indexed in parallel: every distinct
+    //position/normal/uv combination of a shape becomes one vertex. Shapes without normals get smooth ones.
+    //Coarser levels of detail are simplified from the full mesh, then the triangles and vertices of every level
+    //are reordered for the post-transform cache, overdraw and fetch locality
+    class MeshImporter
+    {
+    public:
+        MeshImporter() = default;
+        ~MeshImporter() { shutdown(); }
+
+        MeshImporter(const MeshImporter&) = delete;
+        MeshImporter& operator=(const MeshImporter&) = delete;
+
+        //0 threads uses every hardware thread but the calling one
+        void init(uint32_t p_thread_count = 0);
+        //Finishes the imports in progress
+        void shutdown();
+
+        //Returns at once. The future holds one mesh per shape with faces, in file order, or rethrows why the import failed.
+        //A non-empty p_cache_path also gets the meshes written as a MeshCache before the future is ready.
+        //Safe to call from any thread
+        [[nodiscard]] std::future<std::vector<MeshData>> import_obj(const std::filesystem::path& p_path, const std::filesystem::path& p_cache_path = {});
+        //Same as import_obj, but reads the MeshCache at MeshCache::get_cache_path(p_path) when it is up to date
+        //and only imports, writing that cache, when it is missing, stale or corrupted
+        [[nodiscard]] std::future<std::vector<MeshData>> load_obj(const std::filesystem::path& p_path);
+
+    private:
+        struct Import;
+
+        //False when there is no usable cache and the file has to be imported
+        static bool load_cache(Import& p_import);
+        void parse(const std::shared_ptr<Import>& p_import);
+        static void index_shape(Import& p_import, size_t p_shape, size_t p_mesh);
+        static void finish_shape(Import& p_import);
+
+        ThreadPool m_thread_pool{};
+    };
+}
+
+#endif
@@ -0,0 +1,691 @@
+#include "Viking/renderer/MeshOptimizer.hpp"
+
+#include "Viking/core/Profiler.hpp"
+
+#include <glm/gtc/packing.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+#include <utility>
+
+namespace
+{
+    //entries of the simulated post-transform cache, about what current GPUs keep per batch
+    constexpr size_t CACHE_SIZE{ 16 };
+    constexpr size_t MAX_VALENCE{ 32 };
+    constexpr uint32_t INVALID_INDEX{ std::numeric_limits<uint32_t>::max() };
+
+    constexpr float LAST_TRIANGLE_SCORE{ 0.75f };
+    constexpr float CACHE_DECAY_POWER{ 1.5f };
+    constexpr float VALENCE_BOOST_SCALE{ 2.0f };
+    constexpr float VALENCE_BOOST_POWER{ 0.5f };
+
+    struct ScoreTables
+    {
+        std::array<float, CACHE_SIZE> cache{};
+        std::array<float, MAX_VALENCE + 1> valence{};
+    };
+
+    ScoreTables make_score_tables()
+    {
+        ScoreTables tables{};
+        for (size_t position = 0; position < CACHE_SIZE; ++position)
+        {
+            //the vertices of the triangle just emitted score lower, the next one should not depend on all three
+            tables.cache[position] = position < 3
+                ? LAST_TRIANGLE_SCORE
+                : std::pow(1.0f - static_cast<float>(position - 3) / static_cast<float>(CACHE_SIZE - 3), CACHE_DECAY_POWER);
+        }
+        //vertices with few triangles left are finished first, so they leave the cache for good
+        for (size_t valence = 1; valence <= MAX_VALENCE; ++valence)
+        {
+            tables.valence[valence] = VALENCE_BOOST_SCALE * std::pow(static_cast<float>(valence), -VALENCE_BOOST_POWER);
+        }
+        return tables;
+    }
+
+    float vertex_score(const ScoreTables& p_tables, const size_t p_cache_position, const uint32_t p_live_triangles)
+    {
+        if (p_live_triangles == 0)
+        {
+            return 0.0f;
+        }
+
+        const auto cache_score = p_cache_position < CACHE_SIZE ? p_tables.cache[p_cache_position] : 0.0f;
+        return cache_score + p_tables.valence[std::min<size_t>(p_live_triangles, MAX_VALENCE)];
+    }
+
+    //Sum of squared distances to the planes of the triangles around a vertex, weighted by their area.
+    //Doubles, the terms of large meshes lose too much in floats
+    struct Quadric
+    {
+        double a00{}, a11{}, a22{}, a01{}, a02{}, a12{};
+        double b0{}, b1{}, b2{};
+        double c{};
+        double weight{};
+
+        Quadric& operator+=(const Quadric& p_other)
+        {
+            a00 += p_other.a00; a11 += p_other.a11; a22 += p_other.a22;
+            a01 += p_other.a01; a02 += p_other.a02; a12 += p_other.a12;
+            b0 += p_other.b0; b1 += p_other.b1; b2 += p_other.b2;
+            c += p_other.c;
+            weight += p_other.weight;
+            return *this;
+        }
+    };
+
+    Quadric plane_quadric(const glm::vec3& p_a, const glm::vec3& p_b, const glm::vec3& p_c)
+    {
+        const auto normal = glm::cross(p_b - p_a, p_c - p_a);
+        const auto length = static_cast<double>(glm::length(normal));
+        if (length == 0.0)
+        {
+            return {};
+        }
+
+        const auto x = normal.x / length;
+        const auto y = normal.y / length;
+        const auto z = normal.z / length;
+        const auto d = -(x * p_a.x + y * p_a.y + z * p_a.z);
+        const auto area = length * 0.5;
+
+        return {
+            .a00 = x * x * area, .a11 = y * y * area, .a22 = z * z * area,
+            .a01 = x * y * area, .a02 = x * z * area, .a12 = y * z * area,
+            .b0 = x * d * area, .b1 = y * d * area, .b2 = z * d * area,
+            .c = d * d * area,
+            .weight = area
+        };
+    }
+
+    //root mean squared distance of p_position to the planes of the quadric
+    float quadric_error(const Quadric& p_quadric, const glm::vec3& p_position)
+    {
+        if (p_quadric.weight == 0.0)
+        {
+            return 0.0f;
+        }
+
+        const double x = p_position.x;
+        const double y = p_position.y;
+        const double z = p_position.z;
+        const auto error = p_quadric.a00 * x * x + p_quadric.a11 * y * y + p_quadric.a22 * z * z
+            + 2.0 * (p_quadric.a01 * x * y + p_quadric.a02 * x * z + p_quadric.a12 * y * z)
+            + 2.0 * (p_quadric.b0 * x + p_quadric.b1 * y + p_quadric.b2 * z)
+            + p_quadric.c;
+
+        return static_cast<float>(std::sqrt(std::max(error, 0.0) / p_quadric.weight));
+    }
+
+    struct PositionHash
+    {
+        size_t operator()(const glm::vec3& p_position) const
+        {
+            const auto x = std::bit_cast<uint32_t>(p_position.x);
+            const auto y = std::bit_cast<uint32_t>(p_position.y);
+            const auto z = std::bit_cast<uint32_t>(p_position.z);
+            return static_cast<size_t>((x * 73856093u) ^ (y * 19349663u) ^ (z * 83492791u));
+        }
+    };
+
+    //Triangles around every vertex of an index list
+    struct Adjacency
+    {
+        std::vector<uint32_t> offsets{};
+        std::vector<uint32_t> triangles{};
+
+        Adjacency(const std::span<const uint32_t> p_indices, const size_t p_vertex_count)
+            : offsets(p_vertex_count + 1, 0), triangles(p_indices.size())
+        {
+            for (const auto index : p_indices)
+            {
+                ++offsets[index + 1];
+            }
+            std::inclusive_scan(offsets.begin(), offsets.end(), offsets.begin());
+
+            std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+            for (size_t index = 0; index < p_indices.size(); ++index)
+            {
+                triangles[fill[p_indices[index]]++] = static_cast<uint32_t>(index / 3);
+            }
+        }
+
+        [[nodiscard]] std::span<const uint32_t> get(const uint32_t p_vertex) const
+        {
+            return std::span{ triangles }.subspan(offsets[p_vertex], offsets[p_vertex + 1] - offsets[p_vertex]);
+        }
+    };
+
+    //Moving p_from onto p_to must not turn any of the remaining triangles around p_from over
+    bool flips_triangle(const std::span<const uint32_t> p_indices, const std::span<const vi::Vertex> p_vertices, const Adjacency& p_adjacency,
+        const uint32_t p_from, const uint32_t p_to)
+    {
+        const auto& destination = p_vertices[p_to].Position;
+        for (const auto triangle : p_adjacency.get(p_from))
+        {
+            const std::array corners{ p_indices[triangle * 3], p_indices[triangle * 3 + 1], p_indices[triangle * 3 + 2] };
+            if (std::ranges::find(corners, p_to) != corners.end())
+            {
+                //collapses to a degenerate triangle and is removed
+                continue;
+            }
+
+            //rotate so p_from comes first, the winding stays the same
+            const auto first = static_cast<size_t>(std::ranges::find(corners, p_from) - corners.begin());
+            const auto& b = p_vertices[corners[(first + 1) % 3]].Position;
+            const auto& c = p_vertices[corners[(first + 2) % 3]].Position;
+
+            const auto before = glm::cross(b - p_vertices[p_from].Position, c - p_vertices[p_from].Position);
+            const auto after = glm::cross(b - destination, c - destination);
+            if (glm::dot(before, after) <= 0.0f)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+}
+
+namespace vi
+{
+    void optimize_vertex_cache(const std::span<uint32_t> p_indices, const size_t p_vertex_count)
+    {
+        VI_PROFILE_FUNCTION();
+
+        const auto triangle_count = p_indices.size() / 3;
+        if (triangle_count == 0)
+        {
+            return;
+        }
+
+        static const auto tables = make_score_tables();
+
+        //triangles using each vertex, the first live_triangles[vertex] of its range are not emitted yet
+        std::vector<uint32_t> live_triangles(p_vertex_count, 0);
+        for (size_t index = 0; index < triangle_count * 3; ++index)
+        {
+            ++live_triangles[p_indices[index]];
+        }
+
+        std::vector<uint32_t> adjacency_offsets(p_vertex_count + 1, 0);
+        std::inclusive_scan(live_triangles.begin(), live_triangles.end(), adjacency_offsets.begin() + 1);
+
+        std::vector<uint32_t> adjacency(triangle_count * 3);
+        std::vector<uint32_t> fill(adjacency_offsets.begin(), adjacency_offsets.end() - 1);
+        for (size_t triangle = 0; triangle < triangle_count; ++triangle)
+        {
+            for (size_t corner = 0; corner < 3; ++corner)
+            {
+                adjacency[fill[p_indices[triangle * 3 + corner]]++] = static_cast<uint32_t>(triangle);
+            }
+        }
+
+        std::vector<float> vertex_scores(p_vertex_count);
+        for (size_t vertex = 0; vertex < p_vertex_count; ++vertex)
+        {
+            vertex_scores[vertex] = vertex_score(tables, CACHE_SIZE, live_triangles[vertex]);
+        }
+
+        std::vector<float> triangle_scores(triangle_count);
+        for (size_t triangle = 0; triangle < triangle_count; ++triangle)
+        {
+            triangle_scores[triangle] = vertex_scores[p_indices[triangle * 3]] + vertex_scores[p_indices[triangle * 3 + 1]] + vertex_scores[p_indices[triangle * 3 + 2]];
+        }
+
+        std::vector<bool> emitted(triangle_count, false);
+        std::vector<uint32_t> result(triangle_count * 3);
+
+        //three more than the cache, the entries pushed out still need their scores lowered
+        std::array<uint32_t, CACHE_SIZE + 3> cache{};
+        std::array<uint32_t, CACHE_SIZE + 3> next_cache{};
+        size_t cache_count{};
+
+        size_t input_cursor{};
+        uint32_t current{ 0 };
+
+        for (size_t output = 0; output < triangle_count; ++output)
+        {
+            //nothing in the cache is connected to a live triangle, continue with the next one in input order
+            if (current == INVALID_INDEX)
+            {
+                while (emitted[input_cursor])
+                {
+                    ++input_cursor;
+                }
+                current = static_cast<uint32_t>(input_cursor);
+            }
+
+            const std::array corners{ p_indices[current * 3], p_indices[current * 3 + 1], p_indices[current * 3 + 2] };
+            std::ranges::copy(corners, result.begin() + static_cast<std::ptrdiff_t>(output * 3));
+            emitted[current] = true;
+
+            size_t next_count{};
+            for (const auto vertex : corners)
+            {
+                next_cache[next_count++] = vertex;
+            }
+            for (size_t entry = 0; entry < cache_count; ++entry)
+            {
+                const auto vertex = cache[entry];
+                if (vertex != corners[0] && vertex != corners[1] && vertex != corners[2])
+                {
+                    next_cache[next_count++] = vertex;
+                }
+            }
+
+            for (const auto vertex : corners)
+            {
+                const auto begin = adjacency.begin() + adjacency_offsets[vertex];
+                const auto end = begin + live_triangles[vertex];
+                std::iter_swap(std::find(begin, end, current), end - 1);
+                --live_triangles[vertex];
+            }
+
+            //the scores of every vertex that moved in the cache change, and with them the ones of their triangles
+            for (size_t entry = 0; entry < next_count; ++entry)
+            {
+                const auto vertex = next_cache[entry];
+                const auto score = vertex_score(tables, entry, live_triangles[vertex]);
+                const auto difference = score - vertex_scores[vertex];
+                vertex_scores[vertex] = score;
+
+                for (uint32_t slot = 0; slot < live_triangles[vertex]; ++slot)
+                {
+                    triangle_scores[adjacency[adjacency_offsets[vertex] + slot]] += difference;
+                }
+            }
+
+            current = INVALID_INDEX;
+            auto best_score = -1.0f;
+            for (size_t entry = 0; entry < next_count; ++entry)
+            {
+                const auto vertex = next_cache[entry];
+                for (uint32_t slot = 0; slot < live_triangles[vertex]; ++slot)
+                {
+                    const auto triangle = adjacency[adjacency_offsets[vertex] + slot];
+                    if (triangle_scores[triangle] > best_score)
+                    {
+                        best_score = triangle_scores[triangle];
+                        current = triangle;
+                    }
+                }
+            }
+
+            cache_count = std::min(next_count, CACHE_SIZE);
+            std::swap(cache, next_cache);
+        }
+
+        std::ranges::copy(result, p_indices.begin());
+    }
+
+    void optimize_overdraw(const std::span<uint32_t> p_indices, const std::span<const Vertex> p_vertices)
+    {
+        VI_PROFILE_FUNCTION();
+
+        const auto triangle_count = p_indices.size() / 3;
+        if (triangle_count == 0)
+        {
+            return;
+        }
+
+        //a triangle missing the cache with all three vertices starts over as if the mesh began there,
+        //moving the clusters between those points around costs no more cache misses
+        std::vector<size_t> cluster_starts;
+        std::vector<uint32_t> cache(CACHE_SIZE, INVALID_INDEX);
+        size_t cache_head{};
+        for (size_t triangle = 0; triangle < triangle_count; ++triangle)
+        {
+            uint32_t misses{};
+            for (size_t corner = 0; corner < 3; ++corner)
+            {
+                const auto vertex = p_indices[triangle * 3 + corner];
+                if (std::ranges::find(cache, vertex) == cache.end())
+                {
+                    cache[cache_head] = vertex;
+                    cache_head = (cache_head + 1) % CACHE_SIZE;
+                    ++misses;
+                }
+            }
+
+            if (misses == 3)
+            {
+                cluster_starts.push_back(triangle);
+            }
+        }
+        cluster_starts.push_back(triangle_count);
+
+        if (cluster_starts.size() <= 2)
+        {
+            return;
+        }
+
+        struct Cluster
+        {
+            size_t first_triangle{};
+            size_t triangle_count{};
+            glm::vec3 centroid{};
+            glm::vec3 normal{};
+            float area{};
+            float sort_key{};
+        };
+
+        std::vector<Cluster> clusters(cluster_starts.size() - 1);
+        glm::vec3 mesh_centroid{ 0.0f };
+        auto mesh_area = 0.0f;
+        for (size_t index = 0; index < clusters.size(); ++index)
+        {
+            auto& cluster = clusters[index];
+            cluster.first_triangle = cluster_starts[index];
+            cluster.triangle_count = cluster_starts[index + 1] - cluster_starts[index];
+
+            glm::vec3 weighted_centroid{ 0.0f };
+            for (size_t triangle = cluster.first_triangle; triangle < cluster.first_triangle + cluster.triangle_count; ++triangle)
+            {
+                const auto& a = p_vertices[p_indices[triangle * 3]].Position;
+                const auto& b = p_vertices[p_indices[triangle * 3 + 1]].Position;
+                const auto& c = p_vertices[p_indices[triangle * 3 + 2]].Position;
+
+                const auto normal = glm::cross(b - a, c - a);
+                const auto area = glm::length(normal);
+                cluster.normal += normal;
+                weighted_centroid += (a + b + c) * (area / 3.0f);
+                cluster.area += area;
+            }
+
+            cluster.centroid = cluster.area > 0.0f ? weighted_centroid / cluster.area : weighted_centroid;
+            mesh_centroid += weighted_centroid;
+            mesh_area += cluster.area;
+        }
+        if (mesh_area > 0.0f)
+        {
+            mesh_centroid /= mesh_area;
+        }
+
+        //clusters far out along their own normal occlude the rest of the mesh and are drawn first
+        for (auto& cluster : clusters)
+        {
+            const auto length = glm::length(cluster.normal);
+            cluster.sort_key = length > 0.0f ? glm::dot(cluster.centroid - mesh_centroid, cluster.normal / length) : 0.0f;
+        }
+
+        std::ranges::stable_sort(clusters, std::ranges::greater{}, &Cluster::sort_key);
+
+        std::vector<uint32_t> result;
+        result.reserve(triangle_count * 3);
+        for (const auto& cluster : clusters)
+        {
+            const auto begin = p_indices.begin() + static_cast<std::ptrdiff_t>(cluster.first_triangle * 3);
+            result.insert(result.end(), begin, begin + static_cast<std::ptrdiff_t>(cluster.triangle_count * 3));
+        }
+
+        std::ranges::copy(result, p_indices.begin());
+    }
+
+    void optimize_vertex_fetch(std::vector<Vertex>& p_vertices, const std::span<uint32_t> p_indices)
+    {
+        VI_PROFILE_FUNCTION();
+
+        std::vector<uint32_t> remap(p_vertices.size(), INVALID_INDEX);
+        uint32_t next_vertex{};
+        for (auto& index : p_indices)
+        {
+            if (remap[index] == INVALID_INDEX)
+            {
+                remap[index] = next_vertex++;
+            }
+            index = remap[index];
+        }
+
+        std::vector<Vertex> vertices(next_vertex);
+        for (size_t vertex = 0; vertex < p_vertices.size(); ++vertex)
+        {
+            if (remap[vertex] != INVALID_INDEX)
+            {
+                vertices[remap[vertex]] = p_vertices[vertex];
+            }
+        }
+
+        p_vertices = std::move(vertices);
+    }
+
+    std::vector<uint32_t> simplify(const std::span<const uint32_t> p_indices, const std::span<const Vertex> p_vertices, const size_t p_target_index_count,
+        const float p_target_error, float& p_result_error)
+    {
+        VI_PROFILE_FUNCTION();
+
+        p_result_error = 0.0f;
+        std::vector<uint32_t> result(p_indices.begin(), p_indices.end());
+        if (result.size() <= p_target_index_count)
+        {
+            return result;
+        }
+
+        //vertices split by normals or uvs share a position, the quadrics and the border test work on positions
+        std::vector<uint32_t> position_ids(p_vertices.size());
+        std::vector<uint32_t> wedge_counts(p_vertices.size(), 0);
+        {
+            std::unordered_map<glm::vec3, uint32_t, PositionHash> first_vertices;
+            first_vertices.reserve(p_vertices.size());
+            for (size_t vertex = 0; vertex < p_vertices.size(); ++vertex)
+            {
+                const auto [it, inserted] = first_vertices.try_emplace(p_vertices[vertex].Position, static_cast<uint32_t>(vertex));
+                position_ids[vertex] = it->second;
+                ++wedge_counts[it->second];
+            }
+        }
+
+        //a seam would tear open if one side moved without the other, and a border would shrink away
+        std::vector<bool> locked(p_vertices.size(), false);
+        {
+            std::unordered_map<uint64_t, uint32_t> edge_uses;
+            edge_uses.reserve(result.size());
+            for (size_t triangle = 0; triangle < result.size() / 3; ++triangle)
+            {
+                for (size_t corner = 0; corner < 3; ++corner)
+                {
+                    const auto a = position_ids[result[triangle * 3 + corner]];
+                    const auto b = position_ids[result[triangle * 3 + (corner + 1) % 3]];
+                    ++edge_uses[(static_cast<uint64_t>(std::min(a, b)) << 32) | std::max(a, b)];
+                }
+            }
+
+            std::vector<bool> locked_positions(p_vertices.size(), false);
+            for (const auto& [edge, uses] : edge_uses)
+            {
+                //non-manifold edges are kept as well, collapsing them is rarely what the mesh meant
+                if (uses != 2)
+                {
+                    locked_positions[static_cast<uint32_t>(edge >> 32)] = true;
+                    locked_positions[static_cast<uint32_t>(edge)] = true;
+                }
+            }
+
+            for (size_t vertex = 0; vertex < p_vertices.size(); ++vertex)
+            {
+                const auto position = position_ids[vertex];
+                locked[vertex] = wedge_counts[position] > 1 || locked_positions[position];
+            }
+        }
+
+        std::vector<Quadric> quadrics(p_vertices.size());
+        for (size_t triangle = 0; triangle < result.size() / 3; ++triangle)
+        {
+            const auto a = result[triangle * 3];
+            const auto b = result[triangle * 3 + 1];
+            const auto c = result[triangle * 3 + 2];
+            const auto quadric = plane_quadric(p_vertices[a].Position, p_vertices[b].Position, p_vertices[c].Position);
+            quadrics[position_ids[a]] += quadric;
+            quadrics[position_ids[b]] += quadric;
+            quadrics[position_ids[c]] += quadric;
+        }
+
+        struct Collapse
+        {
+            uint32_t from{};
+            uint32_t to{};
+            float error{};
+        };
+
+        std::vector<Collapse> collapses;
+        std::vector<uint32_t> remap(p_vertices.size());
+        std::vector<bool> touched(p_vertices.size());
+
+        //every pass collapses the cheapest edges that do not share triangles, then the index list is rebuilt
+        while (result.size() > p_target_index_count)
+        {
+            const Adjacency adjacency{ result, p_vertices.size() };
+
+            collapses.clear();
+            for (size_t triangle = 0; triangle < result.size() / 3; ++triangle)
+            {
+                for (size_t corner = 0; corner < 3; ++corner)
+                {
+                    const auto a = result[triangle * 3 + corner];
+                    const auto b = result[triangle * 3 + (corner + 1) % 3];
+                    for (const auto& [from, to] : { std::pair{ a, b }, std::pair{ b, a } })
+                    {
+                        if (!locked[from])
+                        {
+                            auto quadric = quadrics[position_ids[from]];
+                            quadric += quadrics[position_ids[to]];
+                            collapses.push_back({ from, to, quadric_error(quadric, p_vertices[to].Position) });
+                        }
+                    }
+                }
+            }
+
+            std::ranges::sort(collapses, std::ranges::less{}, &Collapse::error);
+
+            std::iota(remap.begin(), remap.end(), 0u);
+            std::fill(touched.begin(), touched.end(), false);
+
+            const auto triangles_to_remove = (result.size() - p_target_index_count + 2) / 3;
+            size_t removed_triangles{};
+            size_t applied{};
+            for (const auto& collapse : collapses)
+            {
+                if (collapse.error > p_target_error || removed_triangles >= triangles_to_remove)
+                {
+                    break;
+                }
+
+                if (touched[collapse.from] || touched[collapse.to] || flips_triangle(result, p_vertices, adjacency, collapse.from, collapse.to))
+                {
+                    continue;
+                }
+
+                //the triangles around from change shape, their other vertices have to wait for the next pass
+                for (const auto triangle : adjacency.get(collapse.from))
+                {
+                    auto shared_edge = false;
+                    for (size_t corner = 0; corner < 3; ++corner)
+                    {
+                        touched[result[triangle * 3 + corner]] = true;
+                        shared_edge |= result[triangle * 3 + corner] == collapse.to;
+                    }
+                    removed_triangles += shared_edge ? 1 : 0;
+                }
+
+                remap[collapse.from] = collapse.to;
+                quadrics[position_ids[collapse.to]] += quadrics[position_ids[collapse.from]];
+                p_result_error = std::max(p_result_error, collapse.error);
+                ++applied;
+            }
+
+            if (applied == 0)
+            {
+                break;
+            }
+
+            size_t write{};
+            for (size_t triangle = 0; triangle < result.size() / 3; ++triangle)
+            {
+                const auto a = remap[result[triangle * 3]];
+                const auto b = remap[result[triangle * 3 + 1]];
+                const auto c = remap[result[triangle * 3 + 2]];
+                if (a != b && b != c && a != c)
+                {
+                    result[write++] = a;
+                    result[write++] = b;
+                    result[write++] = c;
+                }
+            }
+            result.resize(write);
+        }
+
+        return result;
+    }
+
+    PackedMesh quantize_vertices(const std::span<const Vertex> p_vertices)
+    {
+        VI_PROFILE_FUNCTION();
+
+        PackedMesh mesh{};
+        if (p_vertices.empty())
+        {
+            return mesh;
+        }
+
+        glm::vec3 min{ p_vertices.front().Position };
+        glm::vec3 max{ p_vertices.front().Position };
+        for (const auto& vertex : p_vertices)
+        {
+            min = glm::min(min, vertex.Position);
+            max = glm::max(max, vertex.Position);
+        }
+
+        mesh.PositionOffset = min;
+        mesh.PositionScale = max - min;
+        //flat axes quantize to 0 instead of dividing by zero
+        const auto inverse_scale = glm::vec3{
+            mesh.PositionScale.x > 0.0f ? 1.0f / mesh.PositionScale.x : 0.0f,
+            mesh.PositionScale.y > 0.0f ? 1.0f / mesh.PositionScale.y : 0.0f,
+            mesh.PositionScale.z > 0.0f ? 1.0f / mesh.PositionScale.z : 0.0f
+        };
+
+        mesh.Vertices.reserve(p_vertices.size());
+        for (const auto& vertex : p_vertices)
+        {
+            const auto position = (vertex.Position - mesh.PositionOffset) * inverse_scale;
+
+            PackedVertex packed{};
+            packed.Position = { glm::packUnorm1x16(position.x), glm::packUnorm1x16(position.y), glm::packUnorm1x16(position.z), 0 };
+            packed.Normal = {
+                static_cast<int16_t>(glm::packSnorm1x16(vertex.Normal.x)),
+                static_cast<int16_t>(glm::packSnorm1x16(vertex.Normal.y)),
+                static_cast<int16_t>(glm::packSnorm1x16(vertex.Normal.z)),
+                0
+            };
+            packed.Uv = { glm::packHalf1x16(vertex.UvX), glm::packHalf1x16(vertex.UvY) };
+            packed.Color = glm::packUnorm4x8(vertex.Color);
+            mesh.Vertices.push_back(packed);
+        }
+
+        return mesh;
+    }
+
+    Vertex unpack_vertex(const PackedMesh& p_mesh, const PackedVertex& p_vertex)
+    {
+        Vertex vertex{};
+        vertex.Position = p_mesh.PositionOffset + glm::vec3{
+            glm::unpackUnorm1x16(p_vertex.Position[0]),
+            glm::unpackUnorm1x16(p_vertex.Position[1]),
+            glm::unpackUnorm1x16(p_vertex.Position[2])
+        } * p_mesh.PositionScale;
+        vertex.Normal = {
+            glm::unpackSnorm1x16(static_cast<uint16_t>(p_vertex.Normal[0])),
+            glm::unpackSnorm1x16(static_cast<uint16_t>(p_vertex.Normal[1])),
+            glm::unpackSnorm1x16(static_cast<uint16_t>(p_vertex.Normal[2]))
+        };
+        vertex.UvX = glm::unpackHalf1x16(p_vertex.Uv[0]);
+        vertex.UvY = glm::unpackHalf1x16(p_vertex.Uv[1]);
+        vertex.Color = glm::unpackUnorm4x8(p_vertex.Color);
+        return vertex;
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef MESH_OPTIMIZER_HPP
+#define MESH_OPTIMIZER_HPP
+
+#include "Viking/renderer/Mesh.hpp"
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace vi
+{
+    //Vertex at half the size of Vertex. The position is 16 bit unorm inside the mesh bounds, the normal 16 bit snorm,
+    //the uv two half floats, which keep tiling uvs outside of 0..1, and the color 8 bit unorm
+    struct PackedVertex {
+        std::array<uint16_t, 4> Position{};
+        std::array<int16_t, 4> Normal{};
+        std::array<uint16_t, 2> Uv{};
+        uint32_t Color{};
+    };
+
+    static_assert(sizeof(PackedVertex) == 24, "PackedVertex has to stay tightly packed");
+
+    //Position = PositionOffset + unorm(Position) * PositionScale
+    struct PackedMesh {
+        std::vector<PackedVertex> Vertices{};
+        glm::vec3 PositionOffset{};
+        glm::vec3 PositionScale{};
+    };
+
+    //Reorders the triangles so consecutive ones share vertices still in the post-transform cache (Forsyth's algorithm)
+    void optimize_vertex_cache(std::span<uint32_t> p_indices, size_t p_vertex_count);
+
+    //Moves clusters of triangles facing away from the mesh center behind the ones facing out, so fewer pixels are shaded
+    //twice. Clusters are cut where the cache would start over, so the order from optimize_vertex_cache keeps its hit rate
+    void optimize_overdraw(std::span<uint32_t> p_indices, std::span<const Vertex> p_vertices);
+
+    //Renumbers the vertices in the order the indices first use them, so they are fetched front to back.
+    //Vertices no index uses are dropped
+    void optimize_vertex_fetch(std::vector<Vertex>& p_vertices, std::span<uint32_t> p_indices);
+
+    //Collapses edges in the order of their quadric error until p_target_index_count is reached or the next collapse would
+    //move the surface further than p_target_error. The result indexes the same vertices, only fewer of them. Vertices on
+    //open borders and attribute seams stay where they are. p_result_error receives the largest error introduced
+    [[nodiscard]] std::vector<uint32_t> simplify(std::span<const uint32_t> p_indices, std::span<const Vertex> p_vertices, size_t p_target_index_count,
+        float p_target_error, float& p_result_error);
+
+    [[nodiscard]] PackedMesh quantize_vertices(std::span<const Vertex> p_vertices);
+    [[nodiscard]] Vertex unpack_vertex(const PackedMesh& p_mesh, const PackedVertex& p_vertex);
+}
+
+#endif
@@ -1,6 +1,8 @@
 #include "Platform/Vulkan/Renderer.hpp"
 #include "Viking/renderer/Renderer.hpp"
 
+#include "Viking/core/Log.hpp"
+#include "Viking/core/Profiler.hpp"
 #include "Viking/renderer/Context.hpp"
 
 namespace 
@@ -8,11 +10,11 @@ namespace
     class InternalRenderer
     {
     public:
-        static void init(const std::string_view p_app_name, const std::shared_ptr<vi::Window>& p_window)
+        static void init(const std::string_view p_app_name, const std::shared_ptr<vi::Window>& p_window, const vi::RendererProps& p_props)
         {
             m_context = vi::Context::create();
             m_context->init(p_app_name, p_window);
-            m_renderer.init(m_context);
+            m_renderer.init(m_context, p_props);
         }
 
         static void shutdown()
@@ -23,14 +25,76 @@ namespace
 
         static void begin_frame()
         {
+            VI_PROFILE_ZONE("Renderer::begin_frame");
             m_renderer.begin_frame();
         }
 
         static void end_frame()
         {
+            VI_PROFILE_ZONE("Renderer::end_frame");
             m_renderer.end_frame();
         }
 
+        static void on_resize(const uint32_t p_width, const uint32_t p_height)
+        {
+            m_renderer.on_resize(p_width, p_height);
+        }
+
+        static void set_present_mode(const vi::PresentMode p_mode)
+        {
+            m_renderer.set_present_mode(p_mode);
+        }
+
+        static vi::PresentMode get_present_mode()
+        {
+            return m_renderer.get_present_mode();
+        }
+
+        static const std::vector<vi::GpuTiming>& get_gpu_timings()
+        {
+            return m_renderer.get_gpu_timings();
+        }
+
+        static float get_render_scale()
+        {
+            return m_renderer.get_render_scale();
+        }
+
+        static vi::MeshHandle upload_mesh(const std::span<const vi::Vertex> p_vertices, const std::span<const uint32_t> p_indices, const std::span<const vi::MeshLod> p_lods)
+        {
+            return m_renderer.upload_mesh(p_vertices, p_indices, p_lods);
+        }
+
+        static void draw_mesh(const vi::MeshHandle p_mesh, const glm::mat4& p_transform)
+        {
+            m_renderer.draw_mesh(p_mesh, p_transform);
+        }
+
+        static void set_camera(const glm::mat4& p_view_projection)
+        {
+            m_renderer.set_camera(p_view_projection);
+        }
+
+        static void capture_frame(std::function<void(const vi::ImageData&)> p_callback)
+        {
+            m_renderer.capture_frame(std::move(p_callback));
+        }
+
+        static vi::TextureHandle load_texture(const std::filesystem::path& p_path)
+        {
+            return m_renderer.load_texture(p_path);
+        }
+
+        static uint32_t get_texture_index(const vi::TextureHandle p_texture)
+        {
+            return m_renderer.get_texture_index(p_texture);
+        }
+
+        static bool is_texture_ready(const vi::TextureHandle p_texture)
+        {
+            return m_renderer.is_texture_ready(p_texture);
+        }
+
     private:
         inline static std::shared_ptr<vi::Context> m_context{};
         inline static vulkan::Renderer m_renderer;
@@ -39,9 +103,9 @@ namespace
 
 namespace vi
 {
-    void Renderer::init(const std::string_view p_app_name, const std::shared_ptr<Window>& p_window)
+    void Renderer::init(const std::string_view p_app_name, const std::shared_ptr<Window>& p_window, const RendererProps& p_props)
     {
-        InternalRenderer::init(p_app_name, p_window);
+        InternalRenderer::init(p_app_name, p_window, p_props);
     }
 
     void Renderer::shutdown()
@@ -58,4 +122,73 @@ namespace vi
     {
         InternalRenderer::end_frame();
     }
+
+    void Renderer::on_resize(const uint32_t p_width, const uint32_t p_height)
+    {
+        InternalRenderer::on_resize(p_width, p_height);
+    }
+
+    void Renderer::set_present_mode(const PresentMode p_mode)
+    {
+        InternalRenderer::set_present_mode(p_mode);
+    }
+
+    PresentMode Renderer::get_present_mode() const
+    {
+        return InternalRenderer::get_present_mode();
+    }
+
+    const std::vector<GpuTiming>& Renderer::get_gpu_timings() const
+    {
+        return InternalRenderer::get_gpu_timings();
+    }
+
+    float Renderer::get_render_scale() const
+    {
+        return InternalRenderer::get_render_scale();
+    }
+
+    MeshHandle Renderer::upload_mesh(const std::span<const Vertex> p_vertices, const std::span<const uint32_t> p_indices, const std::span<const MeshLod> p_lods)
+    {
+        return InternalRenderer::upload_mesh(p_vertices, p_indices, p_lods);
+    }
+
+    void Renderer::draw_mesh(const MeshHandle p_mesh, const glm::mat4& p_transform)
+    {
+        InternalRenderer::draw_mesh(p_mesh, p_transform);
+    }
+
+    void Renderer::set_camera(const glm::mat4& p_view_projection)
+    {
+        InternalRenderer::set_camera(p_view_projection);
+    }
+
+    void Renderer::capture_frame(std::function<void(const ImageData&)> p_callback)
+    {
+        InternalRenderer::capture_frame(std::move(p_callback));
+    }
+
+    void Renderer::capture_frame(const std::filesystem::path& p_path)
+    {
+        InternalRenderer::capture_frame([p_path](const ImageData& p_image)
+        {
+            write_image(p_path, p_image);
+            VI_CORE_INFO("Frame captured to {}", p_path.string());
+        });
+    }
+
+    TextureHandle Renderer::load_texture(const std::filesystem::path& p_path)
+    {
+        return InternalRenderer::load_texture(p_path);
+    }
+
+    uint32_t Renderer::get_texture_index(const TextureHandle p_texture) const
+    {
+        return InternalRenderer::get_texture_index(p_texture);
+    }
+
+    bool Renderer::is_texture_ready(const TextureHandle p_texture) const
+    {
+        return InternalRenderer::is_texture_ready(p_texture);
+    }
 }
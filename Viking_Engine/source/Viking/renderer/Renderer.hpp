@@ -0,0 +1,87 @@
+#ifndef RENDERER_HPP
+#define RENDERER_HPP
+
+#include "Viking/core/Window.hpp"
+#include "Viking/renderer/ImageFile.hpp"
+#include "Viking/renderer/Mesh.hpp"
+#include "Viking/renderer/Texture.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace vi
+{
+    struct RendererProps {
+        //Number of frames the CPU may record ahead of the GPU, between 1 and 4
+        uint32_t FramesInFlight{ 2 };
+        //Worker threads recording command buffers next to the main thread, 0 uses every spare hardware thread
+        uint32_t RecordingThreads{ 0 };
+        //GPU time per frame in milliseconds the render resolution adapts to, 0 always renders at window resolution
+        float TargetGpuFrameTime{ 0.0f };
+        //Lowest fraction of the window resolution, per axis, the dynamic resolution may go down to
+        float MinRenderScale{ 0.5f };
+        //Screen space error in pixels a mesh LOD may show, 0 always draws the full meshes
+        float LodThreshold{ 1.0f };
+
+        explicit RendererProps(const uint32_t p_frames_in_flight = 2, const uint32_t p_recording_threads = 0): FramesInFlight{ p_frames_in_flight }, RecordingThreads{ p_recording_threads } {}
+    };
+
+    //GPU time spent in one profiled scope, nested scopes have a greater depth
+    struct GpuTiming {
+        std::string Name{};
+        double Milliseconds{};
+        uint32_t Depth{};
+    };
+
+    class Renderer
+    {
+    public:
+        void init(std::string_view p_app_name, const std::shared_ptr<Window>& p_window, const RendererProps& p_props = RendererProps());
+        void shutdown();
+
+        void begin_frame();
+        void end_frame();
+
+        void on_resize(uint32_t p_width, uint32_t p_height);
+
+        //Switches presentation at runtime, the swapchain is rebuilt at the start of the next frame
+        void set_present_mode(PresentMode p_mode);
+        //Mode actually in use after falling back to what the surface supports
+        [[nodiscard]] PresentMode get_present_mode() const;
+
+        //Timings of the latest frame the GPU has finished, empty until one is available
+        [[nodiscard]] const std::vector<GpuTiming>& get_gpu_timings() const;
+        //Fraction of the window resolution, per axis, frames are currently rendered at
+        [[nodiscard]] float get_render_scale() const;
+
+        //Copies the mesh into GPU memory, it can be drawn from the next frame on. Safe to call from any thread.
+        //Each frame draws the coarsest of p_lods whose error stays under RendererProps::LodThreshold, no LODs draws every index
+        [[nodiscard]] MeshHandle upload_mesh(std::span<const Vertex> p_vertices, std::span<const uint32_t> p_indices, std::span<const MeshLod> p_lods = {});
+        //Draws the mesh once in the next frame
+        void draw_mesh(MeshHandle p_mesh, const glm::mat4& p_transform);
+        //Projection has to map depth reversed, near to 1 and far to 0
+        void set_camera(const glm::mat4& p_view_projection);
+
+        //Copies the draw image at the end of the next rendered frame. The callback runs on a worker thread a few frames later,
+        //once the GPU has finished that frame, the render loop never waits for it
+        void capture_frame(std::function<void(const ImageData&)> p_callback);
+        //Same, writing the capture to a PNG or PPM file picked by the extension
+        void capture_frame(const std::filesystem::path& p_path);
+
+        //Starts loading an image file in the background and returns at once. Safe to call from any thread
+        [[nodiscard]] TextureHandle load_texture(const std::filesystem::path& p_path);
+        //Index of the texture in the sampled images of the bindless heap, a placeholder's until it is ready
+        [[nodiscard]] uint32_t get_texture_index(TextureHandle p_texture) const;
+        [[nodiscard]] bool is_texture_ready(TextureHandle p_texture) const;
+    };
+}
+
+#endif
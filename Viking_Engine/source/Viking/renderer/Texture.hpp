@@ -0,0 +1,17 @@
+#ifndef TEXTURE_HPP
+#define TEXTURE_HPP
+
+#include <cstdint>
+#include <limits>
+
+namespace vi
+{
+    //Texture owned by the renderer, usable right after the load was requested
+    struct TextureHandle {
+        uint32_t Id{ std::numeric_limits<uint32_t>::max() };
+
+        [[nodiscard]] bool is_valid() const { return Id != std::numeric_limits<uint32_t>::max(); }
+    };
+}
+
+#endif